@@ -0,0 +1,81 @@
+#ifndef ADMIT_H
+#define ADMIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Connection admission by air time. Each link commits the share of air
+ * time the controller has to schedule for it: one connection event per
+ * interval, as many PDU exchanges per event as its estimated rate needs
+ * and at least one. A new link is admitted only if the committed total
+ * stays within the budget, so links already up keep their bandwidth.
+ */
+
+enum admit_phy {
+    ADMIT_PHY_1M,
+    ADMIT_PHY_2M,
+    ADMIT_PHY_CODED_S2,
+    ADMIT_PHY_CODED_S8,
+};
+
+enum admit_verdict {
+    ADMIT_ACCEPT,
+    /* Admitted at a longer interval, taking only spare air time. */
+    ADMIT_DOWNGRADE,
+    ADMIT_REJECT,
+};
+
+struct admit_link {
+    bool active;
+    uint8_t phy;
+    /* Connection interval in units of 1.25 ms. */
+    uint16_t interval;
+    /* LL payload bytes per data PDU. */
+    uint16_t pdu_len;
+    /* Estimated bytes per second. */
+    uint32_t rate;
+};
+
+struct admit_policy {
+    /* Air time links may commit, in parts per million. */
+    uint32_t budget_ppm;
+    /* Bytes per second assumed for a link not measured yet. */
+    uint32_t new_rate;
+    /* Headroom on top of a link's estimated rate. */
+    uint8_t margin_pct;
+    /* Interval multiplier for a downgraded link. */
+    uint8_t downgrade;
+};
+
+/* Air time of one data PDU with len payload bytes. */
+uint32_t admit_pdu_us(enum admit_phy phy, uint16_t len);
+
+/* A full PDU and its empty acknowledgement, with both inter-frame gaps. */
+uint32_t admit_exchange_us(enum admit_phy phy, uint16_t len);
+
+/* Start a link at the policy's assumed rate. */
+void admit_link_init(struct admit_link *link, const struct admit_policy *policy,
+                     enum admit_phy phy, uint16_t interval, uint16_t pdu_len);
+
+/* Fold bytes received over ms into the link's rate estimate. */
+void admit_observe(struct admit_link *link, uint32_t bytes, uint32_t ms);
+
+/* Air time the link commits, in parts per million. */
+uint32_t admit_link_ppm(const struct admit_link *link, const struct admit_policy *policy);
+
+/* Air time committed by the active links. */
+uint32_t admit_committed_ppm(const struct admit_link *links, size_t n,
+                             const struct admit_policy *policy);
+
+/*
+ * Decide on cand against the active links. On ADMIT_DOWNGRADE, cand is
+ * changed to the longer interval it may connect with.
+ */
+enum admit_verdict admit_check(const struct admit_link *links, size_t n,
+                               struct admit_link *cand, const struct admit_policy *policy);
+
+const char *admit_verdict_str(enum admit_verdict verdict);
+
+#endif /* ADMIT_H */
@@ -0,0 +1,58 @@
+#ifndef AGG_H
+#define AGG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+
+/*
+ * Samples are little-endian int16_t. Every mode emits its outputs once
+ * per window, also as little-endian int16_t. At most one output sample
+ * is written per input sample consumed, so a stage never grows a packet
+ * and can run in place; multi-output modes may carry the tail of a
+ * window's outputs into the next call.
+ */
+enum agg_mode {
+    AGG_NONE,
+    AGG_DECIMATE,   /* first sample of each window */
+    AGG_MIN,
+    AGG_MAX,
+    AGG_MEAN,
+    AGG_MIN_MAX_MEAN, /* min, max, mean per window */
+};
+
+struct agg_stage {
+    enum agg_mode mode;
+    uint16_t window;
+    uint16_t count;
+    int16_t first;
+    int16_t min;
+    int16_t max;
+    int32_t sum;
+    int16_t pend[3];
+    uint8_t pend_pos;
+    uint8_t pend_len;
+};
+
+/* window must be at least the number of outputs the mode emits. */
+int agg_init(struct agg_stage *st, enum agg_mode mode, uint16_t window);
+
+/*
+ * Aggregate len bytes of samples from in into out, which may alias in.
+ * Partial windows carry over to the next call. Returns bytes written.
+ */
+size_t agg_process(struct agg_stage *st, const uint8_t *in, size_t len,
+                   uint8_t *out);
+
+int agg_channel_set(uint8_t chan, enum agg_mode mode, uint16_t window);
+
+/*
+ * Set channels from a FTAB_AGG_RULES table of len bytes (ftab.h).
+ * Returns the number of rules, or the error of the first one rejected.
+ */
+int agg_load_rules(const uint8_t *tab, size_t len);
+
+/* Aggregate the samples in buf in place with the stage of chan. */
+void agg_channel_apply(uint8_t chan, struct net_buf *buf);
+
+#endif /* AGG_H */
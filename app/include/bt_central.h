@@ -0,0 +1,112 @@
+#ifndef BT_CENTRAL_H
+#define BT_CENTRAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+
+struct bt_central_link_stats {
+    bool up;
+    /* From first advertisement seen to L2CAP channel connected. */
+    uint32_t setup_ms;
+    /* Connection interval asked for, in units of 1.25 ms. */
+    uint16_t interval;
+    /* PHY the link receives on, as enum admit_phy. */
+    uint8_t phy;
+    uint32_t rx_bytes;
+    /* Frames received over the CoC and the cycles spent handing them on. */
+    uint32_t rx_frames;
+    uint32_t rx_cycles;
+    /* The same for frames sent to the peer with bt_central_send(). */
+    uint32_t tx_bytes;
+    uint32_t tx_frames;
+    uint32_t tx_cycles;
+    /* Negotiated with the peer's hello; see caps.h. */
+    uint16_t mtu;
+    uint32_t features;
+    /* Carried over the Nordic UART Service rather than an L2CAP CoC. */
+    bool nus;
+};
+
+/* Decisions of CONFIG_APP_ADMIT so far; all zero without it. */
+struct bt_central_admit_stats {
+    uint32_t accepted;
+    uint32_t downgraded;
+    uint32_t rejected;
+    /* Air time the links up commit now, in parts per million. */
+    uint32_t committed_ppm;
+};
+
+/*
+ * Takes ownership of buf, a packet pool buffer holding one frame. Returns
+ * -EINPROGRESS to keep the link's credit for it until buf is handed to
+ * bt_central_recv_done().
+ */
+typedef int (*bt_central_sink_t)(struct net_buf *buf);
+
+/* Called each time a frame given to bt_central_send() has gone out. */
+typedef void (*bt_central_sent_t)(void);
+
+/*
+ * Hand the frames peers send to sink, in the buffers the Bluetooth stack
+ * received them into. Their channel is set to the index of the link they
+ * came in on, except in a relay, which passes it on as the peer set it.
+ * Without a sink they are counted and dropped. Set it before
+ * bt_central_start().
+ */
+void bt_central_set_sink(bt_central_sink_t sink);
+
+/*
+ * Have sent called once the stack is done with a frame sent to a peer,
+ * so whoever waits for a pool buffer can try again.
+ */
+void bt_central_set_sent(bt_central_sent_t sent);
+
+/*
+ * Say whether the host expands dictionary-compressed frames itself. If it
+ * does, they reach it as they came while pool pressure has compression
+ * off, saving the buffer to expand them into.
+ */
+void bt_central_set_host_dict(bool expands);
+
+/* Enable Bluetooth and start connecting to peers. */
+int bt_central_start(void);
+
+/*
+ * Send buf, a packet pool buffer holding one frame, to the peer on link
+ * idx. The L2CAP and ACL headers go in the buffer's headroom, so it is
+ * not copied. Takes ownership of buf. Returns -ENOTCONN if the link is
+ * not up, or -EMSGSIZE if the frame is larger than the peer accepts.
+ */
+int bt_central_send(size_t idx, struct net_buf *buf);
+
+/*
+ * Credit window negotiated with the peer on link idx, or
+ * CONFIG_APP_CREDITS while there is none. Frames in flight to the link
+ * are kept within it.
+ */
+uint8_t bt_central_link_credits(size_t idx);
+
+/*
+ * Give back the credit of a frame the sink kept from link idx and drop
+ * the reference the stack left with it. buf itself stays the caller's.
+ * Call it before sending buf on.
+ */
+void bt_central_recv_done(size_t idx, struct net_buf *buf);
+
+/* Whether link idx has a full credit window of frames in flight. */
+bool bt_central_link_busy(size_t idx);
+
+/* Number of links with a connected L2CAP channel. */
+size_t bt_central_link_count(void);
+
+/*
+ * Copy the stats of link idx and clear its counters. Returns false if
+ * idx is out of range.
+ */
+bool bt_central_link_stats(size_t idx, struct bt_central_link_stats *stats);
+
+void bt_central_admit_stats(struct bt_central_admit_stats *stats);
+
+#endif /* BT_CENTRAL_H */
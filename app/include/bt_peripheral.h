@@ -0,0 +1,46 @@
+#ifndef BT_PERIPHERAL_H
+#define BT_PERIPHERAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+
+/*
+ * Takes ownership of buf, a packet pool buffer holding one frame from the
+ * upstream node. Returns -EINPROGRESS to keep the link's credit for it
+ * until buf is handed to bt_peripheral_recv_done().
+ */
+typedef int (*bt_peripheral_sink_t)(struct net_buf *buf);
+
+/* Called each time a frame given to bt_peripheral_send() has gone out. */
+typedef void (*bt_peripheral_sent_t)(void);
+
+/*
+ * Hand the frames the upstream node sends to sink, in the buffers the
+ * Bluetooth stack received them into. Without a sink they are dropped.
+ * Set it before bt_peripheral_start().
+ */
+void bt_peripheral_set_sink(bt_peripheral_sink_t sink);
+
+void bt_peripheral_set_sent(bt_peripheral_sent_t sent);
+
+/*
+ * Advertise as CONFIG_BT_DEVICE_NAME and accept one upstream node's L2CAP
+ * CoC on CONFIG_APP_BT_L2CAP_PSM. Call once Bluetooth is enabled.
+ */
+int bt_peripheral_start(void);
+
+/*
+ * Send buf, a packet pool buffer holding one frame, to the upstream node.
+ * Takes ownership of buf. Returns -ENOTCONN if there is no channel, or
+ * -EMSGSIZE if the frame is larger than the node accepts.
+ */
+int bt_peripheral_send(struct net_buf *buf);
+
+/* Whether a full credit window of frames is in flight upstream. */
+bool bt_peripheral_busy(void);
+
+/* As bt_central_recv_done(), for a frame the sink kept. */
+void bt_peripheral_recv_done(struct net_buf *buf);
+
+#endif /* BT_PERIPHERAL_H */
@@ -0,0 +1,29 @@
+#ifndef BT_RELAY_H
+#define BT_RELAY_H
+
+#include <stdint.h>
+
+struct bt_relay_stats {
+    /* Frames and bytes sent on toward the peer, and frames dropped. */
+    uint32_t down_frames;
+    uint32_t down_bytes;
+    uint32_t down_drops;
+    /* The same toward the bridge at the end of the chain. */
+    uint32_t up_frames;
+    uint32_t up_bytes;
+    uint32_t up_drops;
+};
+
+/*
+ * Enable Bluetooth and relay frames between the upstream node, which
+ * connects to us as a peripheral (bt_peripheral.h), and the downstream
+ * node we connect to as a central (bt_central.h). A frame keeps its
+ * link-level credit until it is sent on, so a slow hop holds back the
+ * one before it instead of filling the relay's backlog.
+ */
+int bt_relay_start(void);
+
+/* Copy the relay's counters, which run from bt_relay_start(). */
+void bt_relay_stats(struct bt_relay_stats *stats);
+
+#endif /* BT_RELAY_H */
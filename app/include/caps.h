@@ -0,0 +1,85 @@
+#ifndef CAPS_H
+#define CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/sys/util.h>
+
+/*
+ * Capability exchange. Each side sends one CAPS_OP_HELLO control message
+ * when a link comes up:
+ *
+ *   CAPS_OP_HELLO | VERSION u32 | MTU u16 | FEATURES u32 | BATCH u16 |
+ *   CREDITS u8 | DICT u16
+ *
+ * Values are little endian. Unknown tags are skipped so newer firmware can
+ * add fields, and missing ones take the most conservative value. Both
+ * sides then run caps_select() on the two hellos, which is symmetric, so
+ * they agree on the session settings without another round trip.
+ */
+#define CAPS_OP_HELLO 0x40
+
+enum caps_tag {
+    CAPS_TAG_VERSION = 1,
+    CAPS_TAG_MTU = 2,
+    CAPS_TAG_FEATURES = 3,
+    CAPS_TAG_BATCH = 4,
+    CAPS_TAG_CREDITS = 5,
+    CAPS_TAG_DICT = 6,
+};
+
+/* EATT and RELIABLE are reserved: no firmware implements them yet. */
+enum caps_feature {
+    CAPS_F_L2CAP_COC = BIT(0),
+    CAPS_F_COMPRESSION = BIT(1),
+    CAPS_F_EATT = BIT(2),
+    CAPS_F_RELIABLE = BIT(3),
+};
+
+/* Smallest frame every side must accept: the BLE minimum ATT MTU. */
+#define CAPS_MTU_MIN 23U
+
+#define CAPS_HELLO_SIZE (1U + (2U + 4U) + (2U + 2U) + (2U + 4U) + (2U + 2U) + (2U + 1U) + \
+                         (2U + 2U))
+
+struct caps {
+    /* APPVERSION of the sender, 0xMMmmpp00. Majors must match. */
+    uint32_t version;
+    /* Largest frame, header included, the sender accepts. */
+    uint16_t mtu;
+    uint32_t features;
+    /* Most frames the sender accepts in one transfer. */
+    uint16_t batch;
+    /* Credit window the sender grants. */
+    uint8_t credits;
+    /* Id of the compression dictionary, 0 for none. */
+    uint16_t dict;
+};
+
+/* Fill caps with this firmware's version and the conservative defaults. */
+void caps_init(struct caps *caps);
+
+/* Write a hello for caps at dst. Returns bytes written, or 0 if cap is short. */
+size_t caps_put_hello(uint8_t *dst, size_t cap, const struct caps *caps);
+
+/*
+ * Append a FRAME_CTRL frame on chan carrying a hello for caps. Returns 0
+ * or -ENOMEM if buf lacks the tailroom.
+ */
+int caps_add_hello(struct net_buf *buf, uint8_t chan, const struct caps *caps);
+
+/*
+ * Parse a hello payload into caps. Returns 0, -EBADMSG if it is malformed
+ * or has no version, or -ENOMSG if the op is not CAPS_OP_HELLO.
+ */
+int caps_parse_hello(const uint8_t *payload, size_t len, struct caps *caps);
+
+/*
+ * Pick the fastest settings both a and b support. Compression needs the
+ * same dictionary on both sides. Returns 0, or -EPROTO if the protocol
+ * majors differ.
+ */
+int caps_select(const struct caps *a, const struct caps *b, struct caps *out);
+
+#endif /* CAPS_H */
@@ -0,0 +1,44 @@
+#ifndef CREDIT_H
+#define CREDIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/atomic.h>
+
+/* Sender side: one credit is spent per data frame. */
+struct credit_tx {
+    atomic_t avail;
+};
+
+/* Receiver side: consumed frames are returned to the sender in batches. */
+struct credit_rx {
+    uint8_t window;
+    /* Credits the sender holds. */
+    uint8_t out;
+};
+
+void credit_tx_init(struct credit_tx *tx);
+
+bool credit_tx_take(struct credit_tx *tx);
+
+void credit_tx_grant(struct credit_tx *tx, uint8_t count);
+
+/* The sender is taken to hold the whole window, granted separately. */
+void credit_rx_init(struct credit_rx *rx, uint8_t window);
+
+/*
+ * Change the window. A smaller one holds credits back until the sender
+ * has spent down to it.
+ */
+void credit_rx_set_window(struct credit_rx *rx, uint8_t window);
+
+/*
+ * Account for one consumed frame. Returns the number of credits to send
+ * back now; credits are batched until half the window is outstanding.
+ */
+uint8_t credit_rx_consumed(struct credit_rx *rx);
+
+/* Returns the credits to send back now whatever the batch, topping the sender up. */
+uint8_t credit_rx_flush(struct credit_rx *rx);
+
+#endif /* CREDIT_H */
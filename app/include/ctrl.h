@@ -0,0 +1,32 @@
+#ifndef CTRL_H
+#define CTRL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Payload of a FRAME_CTRL frame:
+ *
+ *   op | tag | len | value[len] | tag | len | value[len] ...
+ */
+struct ctrl_tlv {
+    uint8_t tag;
+    uint8_t len;
+    const uint8_t *value;
+};
+
+/* Return 0 to continue parsing, anything else aborts with that value. */
+typedef int (*ctrl_tlv_cb_t)(void *user, const struct ctrl_tlv *tlv);
+
+/*
+ * Parse a control payload, calling cb for each TLV in order. Returns 0,
+ * -EBADMSG if the payload is truncated or the callback's error.
+ */
+int ctrl_parse(const uint8_t *payload, size_t len, uint8_t *op,
+               ctrl_tlv_cb_t cb, void *user);
+
+/* Append a TLV at dst. Returns bytes written, or 0 if it does not fit. */
+size_t ctrl_put_tlv(uint8_t *dst, size_t cap, uint8_t tag, const void *value,
+                    uint8_t len);
+
+#endif /* CTRL_H */
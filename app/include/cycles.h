@@ -0,0 +1,38 @@
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#if defined(CONFIG_TIMING_FUNCTIONS)
+#include <zephyr/timing/timing.h>
+#endif
+
+/*
+ * Cycle count for timing short stretches of code. native_sim and bsim
+ * time is simulated, so there it reads the host's TSC. With
+ * CONFIG_TIMING_FUNCTIONS it is the arch timing counter, the DWT cycle
+ * counter on Cortex-M. Otherwise it is the kernel cycle counter, which
+ * on nRF is the 32768 Hz RTC and too coarse for anything but long runs.
+ * Outside x86 the count is 32 bits wide; take differences in uint32_t.
+ */
+static inline uint64_t cycles_now(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#elif defined(CONFIG_TIMING_FUNCTIONS)
+    return timing_counter_get();
+#else
+    return k_cycle_get_32();
+#endif
+}
+
+/* Start the counter cycles_now() reads. Call before the first measurement. */
+static inline void cycles_init(void)
+{
+#if !defined(__i386__) && !defined(__x86_64__) && defined(CONFIG_TIMING_FUNCTIONS)
+    timing_init();
+    timing_start();
+#endif
+}
+
+#endif /* CYCLES_H */
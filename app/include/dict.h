@@ -0,0 +1,89 @@
+#ifndef DICT_H
+#define DICT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Shared-dictionary compression for small frames. Both sides hold the
+ * same dictionary, trained offline from captured traffic by
+ * scripts/dict-train.py, so even a 20 byte message can refer back to
+ * bytes it never carried. The dictionary and its match index are const
+ * and are read straight from flash, either built in or from a flash
+ * table (ftab.h).
+ *
+ * A compressed payload is a sequence of tokens:
+ *
+ *   0x00..0x7f  literal run: (t + 1) bytes follow
+ *   0x80..0xff  match: (t & 0x7f) + DICT_MATCH_MIN bytes copied from
+ *               dist (le16) bytes back in dictionary || output
+ */
+#define DICT_MATCH_MIN  4U
+#define DICT_MATCH_MAX  (0x7FU + DICT_MATCH_MIN)
+#define DICT_LITERAL_MAX 0x80U
+#define DICT_HASH_SIZE  256U
+
+struct dict {
+    /* Exchanged in the hello; never 0, which means no dictionary. */
+    uint16_t id;
+    uint16_t size;
+    const uint8_t *data;
+    /* Per hash, the last position with that hash plus one, or 0. */
+    const uint16_t *head;
+    /* Per position, the previous position with the same hash plus one, or 0. */
+    const uint16_t *chain;
+};
+
+/* Generated into dict_data.c by scripts/dict-train.py. */
+extern const struct dict dict_builtin;
+
+/* The dictionary in use: dict_builtin unless dict_use() replaced it. */
+const struct dict *dict_active(void);
+
+/* Switch dictionaries. Only safe before any link has negotiated one. */
+void dict_use(const struct dict *dict);
+
+/*
+ * Point dict at a dictionary table of len bytes without copying it. The
+ * table, 2-byte aligned, holds what dict-train.py --table writes:
+ *
+ *   id u16 | size u16 | data[size] | pad to 2 | head u16[DICT_HASH_SIZE] |
+ *   chain u16[size]
+ *
+ * Returns 0, or -EBADMSG if the table is malformed.
+ */
+int dict_from_table(const uint8_t *tab, size_t len, struct dict *dict);
+
+/* Hash of the 3 bytes at p; dict-train.py uses the same one. */
+static inline uint8_t dict_hash(const uint8_t *p)
+{
+    return (uint8_t)((p[0] << 5) ^ (p[1] << 3) ^ p[2]);
+}
+
+/*
+ * Compress len bytes at src into dst. Returns bytes written, or 0 if the
+ * result would not be shorter than len or does not fit in cap, in which
+ * case the message should go out as it is.
+ */
+size_t dict_compress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+
+/*
+ * Expand a dict_compress() result. Returns bytes written, -EBADMSG if src
+ * is malformed or -ENOMEM if the result does not fit in cap.
+ */
+int dict_decompress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+
+/*
+ * Turn the FRAME_DATA frame of len bytes at frame into FRAME_DATA_DICT
+ * in place if its payload is at most CONFIG_APP_DICT_MAX_LEN bytes and
+ * compresses. Returns the frame length, which is len if it was left alone.
+ */
+size_t dict_pack_frame(uint8_t *frame, size_t len);
+
+/*
+ * Expand the FRAME_DATA_DICT frame of len bytes at frame into a FRAME_DATA
+ * frame at dst. Returns its length or a dict_decompress() error.
+ */
+int dict_unpack_frame(const uint8_t *frame, size_t len, uint8_t *dst, size_t cap);
+
+#endif /* DICT_H */
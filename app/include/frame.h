@@ -0,0 +1,58 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Frame layout on every link:
+ *
+ *   sync (0xA5) | chan | type | len (le16) | payload[len]
+ */
+#define FRAME_SYNC 0xA5
+#define FRAME_HDR_SIZE 5U
+
+enum frame_type {
+    FRAME_DATA,
+    FRAME_CREDIT, /* payload: number of credits granted for chan (u8) */
+    FRAME_CTRL,
+    FRAME_DATA_DICT, /* FRAME_DATA payload compressed as in dict.h */
+    FRAME_TYPE_COUNT,
+};
+
+struct frame_hdr {
+    uint8_t chan;
+    uint8_t type;
+    uint16_t len;
+};
+
+typedef void (*frame_cb_t)(void *user, const struct frame_hdr *hdr,
+                           const uint8_t *payload);
+
+/* Reassembles frames from a byte stream such as USB bulk transfers. */
+struct frame_decoder {
+    frame_cb_t cb;
+    void *user;
+    size_t fill;
+    uint32_t dropped;
+    uint8_t buf[FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD];
+};
+
+void frame_put_hdr(uint8_t *dst, const struct frame_hdr *hdr);
+
+/*
+ * Parse the header at src. Returns 0, -EAGAIN if len is too short or
+ * -EBADMSG if the header is not valid.
+ */
+int frame_get_hdr(const uint8_t *src, size_t len, struct frame_hdr *hdr);
+
+void frame_decoder_init(struct frame_decoder *dec, frame_cb_t cb, void *user);
+
+/*
+ * Feed len bytes to the decoder; cb is called for every complete frame.
+ * Garbage is skipped byte by byte until the next valid header, so the
+ * work done is linear in the input.
+ */
+void frame_decode(struct frame_decoder *dec, const uint8_t *data, size_t len);
+
+#endif /* FRAME_H */
@@ -0,0 +1,109 @@
+#ifndef FTAB_H
+#define FTAB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Flash tables: read-mostly configuration kept in one of two flash slots
+ * in a layout the firmware uses where it lies, through the memory-mapped
+ * flash, instead of copying it into RAM at boot. All values are little
+ * endian:
+ *
+ *   magic u32 | seq u32 | len u32 | crc u32
+ *   count u16 | reserved u16
+ *   count * (id u16 | reserved u16 | offset u32 | len u32)
+ *   tables, each at a multiple of FTAB_ALIGN from the slot start
+ *
+ * len counts the whole image, header included. crc is the CRC-32 (IEEE)
+ * of the first 12 header bytes followed by bytes 16..len, so the header
+ * can be written last: a slot only becomes valid once its update is
+ * complete. Of two valid slots the one with the later seq is in use.
+ */
+#define FTAB_MAGIC      0x42415446U /* "FTAB" */
+#define FTAB_HDR_SIZE   16U
+#define FTAB_DIR_SIZE   4U
+#define FTAB_ENTRY_SIZE 12U
+#define FTAB_ALIGN      4U
+
+enum ftab_id {
+    /* Aggregation per channel: chan u8 | agg_mode u8 | window u16, each. */
+    FTAB_AGG_RULES = 1,
+    /* Peers the central connects to: addr type u8 | addr[6] | flags u8. */
+    FTAB_PEERS = 2,
+    /* A shared dictionary, see dict_from_table(). */
+    FTAB_DICT = 3,
+};
+
+#define FTAB_RULE_SIZE 4U
+#define FTAB_PEER_SIZE 8U
+
+struct ftab_hdr {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t len;
+    uint32_t crc;
+};
+
+void ftab_get_hdr(const uint8_t *src, struct ftab_hdr *hdr);
+void ftab_put_hdr(uint8_t *dst, const struct ftab_hdr *hdr);
+
+/* The crc an image with this header and body (bytes 16..len) must carry. */
+uint32_t ftab_crc(const struct ftab_hdr *hdr, const uint8_t *body);
+
+/*
+ * Check the image in a slot of size bytes. Returns 0 and fills hdr if it
+ * is complete and every table lies inside it, -ENOENT if the slot holds
+ * no image and -EBADMSG if it holds a broken one.
+ */
+int ftab_check(const uint8_t *slot, size_t size, struct ftab_hdr *hdr);
+
+/*
+ * Pick the slot in use from two of size bytes each. Returns 0 or 1, or
+ * -ENOENT if neither holds a valid image.
+ */
+int ftab_pick(const uint8_t *a, const uint8_t *b, size_t size);
+
+/*
+ * Table id of a checked image. Returns a pointer into the image and sets
+ * len, or NULL if there is no such table.
+ */
+const uint8_t *ftab_find(const uint8_t *img, uint16_t id, size_t *len);
+
+/* Whether a FTAB_PEERS table of len bytes lists this address. */
+bool ftab_peer_listed(const uint8_t *tab, size_t len, uint8_t type,
+                      const uint8_t addr[6]);
+
+/*
+ * The table id of the image picked at boot, NULL if there is none. The
+ * image stays put until reboot, whatever updates arrive.
+ */
+const uint8_t *ftab_get(uint16_t id, size_t *len);
+
+/*
+ * Host updates, FRAME_CTRL on CONFIG_APP_STATS_CHAN, each answered with a
+ * STATS_REC_FTAB record: op u8 | status i8 | seq u32. The image goes to
+ * the slot not in use and takes over on the next boot.
+ *
+ *   FTAB_OP_BEGIN   LEN u32: erase the free slot for an image of LEN bytes
+ *   FTAB_OP_WRITE   OFFSET u32 | DATA: write the next chunk of the image
+ *   FTAB_OP_COMMIT  check the image and write its header
+ *
+ * Chunks come in order and, but for the last, in multiples of
+ * FTAB_ALIGN bytes.
+ */
+#define FTAB_OP_BEGIN  0x50
+#define FTAB_OP_WRITE  0x51
+#define FTAB_OP_COMMIT 0x52
+
+enum ftab_tag {
+    FTAB_TAG_LEN = 1,
+    FTAB_TAG_OFFSET = 2,
+    FTAB_TAG_DATA = 3,
+};
+
+/* Handle one of the ops above. */
+int ftab_handle_ctrl(const uint8_t *payload, size_t len);
+
+#endif /* FTAB_H */
@@ -0,0 +1,100 @@
+#ifndef NUS_H
+#define NUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Nordic UART Service compatibility. NUS carries a plain byte stream, so
+ * frames are written back to back and may be split across packets; the
+ * receiver runs the usual frame decoder over the stream.
+ */
+#define NUS_SVC_UUID_VAL                                                     \
+    BT_UUID_128_ENCODE(0x6e400001, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+/* Written by the central. */
+#define NUS_RX_UUID_VAL                                                      \
+    BT_UUID_128_ENCODE(0x6e400002, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+/* Notified by the peripheral. */
+#define NUS_TX_UUID_VAL                                                      \
+    BT_UUID_128_ENCODE(0x6e400003, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+
+/* ATT payload of the largest ATT MTU that fits one 251 byte LL PDU. */
+#define NUS_PACKET_MAX 244U
+
+/* Sends one packet. Returns 0, or an error to keep the data and retry. */
+typedef int (*nus_flush_t)(void *user, const uint8_t *data, uint16_t len);
+
+/*
+ * Packs a stream into packets of up to cap bytes so that small frames
+ * share a notification or write instead of costing one each.
+ */
+struct nus_packer {
+    nus_flush_t flush;
+    void *user;
+    uint16_t cap;
+    uint16_t len;
+    uint8_t buf[NUS_PACKET_MAX];
+};
+
+void nus_packer_init(struct nus_packer *p, nus_flush_t flush, void *user);
+
+/* Set the packet size from the negotiated ATT MTU. */
+void nus_packer_set_mtu(struct nus_packer *p, uint16_t att_mtu);
+
+/*
+ * Queue len bytes, sending every packet that fills up. Returns the number
+ * of bytes taken, which is less than len if a flush failed.
+ */
+size_t nus_packer_write(struct nus_packer *p, const uint8_t *data, size_t len);
+
+/* Send a partly filled packet. Returns 0 or the flush error. */
+int nus_packer_flush(struct nus_packer *p);
+
+/* Bytes of whole frames a nus_tx holds while the stack is busy. */
+#define NUS_TX_BACKLOG (2U * NUS_PACKET_MAX)
+
+/*
+ * A packer fed with whole frames. A frame is taken only if all of it
+ * fits, so a full stack never leaves part of one in the stream; what the
+ * packer cannot send yet waits in the backlog for nus_tx_pump().
+ */
+struct nus_tx {
+    struct nus_packer packer;
+    uint16_t len;
+    uint8_t backlog[NUS_TX_BACKLOG];
+};
+
+void nus_tx_init(struct nus_tx *tx, nus_flush_t flush, void *user);
+
+/* Queue a frame and send what the stack takes. Returns 0 or -ENOBUFS. */
+int nus_tx_frame(struct nus_tx *tx, const uint8_t *frame, size_t len);
+
+/* Send what the stack takes. Returns true while data is left. */
+bool nus_tx_pump(struct nus_tx *tx);
+
+struct bt_conn;
+
+/* Called from the notification callback with the controller's buffer. */
+typedef void (*nus_client_recv_t)(void *user, const uint8_t *data, uint16_t len);
+
+/* Called once the peer's service is found and notifications are on. */
+typedef void (*nus_client_ready_t)(void *user, int err);
+
+/*
+ * Discover the peer's NUS after exchanging the ATT MTU and subscribe to
+ * its TX characteristic. Only one discovery may run per slot.
+ */
+int nus_client_start(size_t slot, struct bt_conn *conn, nus_client_ready_t ready,
+                     nus_client_recv_t recv, void *user);
+
+/* Forget slot's link; the stack drops the subscription on disconnect. */
+void nus_client_stop(size_t slot);
+
+/* Write to the peer's RX characteristic without response. */
+int nus_client_send(size_t slot, const uint8_t *data, uint16_t len);
+
+/* ATT MTU agreed for slot, or 23 before the exchange. */
+uint16_t nus_client_mtu(size_t slot);
+
+#endif /* NUS_H */
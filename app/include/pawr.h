@@ -0,0 +1,88 @@
+#ifndef PAWR_H
+#define PAWR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Periodic Advertising with Responses. Every periodic interval the bridge
+ * sends one subevent per group of nodes and each node answers in its own
+ * response slot, so no node needs a connection. Slot position n is
+ *
+ *   subevent = n % subevents, slot = n / subevents
+ *
+ * Nodes pick a free position themselves. Each subevent's data tells them
+ * which slots of that subevent were heard last interval:
+ *
+ *   seq (u8) | slots (u8) | heard bitmap (one bit per slot)
+ *
+ * and a node that is not heard twice in a row (a collision) picks a new
+ * random position. A response starts with the node's own ID:
+ *
+ *   id (u16) | uptime_ms (u32) | sample ...
+ *
+ * Responses are relayed to the host in STATS_REC_PAWR records, each
+ * holding as many as fit:
+ *
+ *   count (u8) | position (u16) | rssi (i8) | len (u8) | data[len] ...
+ */
+#define PAWR_RSP_HDR_SIZE 4U
+#define PAWR_SUB_HDR_SIZE 2U
+#define PAWR_NODE_HDR_SIZE 6U
+
+/* Misses in a row after which a node gives up its position. */
+#define PAWR_MISS_LIMIT 2U
+
+struct pawr_batch {
+    uint8_t count;
+    size_t len;
+    /* Uptime of the oldest response in the batch, for latency reports. */
+    int64_t first_ms;
+    uint8_t buf[CONFIG_APP_FRAME_MAX_PAYLOAD - 2U];
+};
+
+/* Slot position answering in slot of subevent. */
+static inline uint16_t pawr_position(uint8_t subevent, uint8_t slot, uint8_t subevents)
+{
+    return (uint16_t)(slot * subevents + subevent);
+}
+
+static inline uint8_t pawr_subevent(uint16_t pos, uint8_t subevents)
+{
+    return (uint8_t)(pos % subevents);
+}
+
+static inline uint8_t pawr_slot(uint16_t pos, uint8_t subevents)
+{
+    return (uint8_t)(pos / subevents);
+}
+
+/* Whether slot is set in the heard bitmap of a subevent's data. */
+static inline bool pawr_heard(const uint8_t *bits, size_t len, uint8_t slot)
+{
+    return (size_t)(slot / 8U) < len && (bits[slot / 8U] & (1U << (slot % 8U))) != 0;
+}
+
+void pawr_batch_init(struct pawr_batch *batch);
+
+/*
+ * Append one response. Returns 0, -ENOSPC if the batch must be sent first
+ * or -EMSGSIZE if the response could never fit.
+ */
+int pawr_batch_add(struct pawr_batch *batch, uint16_t pos, int8_t rssi,
+                   const uint8_t *data, uint8_t len, int64_t now_ms);
+
+/*
+ * Write the record body (count first) at dst and empty the batch.
+ * Returns bytes written, or 0 if the batch is empty or cap is short.
+ */
+size_t pawr_batch_take(struct pawr_batch *batch, uint8_t *dst, size_t cap);
+
+/*
+ * Enable Bluetooth if need be, start the periodic advertising train and
+ * relay responses to the host through the stats sink.
+ */
+int pawr_start(void);
+
+#endif /* PAWR_H */
@@ -0,0 +1,60 @@
+#ifndef PHY_SEL_H
+#define PHY_SEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "admit.h"
+
+/*
+ * Per-link choice between the 2M PHY and Coded PHY S=2 by expected
+ * goodput: what a PDU exchange carries, times the share of exchanges that
+ * get through, over how long the exchange takes. PERs come from a
+ * sensitivity model at the link's RSSI. If samples count loss, the PHY in
+ * use takes the measured PER instead, and the other PHY adds whatever
+ * loss the model does not explain (interference hits both). Switching
+ * needs the other PHY to win by a margin for several windows in a row,
+ * and a minimum time on the current one.
+ */
+
+struct phy_sel_policy {
+    /* How much more goodput the other PHY must promise, in percent. */
+    uint8_t hyst_pct;
+    /* Windows in a row it must do so. */
+    uint8_t confirm;
+    /* Time on a PHY before it may be left. */
+    uint32_t dwell_ms;
+};
+
+struct phy_sel_sample {
+    uint32_t ms;
+    /* PDUs received and lost in the window; both 0 if not known. */
+    uint32_t ok;
+    uint32_t lost;
+    bool rssi_valid;
+    int8_t rssi;
+};
+
+struct phy_sel {
+    uint8_t phy;
+    uint8_t votes;
+    bool rssi_valid;
+    bool per_valid;
+    /* Smoothed RSSI in dBm and PER of phy in per mille. */
+    int16_t rssi;
+    uint16_t per_pm;
+    uint32_t dwell_ms;
+};
+
+void phy_sel_init(struct phy_sel *sel, enum admit_phy phy);
+
+/* PER in per mille the sensitivity model expects at rssi dBm. */
+uint16_t phy_sel_model_per(enum admit_phy phy, int rssi);
+
+/* Goodput in kbit/s of back-to-back exchanges of pdu_len byte PDUs. */
+uint32_t phy_sel_goodput(enum admit_phy phy, uint16_t pdu_len, uint16_t per_pm);
+
+/* Fold in one window. Returns the PHY the link should use from now on. */
+enum admit_phy phy_sel_update(struct phy_sel *sel, const struct phy_sel_sample *sample,
+                              uint16_t pdu_len, const struct phy_sel_policy *policy);
+
+#endif /* PHY_SEL_H */
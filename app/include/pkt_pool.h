@@ -0,0 +1,18 @@
+#ifndef PKT_POOL_H
+#define PKT_POOL_H
+
+#include <stddef.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net_buf.h>
+
+/*
+ * Allocate a buffer from the shared packet pool. It has
+ * CONFIG_APP_PKT_HEADROOM bytes of headroom and CONFIG_APP_PKT_SIZE of
+ * tailroom, and may go to the USB and the Bluetooth stack as is.
+ */
+struct net_buf *pkt_alloc(k_timeout_t timeout);
+
+/* Number of buffers currently available in the pool. */
+size_t pkt_pool_free_count(void);
+
+#endif /* PKT_POOL_H */
@@ -0,0 +1,51 @@
+#ifndef PKT_TRACK_H
+#define PKT_TRACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+
+/*
+ * Debug aid for buffer leaks and hoarding (CONFIG_APP_PKT_TRACK): every
+ * packet pool buffer is tagged with the stage that holds it, when it was
+ * allocated and when that stage got it. Each stage tags a buffer as it
+ * takes it over; the pool tags allocation and release.
+ */
+enum pkt_owner {
+    PKT_OWNER_FREE,
+    PKT_OWNER_ALLOC,    /* allocated, not handed on yet */
+    PKT_OWNER_USB_OUT,  /* armed on the OUT endpoint */
+    PKT_OWNER_USB_RX,   /* received, queued for the pipeline */
+    PKT_OWNER_APP,      /* in the bridge pipeline */
+    PKT_OWNER_USB_IN,   /* queued on the IN endpoint */
+    PKT_OWNER_BT_RX,    /* an SDU being received on a link */
+    PKT_OWNER_BT_TX,    /* queued to a link */
+    PKT_OWNER_RELAY,    /* in a relay backlog */
+    PKT_OWNER_WORKER,   /* queued to a bridge worker */
+    PKT_OWNER_UART_RX,  /* received on the UART, queued for the pipeline */
+    PKT_OWNER_UART_TX,  /* queued or being sent on the UART */
+    PKT_OWNER_SPI_RX,   /* received on SPI, queued for the pipeline */
+    PKT_OWNER_SPI_TX,   /* waiting for room in an SPI transaction */
+    PKT_OWNER_COUNT,
+};
+
+struct pkt_track_info {
+    uint16_t id;
+    uint8_t owner;
+    /* Since the owner took the buffer, and since it was allocated. */
+    uint32_t held_ms;
+    uint32_t age_ms;
+};
+
+/* Record that owner now holds buf. */
+void pkt_track_set(struct net_buf *buf, enum pkt_owner owner);
+
+/*
+ * Fill out with up to cap outstanding buffers, grouped by owner and
+ * longest held first. Returns how many there are, which may exceed cap.
+ */
+size_t pkt_track_list(struct pkt_track_info *out, size_t cap);
+
+const char *pkt_owner_name(enum pkt_owner owner);
+
+#endif /* PKT_TRACK_H */
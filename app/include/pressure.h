@@ -0,0 +1,41 @@
+#ifndef PRESSURE_H
+#define PRESSURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum pressure_level {
+    PRESSURE_NORMAL,
+    PRESSURE_ELEVATED,
+    PRESSURE_HIGH,
+    PRESSURE_CRITICAL,
+};
+
+/* Settings that bridge stages read to adapt to the current level. */
+struct pressure_policy {
+    bool compression;
+    bool capture;
+    uint32_t coalesce_us;
+    uint8_t credits;
+};
+
+typedef void (*pressure_cb_t)(enum pressure_level from, enum pressure_level to,
+                              const struct pressure_policy *policy);
+
+/* Reset to PRESSURE_NORMAL. cb is called on every level change, from the
+ * context that changed the pool, and must not block. It is called without
+ * the controller's lock held, so it may take or free pool buffers.
+ */
+void pressure_init(pressure_cb_t cb);
+
+/* Feed the current pool fill level. Returns the resulting level. */
+enum pressure_level pressure_update(size_t free, size_t total);
+
+enum pressure_level pressure_level(void);
+
+const struct pressure_policy *pressure_policy(void);
+
+const char *pressure_level_str(enum pressure_level level);
+
+#endif /* PRESSURE_H */
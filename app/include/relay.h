@@ -0,0 +1,62 @@
+#ifndef RELAY_H
+#define RELAY_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/sys/slist.h>
+
+/*
+ * Send one frame on a link. Returns 0 once the link owns buf, or
+ * -EAGAIN if the link is busy and the caller keeps buf.
+ */
+typedef int (*relay_send_t)(void *ctx, struct net_buf *buf);
+
+struct relay_port {
+    relay_send_t send;
+    void *ctx;
+    sys_slist_t backlog;
+    uint8_t backlog_len;
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t drops;
+};
+
+/*
+ * Dual-role relay: frames from the upstream node (we are its peripheral)
+ * go to the downstream node (we are its central) and vice versa. Each
+ * net_buf holds one frame and is forwarded as is, without copying or
+ * involving USB. Credit frames are forwarded like any other frame, so
+ * the end nodes' credit windows bound the whole chain and the relay
+ * never grants credits of its own.
+ *
+ * A frame that cannot go on at once waits in the backlog. The link it
+ * came in on can keep the frame's link-level credit until then, so a
+ * slow hop stalls the hop before it rather than overrunning the backlog.
+ *
+ * Calls for one relay must not run concurrently. bt_relay.c wires one
+ * between the peripheral and central links; relay_test runs it over
+ * simulated links.
+ */
+struct relay {
+    struct relay_port up;
+    struct relay_port down;
+};
+
+void relay_init(struct relay *r, relay_send_t up_send, void *up_ctx,
+                relay_send_t down_send, void *down_ctx);
+
+/*
+ * Forward a frame received from upstream. Takes ownership of buf.
+ * Returns 0 if it went on at once, -EINPROGRESS if it waits in the
+ * backlog, or -EBADMSG or -ENOBUFS if it was dropped.
+ */
+int relay_from_upstream(struct relay *r, struct net_buf *buf);
+
+/* Forward a frame received from downstream, as relay_from_upstream(). */
+int relay_from_downstream(struct relay *r, struct net_buf *buf);
+
+/* Retry frames held back while a link was busy. */
+void relay_kick(struct relay *r);
+
+#endif /* RELAY_H */
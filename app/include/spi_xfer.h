@@ -0,0 +1,39 @@
+#ifndef SPI_XFER_H
+#define SPI_XFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Layout of every SPI transaction, the same in both directions:
+ *
+ *   magic (0x5A) | pending (u8) | len (le16) | payload[len] | padding
+ *
+ * From the host the payload is a piece of its frame stream. From the
+ * bridge it is whole frames back to back, as many as fit. The bridge
+ * sets pending when it has more frames queued behind the transaction,
+ * so the host clocks another one. A transaction without the magic
+ * carries nothing.
+ */
+#define SPI_XFER_MAGIC    0x5AU
+#define SPI_XFER_HDR_SIZE 4U
+
+/* Start an empty transaction at xfer. */
+void spi_xfer_init(uint8_t *xfer);
+
+/* Append len bytes if they fit in a transaction of size bytes. */
+bool spi_xfer_add(uint8_t *xfer, size_t size, const uint8_t *data, size_t len);
+
+/* Payload bytes in xfer so far. */
+size_t spi_xfer_len(const uint8_t *xfer);
+
+void spi_xfer_set_pending(uint8_t *xfer, bool pending);
+
+/*
+ * Check the len bytes of a received transaction. Returns the payload
+ * length, or -EBADMSG if it carries nothing or claims more than len.
+ */
+int spi_xfer_parse(const uint8_t *xfer, size_t len, bool *pending);
+
+#endif /* SPI_XFER_H */
@@ -0,0 +1,82 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+
+/*
+ * Stats travel to the host as FRAME_DATA frames on CONFIG_APP_STATS_CHAN.
+ * The first payload byte is the record type, the rest is its body.
+ *
+ * The host asks for a snapshot with a FRAME_CTRL frame on the same
+ * channel whose op is STATS_OP_SNAPSHOT. The reply is a single
+ * STATS_REC_SNAPSHOT record, little-endian:
+ *
+ *   uptime_ms (u32) | counter count (u8) | counters (u32 each)
+ *   histogram count (u8), then per histogram:
+ *     bucket count (u8) | buckets (u32 each) | sum_us (u64)
+ *
+ * Histogram bucket i counts values below 2^i us; the last bucket counts
+ * everything else.
+ */
+enum stats_rec_type {
+    STATS_REC_TRACE = 1,
+    STATS_REC_SNAPSHOT = 2,
+    STATS_REC_PAWR = 3, /* layout in pawr.h */
+    STATS_REC_FTAB = 4, /* layout in ftab.h */
+};
+
+enum stats_op {
+    STATS_OP_SNAPSHOT = 1,
+};
+
+/* Keep in step with COUNTERS in scripts/bridge-exporter.py; add new ones at the end. */
+enum stats_counter {
+    STATS_USB_RX_BYTES,
+    STATS_USB_RX_XFERS,
+    STATS_USB_STARVED,
+    STATS_USB_TX_BYTES,
+    STATS_FRAMES_RX,
+    STATS_RX_DROPPED_BYTES,
+    STATS_POOL_FREE,
+    STATS_PRESSURE_LEVEL,
+    STATS_DEADLINE_MISSES,
+    STATS_PAWR_RSP,
+    STATS_COUNTER_COUNT,
+};
+
+enum stats_hist {
+    STATS_HIST_HOLD_US, /* USB RX until the buffer is released */
+    STATS_HIST_PAWR_AGE_US, /* PAwR response until its batch is sent */
+    STATS_HIST_COUNT,
+};
+
+#define STATS_HIST_BUCKETS 16U
+
+/* Hands a finished frame to the host link. Takes ownership of buf. */
+typedef int (*stats_sink_t)(struct net_buf *buf);
+
+/* Writes a record body at dst. Returns bytes written, at most cap. */
+typedef size_t (*stats_fill_t)(uint8_t *dst, size_t cap);
+
+void stats_set_sink(stats_sink_t sink);
+
+/*
+ * Send one record of the given type, with the body produced by fill.
+ * Returns -ENODEV without a sink, -ENOMEM without a packet buffer and
+ * -ENODATA if fill wrote nothing.
+ */
+int stats_send(uint8_t rec_type, stats_fill_t fill);
+
+void stats_add(enum stats_counter counter, uint32_t value);
+
+void stats_observe(enum stats_hist hist, uint32_t value_us);
+
+/* Writes a STATS_REC_SNAPSHOT body. Returns bytes written. */
+size_t stats_snapshot(uint8_t *dst, size_t cap);
+
+/* Handle a FRAME_CTRL payload received on the stats channel. */
+int stats_handle_ctrl(const uint8_t *payload, size_t len);
+
+#endif /* STATS_H */
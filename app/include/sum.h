@@ -1,6 +1,38 @@
 #ifndef SUM_H
 #define SUM_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 int add(int a, int b);
 
+/* Keeps the int32_t sum of int16_t samples exact. */
+#define SUM_I16_MAX 65536U
+
+struct sum_i16 {
+    int32_t sum;
+    int16_t min;
+    int16_t max;
+};
+
+/*
+ * One implementation of the sample kernels. Every variant gives the same
+ * result; they differ only in the instructions they need.
+ */
+struct sum_impl {
+    const char *name;
+    /* Reduce n (1..SUM_I16_MAX) little-endian int16_t at src, any alignment. */
+    void (*i16_le)(const uint8_t *src, size_t n, struct sum_i16 *out);
+};
+
+/* Reduce through the implementation sum_select() picked, scalar before that. */
+void sum_i16_le(const uint8_t *src, size_t n, struct sum_i16 *out);
+
+/* Implementations the running CPU supports, scalar first. */
+size_t sum_impl_count(void);
+const struct sum_impl *sum_impl_get(size_t idx);
+
+/* Benchmark the supported implementations and dispatch to the fastest. */
+const struct sum_impl *sum_select(void);
+
 #endif /* SUM_H */
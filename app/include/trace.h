@@ -0,0 +1,42 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+
+enum trace_stage {
+    TRACE_USB_RX,   /* transfer completed on the OUT endpoint */
+    TRACE_APP_RX,   /* picked up by the bridge pipeline */
+    TRACE_BLE_TX,   /* queued to the BLE link */
+    TRACE_FREE,     /* buffer returned to the pool */
+    TRACE_STAGE_COUNT,
+};
+
+/*
+ * Exported record, little-endian:
+ *
+ *   seq (u32) | buf_id (u16) | stage mask (u8) | stage count (u8)
+ *   then per stage: cycles (u32) | queue depth (u8)
+ */
+#define TRACE_REC_SIZE (8U + 5U * TRACE_STAGE_COUNT)
+
+/* Sample one in rate packets from now on; 0 disables tracing. */
+void trace_set_rate(uint32_t rate);
+
+/*
+ * Called once per packet when it enters the bridge. Unsampled packets
+ * cost one atomic decrement.
+ */
+void trace_begin(struct net_buf *buf);
+
+/* Record that buf reached stage with depth entries queued there. */
+void trace_mark(struct net_buf *buf, enum trace_stage stage, uint8_t depth);
+
+/* Close the record of buf, if sampled. Called when buf is freed. */
+void trace_end(struct net_buf *buf);
+
+/* Move finished records to dst. Returns bytes written. */
+size_t trace_export(uint8_t *dst, size_t cap);
+
+#endif /* TRACE_H */
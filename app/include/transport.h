@@ -0,0 +1,32 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/net_buf.h>
+
+/*
+ * Link to the host that the bridge pipeline runs over. Buffers from the
+ * host hold a piece of its frame stream, cut wherever the link delivered
+ * it; buffers to the host hold whole frames. All are packet pool buffers.
+ */
+struct transport {
+    const char *name;
+    /* Bring the link up. */
+    int (*init)(void);
+    /* Wait for the next buffer received from the host. */
+    struct net_buf *(*recv)(k_timeout_t timeout);
+    /*
+     * Give back a buffer from recv, which may let the link receive again.
+     * With NULL it only tries that, as a buffer went back to the pool
+     * some other way.
+     */
+    void (*release)(struct net_buf *buf);
+    /* Queue a buffer for the host. Takes ownership of buf. */
+    int (*send)(struct net_buf *buf);
+};
+
+extern const struct transport usb_transport;
+extern const struct transport uart_transport;
+extern const struct transport spi_transport;
+
+#endif /* TRANSPORT_H */
@@ -0,0 +1,19 @@
+#ifndef USB_BRIDGE_H
+#define USB_BRIDGE_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/net_buf.h>
+
+/* Register the bridge class and enable the USB device. */
+int usb_bridge_init(void);
+
+/* Wait for the next transfer received from the host. */
+struct net_buf *usb_bridge_recv(k_timeout_t timeout);
+
+/* Release a received buffer and re-arm the OUT endpoint. */
+void usb_bridge_release(struct net_buf *buf);
+
+/* Queue a buffer for transfer to the host. Takes ownership of buf. */
+int usb_bridge_send(struct net_buf *buf);
+
+#endif /* USB_BRIDGE_H */
@@ -0,0 +1,40 @@
+#ifndef USB_OUT_H
+#define USB_OUT_H
+
+#include <stdint.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/sys/atomic.h>
+
+/* Queue a buffer on the endpoint. Returns 0 on success. */
+typedef int (*usb_out_submit_t)(void *ctx, struct net_buf *buf);
+
+/*
+ * Keeps up to CONFIG_APP_USB_OUT_DEPTH transfers armed on a bulk OUT
+ * endpoint, refilled from the packet pool, so the host always finds a
+ * buffer ready while the application consumes the previous one.
+ */
+struct usb_out_ep {
+    usb_out_submit_t submit;
+    void *ctx;
+    uint8_t depth;
+    atomic_t armed;
+    /* Completions after which no buffer was armed; the host sees NAKs. */
+    atomic_t starved;
+    atomic_t rx_xfers;
+    atomic_t rx_bytes;
+};
+
+void usb_out_ep_init(struct usb_out_ep *ep, uint8_t depth,
+                     usb_out_submit_t submit, void *ctx);
+
+/* Top the endpoint up to its depth. Returns the number of armed buffers. */
+int usb_out_ep_arm(struct usb_out_ep *ep);
+
+/*
+ * Account for a completed transfer and re-arm the endpoint. Returns the
+ * buffer if it carries data, otherwise releases it and returns NULL.
+ */
+struct net_buf *usb_out_ep_done(struct usb_out_ep *ep, struct net_buf *buf,
+                                int err);
+
+#endif /* USB_OUT_H */
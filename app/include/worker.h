@@ -0,0 +1,59 @@
+#ifndef WORKER_H
+#define WORKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/sys/slist.h>
+
+/*
+ * Bridge worker: a thread handling the frames of its queue in the order
+ * they were queued. Each frame is due a latency budget after it was
+ * queued; a frame handled later than that is a deadline miss.
+ *
+ * With fixed priorities every worker runs at its own priority. With
+ * deadlines (CONFIG_SCHED_DEADLINE) the workers share one priority and
+ * each takes the deadline of the frame at the head of its queue, so the
+ * scheduler runs whichever worker has the frame due first.
+ *
+ * Frames are packet pool buffers; the deadline is kept by buffer ID.
+ */
+typedef void (*worker_fn_t)(void *ctx, struct net_buf *buf);
+
+struct worker_stats {
+    uint32_t frames;
+    uint32_t misses;
+    /* Latest a frame was handled past its deadline. */
+    uint32_t max_late_us;
+};
+
+struct worker {
+    struct k_thread thread;
+    struct k_spinlock lock;
+    struct k_sem ready;
+    sys_slist_t queue;
+    worker_fn_t fn;
+    void *ctx;
+    bool edf;
+    /* Frames queued or being handled. */
+    uint32_t pending;
+    struct worker_stats stats;
+};
+
+/*
+ * Start w on stack. fn handles each frame and takes ownership of it.
+ * With edf, prio should be the same for all workers; without
+ * CONFIG_SCHED_DEADLINE edf is ignored.
+ */
+void worker_start(struct worker *w, k_thread_stack_t *stack, size_t stack_size, int prio,
+                  bool edf, worker_fn_t fn, void *ctx, const char *name);
+
+/* Queue buf, due budget_us from now. Takes ownership of buf. */
+void worker_submit(struct worker *w, struct net_buf *buf, uint32_t budget_us);
+
+/* Copy the stats of w and clear them. */
+void worker_stats(struct worker *w, struct worker_stats *stats);
+
+#endif /* WORKER_H */
@@ -0,0 +1,115 @@
+#include <zephyr/kernel.h>
+#include "admit.h"
+
+#define T_IFS_US      150U
+#define US_PER_UNIT   1250U
+#define MAX_INTERVAL  3200U
+/* Weight of a new sample in the rate estimate, as a shift. */
+#define RATE_SHIFT    2
+
+uint32_t admit_pdu_us(enum admit_phy phy, uint16_t len)
+{
+    /* Header, payload and CRC; uncoded PHYs add preamble and access address. */
+    uint32_t bits = (2U + len + 3U) * 8U;
+
+    switch (phy) {
+    case ADMIT_PHY_1M:
+        return (1U + 4U) * 8U + bits;
+    case ADMIT_PHY_2M:
+        return ((2U + 4U) * 8U + bits) / 2U;
+    case ADMIT_PHY_CODED_S2:
+        /* Preamble, access address, CI and TERM1 always go at S=8. */
+        return 376U + (bits + 3U) * 2U;
+    case ADMIT_PHY_CODED_S8:
+    default:
+        return 376U + (bits + 3U) * 8U;
+    }
+}
+
+uint32_t admit_exchange_us(enum admit_phy phy, uint16_t len)
+{
+    return admit_pdu_us(phy, len) + T_IFS_US + admit_pdu_us(phy, 0) + T_IFS_US;
+}
+
+void admit_link_init(struct admit_link *link, const struct admit_policy *policy,
+                     enum admit_phy phy, uint16_t interval, uint16_t pdu_len)
+{
+    link->active = true;
+    link->phy = (uint8_t)phy;
+    link->interval = interval;
+    link->pdu_len = MAX(pdu_len, 1U);
+    link->rate = policy->new_rate;
+}
+
+void admit_observe(struct admit_link *link, uint32_t bytes, uint32_t ms)
+{
+    int64_t sample;
+
+    if (ms == 0) {
+        return;
+    }
+
+    sample = (int64_t)bytes * 1000 / ms;
+    link->rate = (uint32_t)(link->rate + ((sample - (int64_t)link->rate) >> RATE_SHIFT));
+}
+
+uint32_t admit_link_ppm(const struct admit_link *link, const struct admit_policy *policy)
+{
+    uint32_t interval_us = (uint32_t)link->interval * US_PER_UNIT;
+    uint32_t exchange_us = admit_exchange_us(link->phy, link->pdu_len);
+    uint64_t need = (uint64_t)link->rate * (100U + policy->margin_pct) * interval_us /
+                    (100U * 1000000U);
+    uint64_t pdus = DIV_ROUND_UP(need, link->pdu_len);
+
+    /* One event per interval, which cannot outlast the interval. */
+    pdus = CLAMP(pdus, 1U, MAX(interval_us / exchange_us, 1U));
+
+    return (uint32_t)(pdus * exchange_us * 1000000U / interval_us);
+}
+
+uint32_t admit_committed_ppm(const struct admit_link *links, size_t n,
+                             const struct admit_policy *policy)
+{
+    uint32_t ppm = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (links[i].active) {
+            ppm += admit_link_ppm(&links[i], policy);
+        }
+    }
+
+    return ppm;
+}
+
+enum admit_verdict admit_check(const struct admit_link *links, size_t n,
+                               struct admit_link *cand, const struct admit_policy *policy)
+{
+    uint32_t committed = admit_committed_ppm(links, n, policy);
+    struct admit_link down = *cand;
+
+    if (committed + admit_link_ppm(cand, policy) <= policy->budget_ppm) {
+        return ADMIT_ACCEPT;
+    }
+
+    /* Nothing promised: the fewest events, each a single exchange. */
+    down.interval = (uint16_t)MIN((uint32_t)cand->interval * policy->downgrade, MAX_INTERVAL);
+    down.rate = 0;
+    if (policy->downgrade > 1U &&
+        committed + admit_link_ppm(&down, policy) <= policy->budget_ppm) {
+        *cand = down;
+        return ADMIT_DOWNGRADE;
+    }
+
+    return ADMIT_REJECT;
+}
+
+const char *admit_verdict_str(enum admit_verdict verdict)
+{
+    static const char *const names[] = {
+        [ADMIT_ACCEPT] = "accept",
+        [ADMIT_DOWNGRADE] = "downgrade",
+        [ADMIT_REJECT] = "reject",
+    };
+
+    return verdict < ARRAY_SIZE(names) ? names[verdict] : "?";
+}
@@ -0,0 +1,165 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include "agg.h"
+#include "ftab.h"
+#include "sum.h"
+
+/* Keeps the running sum of a window within int32_t. */
+#define AGG_WINDOW_MAX 32768U
+
+static struct agg_stage channels[CONFIG_APP_AGG_CHANNELS];
+
+static uint8_t agg_outputs(enum agg_mode mode)
+{
+    switch (mode) {
+    case AGG_NONE:
+        return 0;
+    case AGG_MIN_MAX_MEAN:
+        return 3;
+    default:
+        return 1;
+    }
+}
+
+static int16_t agg_mean(int32_t sum, uint16_t window)
+{
+    int32_t half = window / 2;
+
+    /* Round to nearest, symmetric around zero. */
+    return (int16_t)(sum >= 0 ? (sum + half) / window : (sum - half) / window);
+}
+
+/* Write up to max pending outputs. */
+static void agg_emit(struct agg_stage *st, uint8_t **out, size_t max)
+{
+    while (max-- > 0 && st->pend_pos < st->pend_len) {
+        sys_put_le16((uint16_t)st->pend[st->pend_pos++], *out);
+        *out += 2;
+    }
+}
+
+int agg_init(struct agg_stage *st, enum agg_mode mode, uint16_t window)
+{
+    if (mode > AGG_MIN_MAX_MEAN || window == 0 || window > AGG_WINDOW_MAX ||
+        window < agg_outputs(mode)) {
+        return -EINVAL;
+    }
+
+    /* Nothing left over from a window or a previous mode. */
+    *st = (struct agg_stage){ .mode = mode, .window = window };
+
+    return 0;
+}
+
+size_t agg_process(struct agg_stage *st, const uint8_t *in, size_t len,
+                   uint8_t *out)
+{
+    uint8_t *const start = out;
+
+    if (st->mode == AGG_NONE) {
+        if (out != in) {
+            memmove(out, in, len);
+        }
+        return len;
+    }
+
+    for (size_t i = 0; i + 1 < len;) {
+        /* The run of samples up to the end of the current window. */
+        size_t n = MIN((len - i) / 2U, (size_t)(st->window - st->count));
+        struct sum_i16 r;
+
+        if (st->count == 0) {
+            st->first = (int16_t)sys_get_le16(&in[i]);
+        }
+
+        sum_i16_le(&in[i], n, &r);
+        i += n * 2U;
+
+        if (st->count == 0) {
+            st->min = r.min;
+            st->max = r.max;
+            st->sum = r.sum;
+        } else {
+            st->min = MIN(st->min, r.min);
+            st->max = MAX(st->max, r.max);
+            st->sum += r.sum;
+        }
+
+        st->count += (uint16_t)n;
+
+        /*
+         * One output per input keeps writes behind reads: the tail of the
+         * last window goes out one per sample of the run, and a window that
+         * the run completes gets the run's last sample.
+         */
+        if (st->count < st->window) {
+            agg_emit(st, &out, n);
+            continue;
+        }
+
+        agg_emit(st, &out, n - 1U);
+        st->count = 0;
+        st->pend_pos = 0;
+        st->pend_len = agg_outputs(st->mode);
+
+        switch (st->mode) {
+        case AGG_DECIMATE:
+            st->pend[0] = st->first;
+            break;
+        case AGG_MIN:
+            st->pend[0] = st->min;
+            break;
+        case AGG_MAX:
+            st->pend[0] = st->max;
+            break;
+        case AGG_MEAN:
+            st->pend[0] = agg_mean(st->sum, st->window);
+            break;
+        default:
+            st->pend[0] = st->min;
+            st->pend[1] = st->max;
+            st->pend[2] = agg_mean(st->sum, st->window);
+            break;
+        }
+
+        agg_emit(st, &out, 1);
+    }
+
+    return (size_t)(out - start);
+}
+
+int agg_channel_set(uint8_t chan, enum agg_mode mode, uint16_t window)
+{
+    if (chan >= ARRAY_SIZE(channels)) {
+        return -EINVAL;
+    }
+
+    return agg_init(&channels[chan], mode, window);
+}
+
+int agg_load_rules(const uint8_t *tab, size_t len)
+{
+    size_t pos;
+
+    for (pos = 0; pos + FTAB_RULE_SIZE <= len; pos += FTAB_RULE_SIZE) {
+        int err = agg_channel_set(tab[pos], (enum agg_mode)tab[pos + 1U],
+                                  sys_get_le16(&tab[pos + 2U]));
+
+        if (err != 0) {
+            return err;
+        }
+    }
+
+    return (int)(pos / FTAB_RULE_SIZE);
+}
+
+void agg_channel_apply(uint8_t chan, struct net_buf *buf)
+{
+    if (chan >= ARRAY_SIZE(channels)) {
+        return;
+    }
+
+    buf->len = agg_process(&channels[chan], buf->data, buf->len, buf->data);
+}
@@ -0,0 +1,1108 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/l2cap.h>
+#include "admit.h"
+#include "bt_central.h"
+#include "caps.h"
+#include "dict.h"
+#include "frame.h"
+#include "ftab.h"
+#include "nus.h"
+#include "pkt_pool.h"
+#include "phy_sel.h"
+#include "pkt_track.h"
+#include "pressure.h"
+#include "trace.h"
+
+LOG_MODULE_REGISTER(bt_central, LOG_LEVEL_INF);
+
+/* SDUs are received into and sent from the shared packet pool as is. */
+BUILD_ASSERT(CONFIG_APP_PKT_SIZE >= CONFIG_APP_BT_RX_MTU,
+             "a received SDU must fit in one packet buffer");
+BUILD_ASSERT(CONFIG_APP_PKT_HEADROOM >= BT_L2CAP_SDU_CHAN_SEND_RESERVE,
+             "packet buffers need room for the L2CAP and ACL headers");
+/* Link indexes double as frame channels. */
+BUILD_ASSERT(CONFIG_BT_MAX_CONN <= CONFIG_APP_STATS_CHAN,
+             "link channels would run into the stats channel");
+
+/* A relay leaves one connection to the upstream node; see bt_relay.h. */
+#if defined(CONFIG_APP_RELAY)
+#define LINK_COUNT (CONFIG_BT_MAX_CONN - 1)
+#else
+#define LINK_COUNT CONFIG_BT_MAX_CONN
+#endif
+
+struct link {
+    struct bt_conn *conn;
+    struct bt_l2cap_le_chan chan;
+    bt_addr_le_t addr;
+    int64_t seen_at;
+    uint32_t setup_ms;
+    uint16_t interval;
+    /* Receive data length and PHY, as enum admit_phy. */
+    uint16_t pdu_len;
+    uint8_t phy;
+    atomic_t rx_bytes;
+    /* Received since the link was last sampled; see link_sample(). */
+    atomic_t load_bytes;
+    atomic_t rx_frames;
+    atomic_t rx_cycles;
+    atomic_t tx_bytes;
+    atomic_t tx_frames;
+    atomic_t tx_cycles;
+    /* SDUs handed to the stack and not reported sent yet. */
+    atomic_t tx_queued;
+    struct caps caps;
+    bool negotiated;
+    bool nus;
+    bool up;
+};
+
+static struct link links[LINK_COUNT];
+static struct link *connecting;
+static bt_central_sink_t rx_sink;
+static bt_central_sent_t tx_sent;
+static bool host_dict;
+
+static void scan_start(struct k_work *work);
+static K_WORK_DEFINE(scan_work, scan_start);
+
+#define SAMPLE_MS   1000U
+/* As requested with BT_LE_DATA_LEN_PARAM_MAX, until the update says. */
+#define PDU_LEN_MAX 251U
+
+#if defined(CONFIG_APP_ADMIT)
+static const struct admit_policy admit_policy = {
+    .budget_ppm = CONFIG_APP_ADMIT_BUDGET_PCT * 10000U,
+    .new_rate = CONFIG_APP_ADMIT_NEW_KBPS * 1000U / 8U,
+    .margin_pct = CONFIG_APP_ADMIT_MARGIN_PCT,
+    .downgrade = CONFIG_APP_ADMIT_DOWNGRADE,
+};
+
+/*
+ * Indexed like links. Only the BT RX thread and the system work queue
+ * touch them; a stale rate read by admission is as good as an estimate.
+ */
+static struct admit_link admit_links[LINK_COUNT];
+static struct bt_central_admit_stats admit_stats;
+static int64_t admit_retry_at;
+
+static void admit_sample(size_t idx, uint32_t bytes)
+{
+    if (admit_links[idx].active) {
+        admit_links[idx].phy = links[idx].phy;
+        admit_links[idx].pdu_len = links[idx].pdu_len;
+        admit_observe(&admit_links[idx], bytes, SAMPLE_MS);
+    }
+}
+
+/* The interval to connect link idx with, or 0 to leave the peer alone. */
+static uint16_t admit_connect(size_t idx)
+{
+    struct admit_link cand;
+    enum admit_verdict verdict;
+
+    if (k_uptime_get() < admit_retry_at) {
+        return 0;
+    }
+
+    admit_link_init(&cand, &admit_policy, ADMIT_PHY_2M, CONFIG_APP_BT_CONN_INTERVAL,
+                    PDU_LEN_MAX);
+    verdict = admit_check(admit_links, ARRAY_SIZE(admit_links), &cand, &admit_policy);
+
+    switch (verdict) {
+    case ADMIT_ACCEPT:
+        admit_stats.accepted++;
+        break;
+    case ADMIT_DOWNGRADE:
+        admit_stats.downgraded++;
+        break;
+    default:
+        admit_stats.rejected++;
+        admit_retry_at = k_uptime_get() + CONFIG_APP_ADMIT_RETRY_MS;
+        break;
+    }
+
+    if (verdict != ADMIT_ACCEPT) {
+        LOG_INF("admission: %s, %u ppm committed", admit_verdict_str(verdict),
+                admit_committed_ppm(admit_links, ARRAY_SIZE(admit_links), &admit_policy));
+    }
+    if (verdict == ADMIT_REJECT) {
+        return 0;
+    }
+
+    /* Committed from now on, so a second peer cannot take the same room. */
+    admit_links[idx] = cand;
+
+    return cand.interval;
+}
+
+static void admit_release(size_t idx)
+{
+    admit_links[idx].active = false;
+}
+#else
+static void admit_sample(size_t idx, uint32_t bytes)
+{
+    ARG_UNUSED(idx);
+    ARG_UNUSED(bytes);
+}
+
+static uint16_t admit_connect(size_t idx)
+{
+    ARG_UNUSED(idx);
+
+    return CONFIG_APP_BT_CONN_INTERVAL;
+}
+
+static void admit_release(size_t idx)
+{
+    ARG_UNUSED(idx);
+}
+#endif /* CONFIG_APP_ADMIT */
+
+#if defined(CONFIG_APP_PHY_SEL)
+static const struct phy_sel_policy phy_policy = {
+    .hyst_pct = CONFIG_APP_PHY_SEL_HYST_PCT,
+    .confirm = CONFIG_APP_PHY_SEL_CONFIRM,
+    .dwell_ms = CONFIG_APP_PHY_SEL_DWELL_MS,
+};
+
+/*
+ * Indexed like links. Sampled on phy_wq, and reset or corrected from the
+ * connection callbacks, so always under phy_lock.
+ */
+static struct phy_sel phy_sels[LINK_COUNT];
+static struct k_spinlock phy_lock;
+
+/*
+ * Read RSSI waits for the controller, so links are sampled on a queue of
+ * their own instead of holding up the system work queue.
+ */
+#define PHY_STACK_SIZE 1024
+
+static K_THREAD_STACK_DEFINE(phy_stack, PHY_STACK_SIZE);
+static struct k_work_q phy_wq;
+
+static void phy_sample_links(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(phy_work, phy_sample_links);
+
+static int read_rssi(struct bt_conn *conn, int8_t *rssi)
+{
+    struct bt_hci_cp_read_rssi *cp;
+    struct bt_hci_rp_read_rssi *rp;
+    struct net_buf *rsp;
+    struct net_buf *buf;
+    uint16_t handle;
+    int err;
+
+    err = bt_hci_get_conn_handle(conn, &handle);
+    if (err != 0) {
+        return err;
+    }
+
+    buf = bt_hci_cmd_alloc(K_FOREVER);
+    if (buf == NULL) {
+        return -ENOBUFS;
+    }
+
+    cp = net_buf_add(buf, sizeof(*cp));
+    cp->handle = sys_cpu_to_le16(handle);
+
+    err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
+    if (err != 0) {
+        return err;
+    }
+
+    rp = (void *)rsp->data;
+    *rssi = rp->rssi;
+    net_buf_unref(rsp);
+
+    return 0;
+}
+
+/* The PHY the link is on, as the controller reports it. */
+static void phy_track(size_t idx, enum admit_phy phy)
+{
+    k_spinlock_key_t key = k_spin_lock(&phy_lock);
+
+    phy_sels[idx].phy = (uint8_t)phy;
+    k_spin_unlock(&phy_lock, key);
+}
+
+/* conn is the link's, with a reference the caller holds. */
+static void phy_request(struct link *link, struct bt_conn *conn, enum admit_phy phy)
+{
+    struct bt_conn_le_phy_param param = {
+        .options = BT_CONN_LE_PHY_OPT_NONE,
+        .pref_tx_phy = BT_GAP_LE_PHY_2M,
+        .pref_rx_phy = BT_GAP_LE_PHY_2M,
+    };
+
+    if (phy == ADMIT_PHY_CODED_S2) {
+        param.options = BT_CONN_LE_PHY_OPT_CODED_S2;
+        param.pref_tx_phy = BT_GAP_LE_PHY_CODED;
+        param.pref_rx_phy = BT_GAP_LE_PHY_CODED;
+    }
+
+    LOG_INF("link %u: switching to %s", (unsigned int)(link - links),
+            phy == ADMIT_PHY_2M ? "2M" : "coded S=2");
+
+    if (bt_conn_le_phy_update(conn, &param) != 0) {
+        phy_track(link - links, link->phy);
+    }
+}
+
+/*
+ * The controller reports no CRC errors to the host, and exchanges a busy
+ * link leaves unused may be down to the peer's rate or credits rather
+ * than loss. So no PER is measured: both PHYs are judged by the model at
+ * the link's RSSI, and the hysteresis keeps the link from flapping.
+ */
+static void phy_sample(size_t idx)
+{
+    struct link *link = &links[idx];
+    struct phy_sel *sel = &phy_sels[idx];
+    struct phy_sel_sample sample = { .ms = SAMPLE_MS };
+    struct bt_conn *conn = link->conn;
+    k_spinlock_key_t key;
+    enum admit_phy from;
+    enum admit_phy to;
+
+    if (!link->up || conn == NULL) {
+        return;
+    }
+
+    /* Held until the update is asked for, in case the link goes meanwhile. */
+    conn = bt_conn_ref(conn);
+    if (conn == NULL) {
+        return;
+    }
+
+    sample.rssi_valid = read_rssi(conn, &sample.rssi) == 0;
+
+    /* Gone, or its slot taken by another, while the command waited. */
+    if (link->conn != conn) {
+        bt_conn_unref(conn);
+        return;
+    }
+
+    key = k_spin_lock(&phy_lock);
+    from = sel->phy;
+    to = phy_sel_update(sel, &sample, link->pdu_len, &phy_policy);
+    k_spin_unlock(&phy_lock, key);
+
+    if (to != from) {
+        phy_request(link, conn, to);
+    }
+
+    bt_conn_unref(conn);
+}
+
+static void phy_sample_links(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        phy_sample(i);
+    }
+
+    k_work_schedule_for_queue(&phy_wq, &phy_work, K_MSEC(SAMPLE_MS));
+}
+
+static void phy_sampling_start(void)
+{
+    const struct k_work_queue_config cfg = { .name = "phy_sel" };
+
+    k_work_queue_start(&phy_wq, phy_stack, K_THREAD_STACK_SIZEOF(phy_stack),
+                       K_LOWEST_APPLICATION_THREAD_PRIO, &cfg);
+    k_work_schedule_for_queue(&phy_wq, &phy_work, K_MSEC(SAMPLE_MS));
+}
+
+static void phy_start(size_t idx)
+{
+    k_spinlock_key_t key = k_spin_lock(&phy_lock);
+
+    phy_sel_init(&phy_sels[idx], ADMIT_PHY_2M);
+    k_spin_unlock(&phy_lock, key);
+}
+#else
+static void phy_sampling_start(void)
+{
+}
+
+static void phy_start(size_t idx)
+{
+    ARG_UNUSED(idx);
+}
+#endif /* CONFIG_APP_PHY_SEL */
+
+static void link_sample(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(sample_work, link_sample);
+
+/* Feed each link's traffic to admission once a period. */
+static void link_sample(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        uint32_t bytes = (uint32_t)atomic_set(&links[i].load_bytes, 0);
+
+        admit_sample(i, bytes);
+    }
+
+    k_work_schedule(&sample_work, K_MSEC(SAMPLE_MS));
+}
+
+static struct link *link_by_conn(const struct bt_conn *conn)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (links[i].conn == conn) {
+            return &links[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct link *link_by_addr(const bt_addr_le_t *addr)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (links[i].conn != NULL && bt_addr_le_eq(&links[i].addr, addr)) {
+            return &links[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct net_buf *chan_alloc_buf(struct bt_l2cap_chan *chan)
+{
+    struct net_buf *buf = pkt_alloc(K_FOREVER);
+
+    ARG_UNUSED(chan);
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK) && buf != NULL) {
+        pkt_track_set(buf, PKT_OWNER_BT_RX);
+    }
+
+    return buf;
+}
+
+static void local_caps(struct caps *caps)
+{
+    caps_init(caps);
+    caps->mtu = CONFIG_APP_BT_RX_MTU;
+    /* Data goes over the CoC only, so EATT is not offered. */
+    caps->features = CAPS_F_L2CAP_COC;
+    if (IS_ENABLED(CONFIG_APP_DICT)) {
+        caps->features |= CAPS_F_COMPRESSION;
+        caps->dict = dict_active()->id;
+    }
+    caps->batch = CONFIG_APP_BT_RX_BUF_COUNT;
+    caps->credits = CONFIG_APP_CREDITS;
+}
+
+static void send_hello(struct link *link)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+    struct caps local;
+
+    if (buf == NULL) {
+        return;
+    }
+
+    local_caps(&local);
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_BT_TX);
+    }
+
+    if (caps_add_hello(buf, 0, &local) != 0 ||
+        bt_l2cap_chan_send(&link->chan.chan, buf) != 0) {
+        net_buf_unref(buf);
+        return;
+    }
+
+    atomic_inc(&link->tx_queued);
+}
+
+/* Returns true if buf was the peer's hello. */
+static bool recv_hello(struct link *link, const struct net_buf *buf)
+{
+    struct frame_hdr hdr;
+    struct caps local;
+    struct caps peer;
+
+    if (frame_get_hdr(buf->data, buf->len, &hdr) != 0 || hdr.type != FRAME_CTRL ||
+        buf->len < FRAME_HDR_SIZE + hdr.len ||
+        caps_parse_hello(&buf->data[FRAME_HDR_SIZE], hdr.len, &peer) != 0) {
+        return false;
+    }
+
+    local_caps(&local);
+    if (caps_select(&local, &peer, &link->caps) != 0) {
+        LOG_WRN("link %u: peer protocol %08x not supported",
+                (unsigned int)(link - links), peer.version);
+        (void)bt_conn_disconnect(link->conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+        return true;
+    }
+
+    link->negotiated = true;
+    LOG_INF("link %u: mtu %u batch %u credits %u features 0x%x",
+            (unsigned int)(link - links), link->caps.mtu, link->caps.batch,
+            link->caps.credits, link->caps.features);
+
+    return true;
+}
+
+/*
+ * The frame buf delivers, with a reference of its own: buf itself, or a
+ * new buffer if dictionary compression must be undone here. NULL if it is
+ * malformed or there is no buffer to expand it into.
+ */
+static struct net_buf *rx_frame(const struct link *link, struct net_buf *buf)
+{
+    struct frame_hdr hdr;
+    struct net_buf *out;
+    int n;
+
+    if (!IS_ENABLED(CONFIG_APP_DICT) || !(link->caps.features & CAPS_F_COMPRESSION) ||
+        frame_get_hdr(buf->data, buf->len, &hdr) != 0 || hdr.type != FRAME_DATA_DICT) {
+        return net_buf_ref(buf);
+    }
+
+    if (IS_ENABLED(CONFIG_APP_PRESSURE) && host_dict && !pressure_policy()->compression) {
+        return net_buf_ref(buf);
+    }
+
+    out = pkt_alloc(K_NO_WAIT);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    n = dict_unpack_frame(buf->data, buf->len, out->data, net_buf_tailroom(out));
+    if (n < 0) {
+        LOG_WRN("link %u: bad compressed frame (%d)", (unsigned int)(link - links), n);
+        net_buf_unref(out);
+        return NULL;
+    }
+
+    net_buf_add(out, n);
+
+    return out;
+}
+
+/*
+ * Hand on the frame in buf, received on link. The caller keeps its
+ * reference. Returns -EINPROGRESS if the sink holds on to buf itself.
+ */
+static int rx_deliver(struct link *link, struct net_buf *buf)
+{
+    uint32_t start = k_cycle_get_32();
+    struct net_buf *frame = rx_frame(link, buf);
+    int err = 0;
+
+    if (frame == NULL) {
+        return 0;
+    }
+
+    atomic_add(&link->rx_bytes, frame->len);
+    atomic_add(&link->load_bytes, frame->len);
+
+    /*
+     * Peers pick their own channel; the host tells them apart by link. A
+     * relay leaves it to the bridge at the end of the chain.
+     */
+    if (!IS_ENABLED(CONFIG_APP_RELAY) && frame->len >= FRAME_HDR_SIZE) {
+        frame->data[1] = (uint8_t)(link - links);
+    }
+
+    /* An SDU goes on in the buffer the controller filled, without a copy. */
+    if (rx_sink != NULL) {
+        err = rx_sink(frame);
+    } else {
+        net_buf_unref(frame);
+    }
+
+    atomic_inc(&link->rx_frames);
+    atomic_add(&link->rx_cycles, k_cycle_get_32() - start);
+
+    /* An expanded frame is a copy; the credit of buf goes back now. */
+    return err == -EINPROGRESS && frame == buf ? -EINPROGRESS : 0;
+}
+
+static int chan_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+    struct link *link = CONTAINER_OF(chan, struct link, chan.chan);
+
+    if (!link->negotiated && recv_hello(link, buf)) {
+        return 0;
+    }
+
+    /* Held: the stack's reference stays with us until bt_central_recv_done(). */
+    return rx_deliver(link, buf);
+}
+
+static void chan_sent(struct bt_l2cap_chan *chan)
+{
+    struct link *link = CONTAINER_OF(chan, struct link, chan.chan);
+
+    atomic_dec(&link->tx_queued);
+
+    if (tx_sent != NULL) {
+        tx_sent();
+    }
+}
+
+static void chan_connected(struct bt_l2cap_chan *chan)
+{
+    struct link *link = CONTAINER_OF(chan, struct link, chan.chan);
+
+    link->setup_ms = (uint32_t)(k_uptime_get() - link->seen_at);
+    link->up = true;
+
+    LOG_INF("link %u up in %u ms", (unsigned int)(link - links), link->setup_ms);
+
+    /* Until the peer answers, assume the oldest protocol. */
+    caps_init(&link->caps);
+    link->negotiated = false;
+    atomic_set(&link->tx_queued, 0);
+    send_hello(link);
+}
+
+#if defined(CONFIG_APP_BT_NUS)
+BUILD_ASSERT(FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD <= NUS_TX_BACKLOG,
+             "a full frame must fit in the NUS backlog");
+
+/* Indexed like links. NUS carries a byte stream, so frames are found again here. */
+static struct frame_decoder nus_decoders[LINK_COUNT];
+
+/*
+ * Indexed like links. Frames to the peer share writes, and wait whole
+ * while the stack has no buffer for one; nus_tx_work tries again.
+ */
+static struct nus_tx nus_txs[LINK_COUNT];
+static K_MUTEX_DEFINE(nus_tx_lock);
+
+static void nus_tx_retry(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(nus_tx_work, nus_tx_retry);
+
+static int nus_flush(void *user, const uint8_t *data, uint16_t len)
+{
+    struct link *link = user;
+
+    return nus_client_send(link - links, data, len);
+}
+
+static void nus_tx_retry(struct k_work *work)
+{
+    bool pending = false;
+
+    ARG_UNUSED(work);
+
+    k_mutex_lock(&nus_tx_lock, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        if (links[i].nus && nus_tx_pump(&nus_txs[i])) {
+            pending = true;
+        }
+    }
+    k_mutex_unlock(&nus_tx_lock);
+
+    if (pending) {
+        k_work_reschedule(&nus_tx_work, K_MSEC(1));
+    }
+}
+
+/* Takes ownership of buf. Returns -ENOBUFS if the frame cannot be taken whole. */
+static int nus_send(struct link *link, struct net_buf *buf)
+{
+    struct nus_tx *tx = &nus_txs[link - links];
+    bool pending;
+    int err;
+
+    k_mutex_lock(&nus_tx_lock, K_FOREVER);
+    err = nus_tx_frame(tx, buf->data, buf->len);
+    pending = nus_tx_pump(tx);
+    k_mutex_unlock(&nus_tx_lock);
+
+    net_buf_unref(buf);
+
+    if (pending) {
+        k_work_schedule(&nus_tx_work, K_MSEC(1));
+    }
+
+    return err;
+}
+
+static void nus_frame(void *user, const struct frame_hdr *hdr, const uint8_t *payload)
+{
+    struct link *link = user;
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    if (buf == NULL) {
+        return;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_BT_RX);
+    }
+
+    frame_put_hdr(net_buf_add(buf, FRAME_HDR_SIZE), hdr);
+    net_buf_add_mem(buf, payload, hdr->len);
+    (void)rx_deliver(link, buf);
+    net_buf_unref(buf);
+}
+
+static void nus_recv(void *user, const uint8_t *data, uint16_t len)
+{
+    struct link *link = user;
+
+    frame_decode(&nus_decoders[link - links], data, len);
+}
+
+static void nus_ready(void *user, int err)
+{
+    struct link *link = user;
+
+    if (err != 0) {
+        (void)bt_conn_disconnect(link->conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+        return;
+    }
+
+    link->setup_ms = (uint32_t)(k_uptime_get() - link->seen_at);
+    link->nus = true;
+    link->up = true;
+
+    /* Off-the-shelf NUS peers do not send a hello. */
+    caps_init(&link->caps);
+    link->caps.mtu = nus_client_mtu(link - links) - 3U;
+
+    k_mutex_lock(&nus_tx_lock, K_FOREVER);
+    nus_tx_init(&nus_txs[link - links], nus_flush, link);
+    nus_packer_set_mtu(&nus_txs[link - links].packer, nus_client_mtu(link - links));
+    k_mutex_unlock(&nus_tx_lock);
+
+    LOG_INF("link %u up over NUS in %u ms", (unsigned int)(link - links),
+            link->setup_ms);
+}
+
+static int nus_start(struct link *link)
+{
+    frame_decoder_init(&nus_decoders[link - links], nus_frame, link);
+
+    return nus_client_start(link - links, link->conn, nus_ready, nus_recv, link);
+}
+#else
+static int nus_start(struct link *link)
+{
+    ARG_UNUSED(link);
+
+    return -ENOTSUP;
+}
+
+static int nus_send(struct link *link, struct net_buf *buf)
+{
+    ARG_UNUSED(link);
+
+    net_buf_unref(buf);
+
+    return -ENOTSUP;
+}
+#endif /* CONFIG_APP_BT_NUS */
+
+static void chan_disconnected(struct bt_l2cap_chan *chan)
+{
+    struct link *link = CONTAINER_OF(chan, struct link, chan.chan);
+    bool refused = !link->up;
+
+    link->up = false;
+
+    /* The peer has no CoC server: try it as a NUS peripheral instead. */
+    if (IS_ENABLED(CONFIG_APP_BT_NUS) && refused && link->conn != NULL &&
+        nus_start(link) != 0) {
+        (void)bt_conn_disconnect(link->conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+    }
+}
+
+static const struct bt_l2cap_chan_ops chan_ops = {
+    .alloc_buf = chan_alloc_buf,
+    .recv = chan_recv,
+    .sent = chan_sent,
+    .connected = chan_connected,
+    .disconnected = chan_disconnected,
+};
+
+static bool ad_has_peer_name(struct bt_data *data, void *user_data)
+{
+    bool *found = user_data;
+
+    if (data->type == BT_DATA_NAME_COMPLETE &&
+        data->data_len == sizeof(CONFIG_APP_BT_PEER_NAME) - 1 &&
+        memcmp(data->data, CONFIG_APP_BT_PEER_NAME, data->data_len) == 0) {
+        *found = true;
+        return false;
+    }
+
+    return true;
+}
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+                         struct net_buf_simple *ad)
+{
+    struct bt_le_conn_param param;
+    const uint8_t *peers = NULL;
+    struct link *link;
+    bool found = false;
+    size_t len;
+
+    ARG_UNUSED(rssi);
+
+    if (type != BT_GAP_ADV_TYPE_ADV_IND || connecting != NULL ||
+        link_by_addr(addr) != NULL) {
+        return;
+    }
+
+    /* A peers table replaces the name match; it is read where it lies. */
+    if (IS_ENABLED(CONFIG_APP_FTAB)) {
+        peers = ftab_get(FTAB_PEERS, &len);
+    }
+
+    if (peers != NULL) {
+        found = ftab_peer_listed(peers, len, addr->type, addr->a.val);
+    } else {
+        bt_data_parse(ad, ad_has_peer_name, &found);
+    }
+    if (!found) {
+        return;
+    }
+
+    link = link_by_conn(NULL);
+    if (link == NULL) {
+        return;
+    }
+
+    link->interval = admit_connect(link - links);
+    if (link->interval == 0U) {
+        return;
+    }
+
+    if (bt_le_scan_stop() != 0) {
+        admit_release(link - links);
+        return;
+    }
+
+    bt_addr_le_copy(&link->addr, addr);
+    link->seen_at = k_uptime_get();
+
+    /* Supervision timeout in 10 ms units: at least six intervals. */
+    param = (struct bt_le_conn_param)BT_LE_CONN_PARAM_INIT(
+        link->interval, link->interval, 0, MAX(400U, link->interval * 3U / 4U + 1U));
+
+    if (bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN, &param, &link->conn) != 0) {
+        admit_release(link - links);
+        link->conn = NULL;
+        k_work_submit(&scan_work);
+        return;
+    }
+
+    connecting = link;
+}
+
+static void scan_start(struct k_work *work)
+{
+    int err;
+
+    ARG_UNUSED(work);
+
+    if (connecting != NULL || link_by_conn(NULL) == NULL) {
+        return;
+    }
+
+    err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+    if (err != 0 && err != -EALREADY) {
+        LOG_ERR("scan start failed (%d)", err);
+    }
+}
+
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+    struct link *link = link_by_conn(conn);
+
+    if (link == NULL) {
+        return;
+    }
+
+    connecting = NULL;
+
+    if (err != 0) {
+        admit_release(link - links);
+        bt_conn_unref(link->conn);
+        link->conn = NULL;
+        k_work_submit(&scan_work);
+        return;
+    }
+
+    (void)bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    (void)bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+
+    memset(&link->chan, 0, sizeof(link->chan));
+    link->chan.chan.ops = &chan_ops;
+    link->chan.rx.mtu = CONFIG_APP_BT_RX_MTU;
+    atomic_set(&link->rx_bytes, 0);
+    atomic_set(&link->load_bytes, 0);
+    link->phy = ADMIT_PHY_2M;
+    link->pdu_len = PDU_LEN_MAX;
+    phy_start(link - links);
+
+    if (bt_l2cap_chan_connect(conn, &link->chan.chan, CONFIG_APP_BT_L2CAP_PSM) != 0) {
+        LOG_ERR("L2CAP connect failed");
+    }
+
+    k_work_submit(&scan_work);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+    struct link *link = link_by_conn(conn);
+
+    if (link == NULL) {
+        return;
+    }
+
+    LOG_INF("link %u down (0x%02x)", (unsigned int)(link - links), reason);
+
+    if (connecting == link) {
+        connecting = NULL;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_BT_NUS)) {
+        nus_client_stop(link - links);
+    }
+
+    admit_release(link - links);
+    bt_conn_unref(link->conn);
+    link->conn = NULL;
+    link->nus = false;
+    link->up = false;
+}
+
+static void recycled(void)
+{
+    k_work_submit(&scan_work);
+}
+
+#if defined(CONFIG_BT_USER_PHY_UPDATE)
+static void le_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *param)
+{
+    struct link *link = link_by_conn(conn);
+
+    if (link == NULL) {
+        return;
+    }
+
+    switch (param->rx_phy) {
+    case BT_GAP_LE_PHY_2M:
+        link->phy = ADMIT_PHY_2M;
+        break;
+    case BT_GAP_LE_PHY_CODED:
+        /* The coding is not reported; PHY selection only asks for S=2. */
+        link->phy = IS_ENABLED(CONFIG_APP_PHY_SEL) ? ADMIT_PHY_CODED_S2 : ADMIT_PHY_CODED_S8;
+        break;
+    default:
+        link->phy = ADMIT_PHY_1M;
+        break;
+    }
+
+#if defined(CONFIG_APP_PHY_SEL)
+    phy_track(link - links, link->phy);
+#endif
+}
+#endif
+
+#if defined(CONFIG_BT_USER_DATA_LEN_UPDATE)
+static void le_data_len_updated(struct bt_conn *conn, struct bt_conn_le_data_len_info *info)
+{
+    struct link *link = link_by_conn(conn);
+
+    if (link != NULL) {
+        link->pdu_len = MAX(info->rx_max_len, 1U);
+    }
+}
+#endif
+
+BT_CONN_CB_DEFINE(central_conn_callbacks) = {
+    .connected = connected,
+    .disconnected = disconnected,
+    .recycled = recycled,
+#if defined(CONFIG_BT_USER_PHY_UPDATE)
+    .le_phy_updated = le_phy_updated,
+#endif
+#if defined(CONFIG_BT_USER_DATA_LEN_UPDATE)
+    .le_data_len_updated = le_data_len_updated,
+#endif
+};
+
+void bt_central_set_sink(bt_central_sink_t sink)
+{
+    rx_sink = sink;
+}
+
+void bt_central_set_sent(bt_central_sent_t sent)
+{
+    tx_sent = sent;
+}
+
+void bt_central_set_host_dict(bool expands)
+{
+    host_dict = expands;
+}
+
+int bt_central_send(size_t idx, struct net_buf *buf)
+{
+    uint32_t start = k_cycle_get_32();
+    uint16_t len = buf->len;
+    struct link *link;
+    int err;
+
+    if (idx >= ARRAY_SIZE(links) || !links[idx].up) {
+        net_buf_unref(buf);
+        return -ENOTCONN;
+    }
+
+    link = &links[idx];
+
+    /* Larger than the peer accepts; dropped as the host does. */
+    if (link->negotiated && len > link->caps.mtu) {
+        net_buf_unref(buf);
+        return -EMSGSIZE;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_BT_NUS) && link->nus) {
+        if (IS_ENABLED(CONFIG_APP_TRACE)) {
+            trace_mark(buf, TRACE_BLE_TX, 0);
+        }
+        err = nus_send(link, buf);
+    } else {
+        if (IS_ENABLED(CONFIG_APP_TRACE)) {
+            trace_mark(buf, TRACE_BLE_TX, (uint8_t)MIN(atomic_get(&link->tx_queued), UINT8_MAX));
+        }
+        if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+            pkt_track_set(buf, PKT_OWNER_BT_TX);
+        }
+
+        err = bt_l2cap_chan_send(&link->chan.chan, buf);
+        if (err != 0) {
+            net_buf_unref(buf);
+        } else {
+            atomic_inc(&link->tx_queued);
+        }
+    }
+
+    if (err != 0) {
+        return err;
+    }
+
+    atomic_add(&link->tx_bytes, len);
+    atomic_inc(&link->tx_frames);
+    atomic_add(&link->tx_cycles, k_cycle_get_32() - start);
+
+    return 0;
+}
+
+int bt_central_start(void)
+{
+    int err = bt_enable(NULL);
+
+    if (err != 0) {
+        LOG_ERR("Bluetooth init failed (%d)", err);
+        return err;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_ADMIT)) {
+        k_work_schedule(&sample_work, K_MSEC(SAMPLE_MS));
+    }
+    if (IS_ENABLED(CONFIG_APP_PHY_SEL)) {
+        phy_sampling_start();
+    }
+    k_work_submit(&scan_work);
+
+    return 0;
+}
+
+void bt_central_recv_done(size_t idx, struct net_buf *buf)
+{
+    /* NUS frames are copies and hold nothing. */
+    if (idx >= ARRAY_SIZE(links) || links[idx].nus) {
+        return;
+    }
+
+    /* Takes the reference the stack left us, even if the channel is gone. */
+    (void)bt_l2cap_chan_recv_complete(&links[idx].chan.chan, buf);
+}
+
+bool bt_central_link_busy(size_t idx)
+{
+    if (idx >= ARRAY_SIZE(links) || !links[idx].up) {
+        return false;
+    }
+
+    return atomic_get(&links[idx].tx_queued) >= bt_central_link_credits(idx);
+}
+
+uint8_t bt_central_link_credits(size_t idx)
+{
+    if (idx >= ARRAY_SIZE(links) || !links[idx].negotiated) {
+        return CONFIG_APP_CREDITS;
+    }
+
+    return links[idx].caps.credits;
+}
+
+size_t bt_central_link_count(void)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+        count += links[i].up ? 1U : 0U;
+    }
+
+    return count;
+}
+
+bool bt_central_link_stats(size_t idx, struct bt_central_link_stats *stats)
+{
+    if (idx >= ARRAY_SIZE(links)) {
+        return false;
+    }
+
+    stats->up = links[idx].up;
+    stats->setup_ms = links[idx].setup_ms;
+    stats->interval = links[idx].interval;
+    stats->phy = links[idx].phy;
+    stats->mtu = links[idx].caps.mtu;
+    stats->features = links[idx].caps.features;
+    stats->nus = links[idx].nus;
+    stats->rx_bytes = (uint32_t)atomic_set(&links[idx].rx_bytes, 0);
+    stats->rx_frames = (uint32_t)atomic_set(&links[idx].rx_frames, 0);
+    stats->rx_cycles = (uint32_t)atomic_set(&links[idx].rx_cycles, 0);
+    stats->tx_bytes = (uint32_t)atomic_set(&links[idx].tx_bytes, 0);
+    stats->tx_frames = (uint32_t)atomic_set(&links[idx].tx_frames, 0);
+    stats->tx_cycles = (uint32_t)atomic_set(&links[idx].tx_cycles, 0);
+
+    return true;
+}
+
+void bt_central_admit_stats(struct bt_central_admit_stats *stats)
+{
+#if defined(CONFIG_APP_ADMIT)
+    *stats = admit_stats;
+    stats->committed_ppm =
+        admit_committed_ppm(admit_links, ARRAY_SIZE(admit_links), &admit_policy);
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
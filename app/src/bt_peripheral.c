@@ -0,0 +1,317 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/l2cap.h>
+#include "bt_peripheral.h"
+#include "caps.h"
+#include "frame.h"
+#include "pkt_pool.h"
+#include "pkt_track.h"
+
+LOG_MODULE_REGISTER(bt_peripheral, LOG_LEVEL_INF);
+
+/* The upstream node's connection, the one we are peripheral on. */
+static struct bt_conn *up_conn;
+static struct bt_l2cap_le_chan up_chan;
+static struct caps session;
+static bool negotiated;
+static bool up;
+/* SDUs handed to the stack and not reported sent yet. */
+static atomic_t tx_queued;
+static bt_peripheral_sink_t rx_sink;
+static bt_peripheral_sent_t tx_sent;
+
+static const struct bt_data ad[] = {
+    BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+    BT_DATA(BT_DATA_NAME_COMPLETE, CONFIG_BT_DEVICE_NAME,
+            sizeof(CONFIG_BT_DEVICE_NAME) - 1),
+};
+
+static void adv_start(struct k_work *work);
+static K_WORK_DEFINE(adv_work, adv_start);
+
+static struct net_buf *chan_alloc_buf(struct bt_l2cap_chan *chan)
+{
+    struct net_buf *buf = pkt_alloc(K_FOREVER);
+
+    ARG_UNUSED(chan);
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK) && buf != NULL) {
+        pkt_track_set(buf, PKT_OWNER_BT_RX);
+    }
+
+    return buf;
+}
+
+static void local_caps(struct caps *caps)
+{
+    caps_init(caps);
+    caps->mtu = CONFIG_APP_BT_RX_MTU;
+    caps->features = CAPS_F_L2CAP_COC;
+    caps->batch = CONFIG_APP_BT_RX_BUF_COUNT;
+    caps->credits = CONFIG_APP_CREDITS;
+}
+
+static void send_hello(void)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+    struct caps local;
+
+    if (buf == NULL) {
+        return;
+    }
+
+    local_caps(&local);
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_BT_TX);
+    }
+
+    if (caps_add_hello(buf, 0, &local) != 0 ||
+        bt_l2cap_chan_send(&up_chan.chan, buf) != 0) {
+        net_buf_unref(buf);
+        return;
+    }
+
+    atomic_inc(&tx_queued);
+}
+
+/* Returns true if buf was the upstream node's hello. */
+static bool recv_hello(const struct net_buf *buf)
+{
+    struct frame_hdr hdr;
+    struct caps local;
+    struct caps node;
+
+    if (frame_get_hdr(buf->data, buf->len, &hdr) != 0 || hdr.type != FRAME_CTRL ||
+        buf->len < FRAME_HDR_SIZE + hdr.len ||
+        caps_parse_hello(&buf->data[FRAME_HDR_SIZE], hdr.len, &node) != 0) {
+        return false;
+    }
+
+    local_caps(&local);
+    if (caps_select(&local, &node, &session) != 0) {
+        LOG_WRN("upstream protocol %08x not supported", node.version);
+        (void)bt_conn_disconnect(up_conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+        return true;
+    }
+
+    negotiated = true;
+    LOG_INF("upstream: mtu %u batch %u credits %u features 0x%x", session.mtu,
+            session.batch, session.credits, session.features);
+
+    return true;
+}
+
+static int chan_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+    ARG_UNUSED(chan);
+
+    if (!negotiated && recv_hello(buf)) {
+        return 0;
+    }
+
+    if (rx_sink == NULL || buf->len < FRAME_HDR_SIZE) {
+        return 0;
+    }
+
+    /* The sink gets a reference of its own; the stack's stays with us if it says so. */
+    return rx_sink(net_buf_ref(buf)) == -EINPROGRESS ? -EINPROGRESS : 0;
+}
+
+static void chan_sent(struct bt_l2cap_chan *chan)
+{
+    ARG_UNUSED(chan);
+
+    atomic_dec(&tx_queued);
+
+    if (tx_sent != NULL) {
+        tx_sent();
+    }
+}
+
+static void chan_connected(struct bt_l2cap_chan *chan)
+{
+    ARG_UNUSED(chan);
+
+    up = true;
+    LOG_INF("upstream channel up: tx mtu %u, rx mtu %u", up_chan.tx.mtu, up_chan.rx.mtu);
+
+    /* Until the node answers, assume the oldest protocol. */
+    caps_init(&session);
+    negotiated = false;
+    atomic_set(&tx_queued, 0);
+    send_hello();
+}
+
+static void chan_disconnected(struct bt_l2cap_chan *chan)
+{
+    ARG_UNUSED(chan);
+
+    up = false;
+}
+
+static const struct bt_l2cap_chan_ops chan_ops = {
+    .alloc_buf = chan_alloc_buf,
+    .recv = chan_recv,
+    .sent = chan_sent,
+    .connected = chan_connected,
+    .disconnected = chan_disconnected,
+};
+
+static int server_accept(struct bt_conn *conn, struct bt_l2cap_server *server,
+                         struct bt_l2cap_chan **chan)
+{
+    ARG_UNUSED(server);
+
+    if (conn != up_conn || up_chan.chan.conn != NULL) {
+        return -ENOMEM;
+    }
+
+    memset(&up_chan, 0, sizeof(up_chan));
+    up_chan.chan.ops = &chan_ops;
+    up_chan.rx.mtu = CONFIG_APP_BT_RX_MTU;
+    *chan = &up_chan.chan;
+
+    return 0;
+}
+
+static struct bt_l2cap_server server = {
+    .psm = CONFIG_APP_BT_L2CAP_PSM,
+    .accept = server_accept,
+    .sec_level = BT_SECURITY_L1,
+};
+
+static void adv_start(struct k_work *work)
+{
+    int err;
+
+    ARG_UNUSED(work);
+
+    if (up_conn != NULL) {
+        return;
+    }
+
+    err = bt_le_adv_start(BT_LE_ADV_CONN_FAST_1, ad, ARRAY_SIZE(ad), NULL, 0);
+    if (err != 0 && err != -EALREADY) {
+        LOG_ERR("advertising start failed (%d)", err);
+    }
+}
+
+/* Central links are bt_central's. */
+static bool is_upstream(struct bt_conn *conn)
+{
+    struct bt_conn_info info;
+
+    return bt_conn_get_info(conn, &info) == 0 && info.role == BT_CONN_ROLE_PERIPHERAL;
+}
+
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+    if (err != 0 || !is_upstream(conn)) {
+        return;
+    }
+
+    if (up_conn != NULL) {
+        (void)bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+        return;
+    }
+
+    up_conn = bt_conn_ref(conn);
+    LOG_INF("upstream connected");
+
+    (void)bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    (void)bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+    if (conn != up_conn) {
+        return;
+    }
+
+    LOG_INF("upstream down (0x%02x)", reason);
+
+    bt_conn_unref(up_conn);
+    up_conn = NULL;
+    up = false;
+}
+
+static void recycled(void)
+{
+    k_work_submit(&adv_work);
+}
+
+BT_CONN_CB_DEFINE(peripheral_conn_callbacks) = {
+    .connected = connected,
+    .disconnected = disconnected,
+    .recycled = recycled,
+};
+
+void bt_peripheral_set_sink(bt_peripheral_sink_t sink)
+{
+    rx_sink = sink;
+}
+
+void bt_peripheral_set_sent(bt_peripheral_sent_t sent)
+{
+    tx_sent = sent;
+}
+
+int bt_peripheral_start(void)
+{
+    int err = bt_l2cap_server_register(&server);
+
+    if (err != 0) {
+        LOG_ERR("L2CAP server register failed (%d)", err);
+        return err;
+    }
+
+    k_work_submit(&adv_work);
+
+    return 0;
+}
+
+int bt_peripheral_send(struct net_buf *buf)
+{
+    int err;
+
+    if (!up) {
+        net_buf_unref(buf);
+        return -ENOTCONN;
+    }
+
+    if (negotiated && buf->len > session.mtu) {
+        net_buf_unref(buf);
+        return -EMSGSIZE;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_BT_TX);
+    }
+
+    err = bt_l2cap_chan_send(&up_chan.chan, buf);
+    if (err != 0) {
+        net_buf_unref(buf);
+        return err;
+    }
+
+    atomic_inc(&tx_queued);
+
+    return 0;
+}
+
+bool bt_peripheral_busy(void)
+{
+    uint8_t window = negotiated ? session.credits : CONFIG_APP_CREDITS;
+
+    return up && atomic_get(&tx_queued) >= window;
+}
+
+void bt_peripheral_recv_done(struct net_buf *buf)
+{
+    /* Takes the reference the stack left us, even if the channel is gone. */
+    (void)bt_l2cap_chan_recv_complete(&up_chan.chan, buf);
+}
@@ -0,0 +1,123 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "bt_central.h"
+#include "bt_peripheral.h"
+#include "bt_relay.h"
+#include "relay.h"
+
+LOG_MODULE_REGISTER(bt_relay, LOG_LEVEL_INF);
+
+/* One upstream connection as peripheral, one downstream as central. */
+BUILD_ASSERT(CONFIG_BT_MAX_CONN == 2, "a relay has exactly two links");
+
+#define DOWN_LINK 0U
+
+static struct relay relay;
+/* The BT RX thread forwards, the callbacks of sent frames retry. */
+static K_MUTEX_DEFINE(relay_lock);
+
+/*
+ * Both send callbacks hand the incoming link its credit back first: the
+ * stack only sends a buffer nobody else holds a reference to.
+ */
+static int down_send(void *ctx, struct net_buf *buf)
+{
+    ARG_UNUSED(ctx);
+
+    if (bt_central_link_busy(DOWN_LINK)) {
+        return -EAGAIN;
+    }
+
+    bt_peripheral_recv_done(buf);
+    /* Failures drop buf like any frame to a link that went down. */
+    (void)bt_central_send(DOWN_LINK, buf);
+
+    return 0;
+}
+
+static int up_send(void *ctx, struct net_buf *buf)
+{
+    ARG_UNUSED(ctx);
+
+    if (bt_peripheral_busy()) {
+        return -EAGAIN;
+    }
+
+    bt_central_recv_done(DOWN_LINK, buf);
+    (void)bt_peripheral_send(buf);
+
+    return 0;
+}
+
+/*
+ * A frame sent on or waiting in the backlog keeps the stack's reference
+ * until its send callback runs; a dropped one gives it back at once.
+ */
+static int hold(int err)
+{
+    return err == 0 || err == -EINPROGRESS ? -EINPROGRESS : 0;
+}
+
+static int from_upstream(struct net_buf *buf)
+{
+    int err;
+
+    k_mutex_lock(&relay_lock, K_FOREVER);
+    err = relay_from_upstream(&relay, buf);
+    k_mutex_unlock(&relay_lock);
+
+    return hold(err);
+}
+
+static int from_downstream(struct net_buf *buf)
+{
+    int err;
+
+    k_mutex_lock(&relay_lock, K_FOREVER);
+    err = relay_from_downstream(&relay, buf);
+    k_mutex_unlock(&relay_lock);
+
+    return hold(err);
+}
+
+/* A link took a frame off its queue; frames waiting for it may go now. */
+static void link_sent(void)
+{
+    k_mutex_lock(&relay_lock, K_FOREVER);
+    relay_kick(&relay);
+    k_mutex_unlock(&relay_lock);
+}
+
+int bt_relay_start(void)
+{
+    int err;
+
+    relay_init(&relay, up_send, NULL, down_send, NULL);
+
+    bt_peripheral_set_sink(from_upstream);
+    bt_peripheral_set_sent(link_sent);
+    bt_central_set_sink(from_downstream);
+    bt_central_set_sent(link_sent);
+
+    err = bt_central_start();
+    if (err != 0) {
+        return err;
+    }
+
+    LOG_INF("relaying as \"%s\" to \"%s\"", CONFIG_BT_DEVICE_NAME, CONFIG_APP_BT_PEER_NAME);
+
+    return bt_peripheral_start();
+}
+
+void bt_relay_stats(struct bt_relay_stats *stats)
+{
+    k_mutex_lock(&relay_lock, K_FOREVER);
+    stats->down_frames = relay.down.frames;
+    stats->down_bytes = relay.down.bytes;
+    stats->down_drops = relay.down.drops;
+    stats->up_frames = relay.up.frames;
+    stats->up_bytes = relay.up.bytes;
+    stats->up_drops = relay.up.drops;
+    k_mutex_unlock(&relay_lock);
+}
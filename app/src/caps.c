@@ -0,0 +1,162 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+#include <app_version.h>
+#include <zephyr/sys/byteorder.h>
+#include "caps.h"
+#include "ctrl.h"
+#include "frame.h"
+
+#define CAPS_MAJOR(version) ((version) >> 24)
+
+void caps_init(struct caps *caps)
+{
+    memset(caps, 0, sizeof(*caps));
+    caps->version = APPVERSION;
+    caps->mtu = CAPS_MTU_MIN;
+    caps->batch = 1;
+    caps->credits = 1;
+}
+
+size_t caps_put_hello(uint8_t *dst, size_t cap, const struct caps *caps)
+{
+    uint8_t version[4];
+    uint8_t mtu[2];
+    uint8_t features[4];
+    uint8_t batch[2];
+    uint8_t dict[2];
+    size_t pos = 1;
+
+    if (cap < CAPS_HELLO_SIZE) {
+        return 0;
+    }
+
+    sys_put_le32(caps->version, version);
+    sys_put_le16(caps->mtu, mtu);
+    sys_put_le32(caps->features, features);
+    sys_put_le16(caps->batch, batch);
+    sys_put_le16(caps->dict, dict);
+
+    dst[0] = CAPS_OP_HELLO;
+    pos += ctrl_put_tlv(&dst[pos], cap - pos, CAPS_TAG_VERSION, version, 4);
+    pos += ctrl_put_tlv(&dst[pos], cap - pos, CAPS_TAG_MTU, mtu, 2);
+    pos += ctrl_put_tlv(&dst[pos], cap - pos, CAPS_TAG_FEATURES, features, 4);
+    pos += ctrl_put_tlv(&dst[pos], cap - pos, CAPS_TAG_BATCH, batch, 2);
+    pos += ctrl_put_tlv(&dst[pos], cap - pos, CAPS_TAG_CREDITS, &caps->credits, 1);
+    pos += ctrl_put_tlv(&dst[pos], cap - pos, CAPS_TAG_DICT, dict, 2);
+
+    return pos;
+}
+
+int caps_add_hello(struct net_buf *buf, uint8_t chan, const struct caps *caps)
+{
+    struct frame_hdr hdr = { .chan = chan, .type = FRAME_CTRL };
+    uint8_t *hdr_pos;
+
+    if (net_buf_tailroom(buf) < FRAME_HDR_SIZE + CAPS_HELLO_SIZE) {
+        return -ENOMEM;
+    }
+
+    hdr_pos = net_buf_add(buf, FRAME_HDR_SIZE);
+    hdr.len = (uint16_t)caps_put_hello(buf->data + buf->len, CAPS_HELLO_SIZE, caps);
+    net_buf_add(buf, hdr.len);
+    frame_put_hdr(hdr_pos, &hdr);
+
+    return 0;
+}
+
+struct caps_parse {
+    struct caps *caps;
+    bool has_version;
+};
+
+static int caps_tlv(void *user, const struct ctrl_tlv *tlv)
+{
+    struct caps_parse *parse = user;
+    struct caps *caps = parse->caps;
+
+    /* Fields may grow; read the part this firmware knows about. */
+    switch (tlv->tag) {
+    case CAPS_TAG_VERSION:
+        if (tlv->len < 4U) {
+            return -EBADMSG;
+        }
+        caps->version = sys_get_le32(tlv->value);
+        parse->has_version = true;
+        break;
+    case CAPS_TAG_MTU:
+        if (tlv->len < 2U) {
+            return -EBADMSG;
+        }
+        caps->mtu = MAX(sys_get_le16(tlv->value), CAPS_MTU_MIN);
+        break;
+    case CAPS_TAG_FEATURES:
+        if (tlv->len < 4U) {
+            return -EBADMSG;
+        }
+        caps->features = sys_get_le32(tlv->value);
+        break;
+    case CAPS_TAG_BATCH:
+        if (tlv->len < 2U) {
+            return -EBADMSG;
+        }
+        caps->batch = MAX(sys_get_le16(tlv->value), 1U);
+        break;
+    case CAPS_TAG_CREDITS:
+        if (tlv->len < 1U) {
+            return -EBADMSG;
+        }
+        caps->credits = MAX(tlv->value[0], 1U);
+        break;
+    case CAPS_TAG_DICT:
+        if (tlv->len < 2U) {
+            return -EBADMSG;
+        }
+        caps->dict = sys_get_le16(tlv->value);
+        break;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+int caps_parse_hello(const uint8_t *payload, size_t len, struct caps *caps)
+{
+    struct caps_parse parse = { .caps = caps };
+    uint8_t op;
+    int err;
+
+    caps_init(caps);
+    caps->version = 0;
+
+    err = ctrl_parse(payload, len, &op, caps_tlv, &parse);
+    if (err != 0) {
+        return err;
+    }
+
+    if (op != CAPS_OP_HELLO) {
+        return -ENOMSG;
+    }
+
+    return parse.has_version ? 0 : -EBADMSG;
+}
+
+int caps_select(const struct caps *a, const struct caps *b, struct caps *out)
+{
+    if (CAPS_MAJOR(a->version) != CAPS_MAJOR(b->version)) {
+        return -EPROTO;
+    }
+
+    out->version = MIN(a->version, b->version);
+    out->mtu = MIN(a->mtu, b->mtu);
+    out->features = a->features & b->features;
+    out->batch = MIN(a->batch, b->batch);
+    out->credits = MIN(a->credits, b->credits);
+    out->dict = a->dict == b->dict ? a->dict : 0U;
+    if (out->dict == 0U) {
+        out->features &= ~(uint32_t)CAPS_F_COMPRESSION;
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <zephyr/kernel.h>
+#include "credit.h"
+
+void credit_tx_init(struct credit_tx *tx)
+{
+    atomic_set(&tx->avail, 0);
+}
+
+bool credit_tx_take(struct credit_tx *tx)
+{
+    atomic_val_t avail;
+
+    do {
+        avail = atomic_get(&tx->avail);
+        if (avail == 0) {
+            return false;
+        }
+    } while (!atomic_cas(&tx->avail, avail, avail - 1));
+
+    return true;
+}
+
+void credit_tx_grant(struct credit_tx *tx, uint8_t count)
+{
+    atomic_add(&tx->avail, count);
+}
+
+void credit_rx_init(struct credit_rx *rx, uint8_t window)
+{
+    rx->window = window;
+    rx->out = window;
+}
+
+void credit_rx_set_window(struct credit_rx *rx, uint8_t window)
+{
+    rx->window = window;
+}
+
+uint8_t credit_rx_consumed(struct credit_rx *rx)
+{
+    if (rx->out > 0) {
+        rx->out--;
+    }
+
+    if (rx->out + MAX(rx->window / 2U, 1U) > rx->window) {
+        return 0;
+    }
+
+    return credit_rx_flush(rx);
+}
+
+uint8_t credit_rx_flush(struct credit_rx *rx)
+{
+    uint8_t grant;
+
+    if (rx->out >= rx->window) {
+        return 0;
+    }
+
+    grant = rx->window - rx->out;
+    rx->out = rx->window;
+
+    return grant;
+}
@@ -0,0 +1,52 @@
+#include <errno.h>
+#include <string.h>
+#include "ctrl.h"
+
+int ctrl_parse(const uint8_t *payload, size_t len, uint8_t *op,
+               ctrl_tlv_cb_t cb, void *user)
+{
+    size_t pos = 1;
+
+    if (len == 0) {
+        return -EBADMSG;
+    }
+
+    *op = payload[0];
+
+    while (pos < len) {
+        struct ctrl_tlv tlv;
+        int err;
+
+        if (len - pos < 2U || len - pos - 2U < payload[pos + 1]) {
+            return -EBADMSG;
+        }
+
+        tlv.tag = payload[pos];
+        tlv.len = payload[pos + 1];
+        tlv.value = &payload[pos + 2];
+        pos += 2U + tlv.len;
+
+        err = cb(user, &tlv);
+        if (err != 0) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+size_t ctrl_put_tlv(uint8_t *dst, size_t cap, uint8_t tag, const void *value,
+                    uint8_t len)
+{
+    if (cap < 2U + len) {
+        return 0;
+    }
+
+    dst[0] = tag;
+    dst[1] = len;
+    if (len > 0) {
+        memcpy(&dst[2], value, len);
+    }
+
+    return 2U + len;
+}
@@ -0,0 +1,267 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include "dict.h"
+#include "frame.h"
+
+/* Dictionary candidates tried per position; bounds the cycles per byte. */
+#define DICT_CHAIN_STEPS 16U
+/* Earlier positions of the message itself, indexed by hash. */
+#define DICT_SELF_HASH   64U
+
+BUILD_ASSERT(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+             "dictionary tables are read in place as little-endian");
+
+static const struct dict *active = &dict_builtin;
+
+struct dict_out {
+    uint8_t *dst;
+    size_t cap;
+    size_t pos;
+};
+
+static size_t match_len(const uint8_t *a, const uint8_t *b, size_t max)
+{
+    size_t n = 0;
+
+    while (n < max && a[n] == b[n]) {
+        n++;
+    }
+
+    return n;
+}
+
+static bool put_literals(struct dict_out *out, const uint8_t *src, size_t len)
+{
+    while (len > 0) {
+        size_t run = MIN(len, DICT_LITERAL_MAX);
+
+        if (out->pos + 1U + run > out->cap) {
+            return false;
+        }
+
+        out->dst[out->pos++] = (uint8_t)(run - 1U);
+        memcpy(&out->dst[out->pos], src, run);
+        out->pos += run;
+        src += run;
+        len -= run;
+    }
+
+    return true;
+}
+
+static bool put_match(struct dict_out *out, size_t len, size_t dist)
+{
+    if (out->pos + 3U > out->cap) {
+        return false;
+    }
+
+    out->dst[out->pos] = (uint8_t)(0x80U | (len - DICT_MATCH_MIN));
+    sys_put_le16((uint16_t)dist, &out->dst[out->pos + 1U]);
+    out->pos += 3U;
+
+    return true;
+}
+
+const struct dict *dict_active(void)
+{
+    return active;
+}
+
+void dict_use(const struct dict *dict)
+{
+    active = dict;
+}
+
+int dict_from_table(const uint8_t *tab, size_t len, struct dict *dict)
+{
+    size_t size;
+    size_t head;
+
+    if (len < 4U || ((uintptr_t)tab & 1U) != 0) {
+        return -EBADMSG;
+    }
+
+    size = sys_get_le16(&tab[2]);
+    head = 4U + ROUND_UP(size, 2U);
+    if (sys_get_le16(tab) == 0 || len != head + (DICT_HASH_SIZE + size) * 2U) {
+        return -EBADMSG;
+    }
+
+    dict->id = sys_get_le16(tab);
+    dict->size = (uint16_t)size;
+    dict->data = &tab[4];
+    dict->head = (const void *)&tab[head];
+    dict->chain = &dict->head[DICT_HASH_SIZE];
+
+    /* The compressor follows these without further checks. */
+    for (size_t i = 0; i < DICT_HASH_SIZE + size; i++) {
+        if (dict->head[i] > size) {
+            return -EBADMSG;
+        }
+    }
+
+    return 0;
+}
+
+size_t dict_compress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap)
+{
+    const struct dict *d = active;
+    uint8_t self[DICT_SELF_HASH] = { 0 };
+    struct dict_out out = { .dst = dst, .cap = MIN(cap, len) };
+    size_t lit = 0;
+    size_t pos = 0;
+
+    /* Distances must fit in 16 bits. */
+    if (len == 0 || d->size + len > UINT16_MAX) {
+        return 0;
+    }
+
+    while (pos + DICT_MATCH_MIN <= len) {
+        uint8_t h = dict_hash(&src[pos]);
+        size_t max = MIN(len - pos, DICT_MATCH_MAX);
+        size_t best = 0;
+        size_t dist = 0;
+        uint16_t cand = self[h % DICT_SELF_HASH];
+
+        if (cand != 0) {
+            best = match_len(&src[cand - 1U], &src[pos], max);
+            dist = pos - (cand - 1U);
+        }
+
+        cand = d->head[h];
+        for (size_t step = 0; cand != 0 && step < DICT_CHAIN_STEPS && best < max; step++) {
+            size_t at = cand - 1U;
+            size_t n = match_len(&d->data[at], &src[pos], MIN(max, d->size - at));
+
+            if (n > best) {
+                best = n;
+                dist = d->size - at + pos;
+            }
+            cand = d->chain[at];
+        }
+
+        /* The index holds single bytes; later positions are not indexed. */
+        if (pos < UINT8_MAX) {
+            self[h % DICT_SELF_HASH] = (uint8_t)(pos + 1U);
+        }
+
+        if (best < DICT_MATCH_MIN) {
+            pos++;
+            continue;
+        }
+
+        if (!put_literals(&out, &src[lit], pos - lit) || !put_match(&out, best, dist)) {
+            return 0;
+        }
+
+        pos += best;
+        lit = pos;
+    }
+
+    if (!put_literals(&out, &src[lit], len - lit) || out.pos >= len) {
+        return 0;
+    }
+
+    return out.pos;
+}
+
+int dict_decompress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap)
+{
+    const struct dict *d = active;
+    size_t in = 0;
+    size_t pos = 0;
+
+    while (in < len) {
+        uint8_t t = src[in++];
+        size_t run;
+        size_t dist;
+
+        if (t < 0x80U) {
+            run = t + 1U;
+
+            if (in + run > len) {
+                return -EBADMSG;
+            }
+            if (pos + run > cap) {
+                return -ENOMEM;
+            }
+
+            memcpy(&dst[pos], &src[in], run);
+            in += run;
+            pos += run;
+            continue;
+        }
+
+        if (in + 2U > len) {
+            return -EBADMSG;
+        }
+
+        run = (t & 0x7FU) + DICT_MATCH_MIN;
+        dist = sys_get_le16(&src[in]);
+        in += 2U;
+
+        if (dist == 0 || dist > d->size + pos) {
+            return -EBADMSG;
+        }
+        if (pos + run > cap) {
+            return -ENOMEM;
+        }
+
+        /* Byte by byte: a match may overlap its own output. */
+        for (size_t v = d->size + pos - dist; run > 0; v++, run--) {
+            dst[pos++] = v < d->size ? d->data[v] : dst[v - d->size];
+        }
+    }
+
+    return (int)pos;
+}
+
+size_t dict_pack_frame(uint8_t *frame, size_t len)
+{
+    uint8_t packed[CONFIG_APP_DICT_MAX_LEN];
+    struct frame_hdr hdr;
+    size_t n;
+
+    if (frame_get_hdr(frame, len, &hdr) != 0 || hdr.type != FRAME_DATA ||
+        hdr.len > sizeof(packed) || len != FRAME_HDR_SIZE + hdr.len) {
+        return len;
+    }
+
+    n = dict_compress(&frame[FRAME_HDR_SIZE], hdr.len, packed, sizeof(packed));
+    if (n == 0) {
+        return len;
+    }
+
+    hdr.type = FRAME_DATA_DICT;
+    hdr.len = (uint16_t)n;
+    frame_put_hdr(frame, &hdr);
+    memcpy(&frame[FRAME_HDR_SIZE], packed, n);
+
+    return FRAME_HDR_SIZE + n;
+}
+
+int dict_unpack_frame(const uint8_t *frame, size_t len, uint8_t *dst, size_t cap)
+{
+    struct frame_hdr hdr;
+    int n;
+
+    if (frame_get_hdr(frame, len, &hdr) != 0 || hdr.type != FRAME_DATA_DICT ||
+        len < FRAME_HDR_SIZE + hdr.len || cap < FRAME_HDR_SIZE) {
+        return -EBADMSG;
+    }
+
+    n = dict_decompress(&frame[FRAME_HDR_SIZE], hdr.len, &dst[FRAME_HDR_SIZE],
+                        MIN(cap - FRAME_HDR_SIZE, CONFIG_APP_FRAME_MAX_PAYLOAD));
+    if (n < 0) {
+        return n;
+    }
+
+    hdr.type = FRAME_DATA;
+    hdr.len = (uint16_t)n;
+    frame_put_hdr(dst, &hdr);
+
+    return FRAME_HDR_SIZE + n;
+}
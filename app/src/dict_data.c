@@ -0,0 +1,217 @@
+/*
+ * Generated by scripts/dict-train.py from 4000 messages; do not edit.
+ *
+ *   scripts/dict-train.py train train.bin -o app/src/dict_data.c
+ */
+#include "dict.h"
+
+static const uint8_t data[1022] = {
+    0x6e, 0x3a, 0x20, 0x6d, 0x74, 0x75, 0x20, 0x34, 0x39, 0x38, 0x20, 0x62,
+    0x61, 0x74, 0x63, 0x68, 0x20, 0x00, 0x04, 0x02, 0x08, 0x00, 0x05, 0x01,
+    0x10, 0x06, 0x02, 0x00, 0x00, 0x04, 0x02, 0x04, 0x00, 0x05, 0x01, 0x08,
+    0x06, 0x02, 0x00, 0x00, 0x03, 0x04, 0x03, 0x00, 0x00, 0x00, 0x04, 0x02,
+    0x20, 0x64, 0x72, 0x6f, 0x70, 0x73, 0x3d, 0x36, 0x2c, 0x22, 0x72, 0x73,
+    0x73, 0x69, 0x22, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x32, 0x32, 0x22,
+    0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x31,
+    0x37, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x03, 0x04, 0x01, 0x00,
+    0x00, 0x00, 0x04, 0x02, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x30, 0x34,
+    0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x31, 0x2c, 0x22, 0x72, 0x73, 0x73,
+    0x69, 0x22, 0x2e, 0x33, 0x2c, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a, 0x2c,
+    0x22, 0x74, 0x22, 0x3a, 0x31, 0x37, 0x2e, 0x22, 0x6e, 0x6f, 0x64, 0x65,
+    0x2d, 0x31, 0x39, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x22, 0x6e,
+    0x6f, 0x64, 0x65, 0x2d, 0x31, 0x33, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71,
+    0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x31, 0x32, 0x22, 0x2c, 0x22, 0x73,
+    0x65, 0x71, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x30, 0x38, 0x22, 0x2c,
+    0x22, 0x73, 0x65, 0x71, 0x22, 0x37, 0x2c, 0x22, 0x72, 0x73, 0x73, 0x69,
+    0x22, 0x30, 0x2c, 0x22, 0x72, 0x73, 0x73, 0x69, 0x22, 0x38, 0x2c, 0x22,
+    0x72, 0x73, 0x73, 0x69, 0x22, 0x31, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71,
+    0x22, 0x2e, 0x36, 0x2c, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a, 0x2e, 0x30,
+    0x2c, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a, 0x2c, 0x22, 0x74, 0x22, 0x3a,
+    0x31, 0x36, 0x2e, 0x04, 0x00, 0x00, 0x01, 0x01, 0x02, 0x02, 0x17, 0x00,
+    0x03, 0x04, 0x79, 0x6e, 0x63, 0x65, 0x64, 0x3a, 0x20, 0x38, 0x20, 0x73,
+    0x75, 0x62, 0x65, 0x76, 0x65, 0x2c, 0x22, 0x74, 0x22, 0x3a, 0x31, 0x38,
+    0x2e, 0x2e, 0x34, 0x2c, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a, 0x30, 0x22,
+    0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x2e, 0x32, 0x2c, 0x22, 0x62, 0x61,
+    0x74, 0x22, 0x3a, 0x2e, 0x37, 0x2c, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a,
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x02, 0x02, 0xf9, 0x00, 0x03, 0x04, 0x03,
+    0x04, 0x05, 0x00, 0x00, 0x00, 0x04, 0x02, 0x79, 0x6e, 0x63, 0x65, 0x64,
+    0x3a, 0x20, 0x31, 0x36, 0x20, 0x73, 0x75, 0x62, 0x65, 0x76, 0x65, 0x72,
+    0x78, 0x5f, 0x6b, 0x62, 0x70, 0x73, 0x3d, 0x6d, 0x70, 0x73, 0x20, 0x32,
+    0x34, 0x37, 0x2c, 0x20, 0x72, 0x78, 0x20, 0x6d, 0x74, 0x03, 0x04, 0x07,
+    0x00, 0x00, 0x00, 0x04, 0x02, 0x79, 0x6e, 0x63, 0x65, 0x64, 0x3a, 0x20,
+    0x34, 0x20, 0x73, 0x75, 0x62, 0x65, 0x76, 0x65, 0x22, 0x6e, 0x6f, 0x64,
+    0x65, 0x2d, 0x31, 0x34, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x2e,
+    0x39, 0x2c, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a, 0x2e, 0x35, 0x2c, 0x22,
+    0x62, 0x61, 0x74, 0x22, 0x3a, 0x2e, 0x38, 0x2c, 0x22, 0x62, 0x61, 0x74,
+    0x22, 0x3a, 0x00, 0x05, 0x01, 0x04, 0x06, 0x02, 0x00, 0x00, 0x33, 0x22,
+    0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x20, 0x62, 0x61, 0x74, 0x63, 0x68,
+    0x20, 0x38, 0x20, 0x63, 0x72, 0x65, 0x64, 0x69, 0x74, 0x32, 0x22, 0x2c,
+    0x22, 0x73, 0x65, 0x71, 0x22, 0x2e, 0x31, 0x2c, 0x22, 0x62, 0x61, 0x74,
+    0x22, 0x3a, 0x20, 0x62, 0x61, 0x74, 0x63, 0x68, 0x20, 0x34, 0x20, 0x63,
+    0x72, 0x65, 0x64, 0x69, 0x74, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x30,
+    0x35, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x75, 0x62, 0x65, 0x76,
+    0x65, 0x6e, 0x74, 0x73, 0x00, 0x05, 0x01, 0x10, 0x06, 0x02, 0x00, 0x00,
+    0x78, 0x20, 0x6d, 0x74, 0x75, 0x20, 0x32, 0x34, 0x37, 0x20, 0x6d, 0x70,
+    0x73, 0x20, 0x32, 0x20, 0x74, 0x78, 0x5f, 0x6b, 0x62, 0x70, 0x73, 0x3d,
+    0x20, 0x6d, 0x70, 0x73, 0x20, 0x32, 0x35, 0x31, 0x2c, 0x20, 0x72, 0x78,
+    0x20, 0x6d, 0x74, 0x3a, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x32, 0x00,
+    0x05, 0x01, 0x08, 0x06, 0x02, 0x00, 0x00, 0x72, 0x73, 0x73, 0x69, 0x22,
+    0x3a, 0x2d, 0x38, 0x72, 0x73, 0x73, 0x69, 0x22, 0x3a, 0x2d, 0x35, 0x00,
+    0x00, 0x00, 0x04, 0x02, 0x10, 0x00, 0x05, 0x01, 0x00, 0x00, 0x00, 0x04,
+    0x02, 0x08, 0x00, 0x05, 0x01, 0x00, 0x00, 0x00, 0x04, 0x02, 0x04, 0x00,
+    0x05, 0x01, 0x72, 0x73, 0x73, 0x69, 0x22, 0x3a, 0x2d, 0x37, 0x72, 0x73,
+    0x73, 0x69, 0x22, 0x3a, 0x2d, 0x34, 0x2c, 0x22, 0x68, 0x22, 0x3a, 0x33,
+    0x2c, 0x22, 0x68, 0x22, 0x3a, 0x34, 0x72, 0x73, 0x73, 0x69, 0x22, 0x3a,
+    0x2d, 0x36, 0x20, 0x63, 0x72, 0x65, 0x64, 0x69, 0x74, 0x73, 0x20, 0x31,
+    0x36, 0x20, 0x66, 0x65, 0x61, 0x74, 0x75, 0x72, 0x65, 0x73, 0x20, 0x30,
+    0x78, 0x2c, 0x22, 0x68, 0x22, 0x3a, 0x35, 0x3c, 0x77, 0x72, 0x6e, 0x3e,
+    0x20, 0x70, 0x61, 0x77, 0x72, 0x5f, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a,
+    0x33, 0x32, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a, 0x33, 0x31, 0x3c, 0x69,
+    0x6e, 0x66, 0x3e, 0x20, 0x70, 0x61, 0x77, 0x72, 0x5f, 0x63, 0x74, 0x20,
+    0x66, 0x61, 0x69, 0x6c, 0x65, 0x64, 0x20, 0x28, 0x2d, 0x40, 0x01, 0x04,
+    0x00, 0x00, 0x00, 0x01, 0x02, 0x02, 0x22, 0x62, 0x61, 0x74, 0x22, 0x3a,
+    0x33, 0x30, 0x40, 0x01, 0x04, 0x00, 0x00, 0x01, 0x01, 0x02, 0x02, 0x2c,
+    0x22, 0x74, 0x22, 0x3a, 0x32, 0x3e, 0x20, 0x70, 0x61, 0x77, 0x72, 0x5f,
+    0x6e, 0x2c, 0x22, 0x74, 0x22, 0x3a, 0x31, 0x6e, 0x6f, 0x64, 0x65, 0x3a,
+    0x20, 0x73, 0x79, 0x6e, 0x63, 0x65, 0x64, 0x3a, 0x20, 0x2c, 0x22, 0x62,
+    0x61, 0x74, 0x22, 0x3a, 0x32, 0x39, 0x20, 0x74, 0x68, 0x72, 0x6f, 0x75,
+    0x67, 0x68, 0x70, 0x75, 0x74, 0x5f, 0x6b, 0x62, 0x70, 0x73, 0x3d, 0x20,
+    0x70, 0x65, 0x65, 0x72, 0x3a, 0x20, 0x73, 0x65, 0x73, 0x73, 0x69, 0x6f,
+    0x6e, 0x3a, 0x20, 0x6d, 0x74, 0x75, 0x20, 0x2c, 0x22, 0x74, 0x22, 0x3a,
+    0x2c, 0x22, 0x68, 0x22, 0x3a, 0x3a, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d,
+    0x31, 0x3a, 0x22, 0x6e, 0x6f, 0x64, 0x65, 0x2d, 0x30, 0x2c, 0x20, 0x72,
+    0x78, 0x20, 0x6d, 0x74, 0x75, 0x20, 0x32, 0x30, 0x30, 0x30, 0x20, 0x6d,
+    0x70, 0x73, 0x20, 0x32, 0x34, 0x37, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22,
+    0x3a, 0x31, 0x3c, 0x69, 0x6e, 0x66, 0x3e, 0x20, 0x70, 0x65, 0x65, 0x72,
+    0x3a, 0x20, 0x63, 0x68, 0x61, 0x6e, 0x6e, 0x65, 0x6c, 0x20, 0x75, 0x70,
+    0x3a, 0x20, 0x74, 0x78, 0x20, 0x6d, 0x74, 0x75, 0x20, 0x32, 0x2c, 0x22,
+    0x62, 0x61, 0x74, 0x22, 0x3a, 0x33, 0x2c, 0x22, 0x62, 0x61, 0x74, 0x22,
+    0x3a, 0x20, 0x70, 0x61, 0x77, 0x72, 0x5f, 0x6e, 0x6f, 0x64, 0x65, 0x3a,
+    0x20, 0x73, 0x75, 0x62, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x20, 0x73, 0x65,
+    0x6c, 0x65, 0x63, 0x74, 0x20, 0x66, 0x61, 0x69, 0x6c, 0x22, 0x2c, 0x22,
+    0x73, 0x65, 0x71, 0x22, 0x3a, 0x2c, 0x22, 0x72, 0x73, 0x73, 0x69, 0x22,
+    0x3a, 0x2d, 0x7b, 0x22, 0x69, 0x64, 0x22, 0x3a, 0x22, 0x6e, 0x6f, 0x64,
+    0x65, 0x2d,
+};
+
+static const uint16_t head[DICT_HASH_SIZE] = {
+    835, 774, 1001, 646, 991, 626, 449, 315, 943, 775, 1007, 0,
+    884, 0, 706, 0, 918, 145, 876, 833, 905, 515, 0, 0,
+    899, 1011, 935, 692, 941, 609, 976, 644, 629, 0, 1013, 925,
+    983, 747, 266, 0, 752, 636, 867, 0, 809, 854, 0, 965,
+    961, 956, 777, 972, 937, 0, 916, 703, 681, 997, 578, 847,
+    957, 0, 1016, 799, 980, 927, 859, 334, 429, 587, 0, 850,
+    359, 0, 704, 848, 290, 921, 0, 0, 971, 989, 902, 1009,
+    822, 691, 0, 0, 0, 0, 1010, 0, 455, 0, 288, 1017,
+    939, 0, 992, 666, 486, 532, 928, 0, 0, 0, 675, 0,
+    1012, 940, 0, 0, 926, 495, 761, 274, 395, 977, 0, 0,
+    539, 0, 0, 0, 778, 0, 0, 963, 773, 0, 793, 0,
+    931, 1020, 978, 0, 331, 687, 524, 0, 858, 549, 0, 0,
+    785, 1005, 970, 558, 633, 676, 0, 0, 624, 7, 713, 0,
+    517, 0, 0, 0, 897, 990, 958, 1003, 979, 1019, 915, 0,
+    838, 914, 1014, 1004, 448, 0, 0, 0, 960, 0, 1015, 836,
+    254, 0, 137, 0, 901, 0, 810, 0, 1000, 1008, 683, 0,
+    616, 0, 861, 638, 280, 0, 806, 0, 823, 0, 403, 985,
+    986, 564, 917, 0, 839, 0, 877, 0, 729, 975, 966, 904,
+    938, 570, 834, 740, 1018, 0, 404, 360, 987, 962, 1002, 995,
+    860, 920, 988, 0, 887, 820, 964, 0, 696, 973, 784, 0,
+    936, 0, 955, 981, 953, 933, 0, 0, 883, 875, 922, 0,
+    0, 982, 509, 967,
+};
+
+static const uint16_t chain[1022] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 15, 0, 0, 0, 16, 0, 0, 0, 0,
+    0, 0, 0, 17, 18, 6, 0, 0, 22, 0, 0, 25,
+    26, 27, 0, 3, 0, 19, 31, 20, 28, 29, 0, 0,
+    0, 0, 0, 0, 0, 0, 12, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 53, 32, 0, 0, 0, 0, 69,
+    13, 0, 0, 61, 0, 64, 65, 66, 67, 0, 0, 0,
+    79, 72, 73, 74, 75, 76, 0, 0, 0, 0, 0, 44,
+    45, 46, 0, 63, 78, 85, 80, 81, 0, 0, 56, 0,
+    86, 87, 88, 89, 0, 0, 10, 57, 58, 59, 60, 90,
+    0, 39, 0, 98, 70, 0, 55, 0, 0, 108, 109, 0,
+    0, 129, 0, 0, 0, 99, 54, 101, 102, 103, 104, 82,
+    0, 0, 40, 131, 110, 111, 112, 120, 62, 100, 140, 141,
+    142, 143, 144, 0, 0, 92, 148, 149, 150, 151, 152, 77,
+    155, 156, 157, 158, 159, 0, 0, 71, 163, 164, 165, 166,
+    167, 168, 169, 170, 171, 172, 105, 0, 116, 127, 177, 178,
+    179, 180, 181, 0, 0, 128, 189, 117, 118, 119, 195, 96,
+    0, 0, 199, 200, 201, 202, 203, 5, 0, 206, 207, 208,
+    209, 210, 211, 0, 0, 147, 191, 192, 193, 194, 219, 121,
+    0, 162, 107, 125, 126, 190, 198, 134, 139, 204, 0, 214,
+    232, 233, 234, 235, 236, 130, 223, 132, 133, 245, 135, 0,
+    237, 0, 0, 0, 220, 0, 0, 36, 0, 187, 224, 222,
+    226, 0, 91, 225, 0, 84, 8, 0, 255, 0, 0, 250,
+    0, 228, 4, 0, 215, 248, 249, 276, 251, 14, 0, 182,
+    114, 0, 283, 241, 242, 243, 244, 284, 34, 281, 294, 247,
+    263, 268, 265, 227, 278, 300, 176, 306, 292, 293, 299, 295,
+    296, 253, 196, 0, 312, 309, 310, 311, 317, 313, 30, 43,
+    256, 238, 257, 304, 260, 0, 94, 0, 264, 41, 0, 0,
+    0, 297, 326, 97, 124, 0, 0, 267, 302, 269, 270, 271,
+    11, 314, 47, 0, 275, 322, 277, 305, 279, 161, 51, 0,
+    0, 0, 339, 352, 185, 0, 23, 0, 367, 49, 0, 0,
+    106, 338, 318, 0, 374, 0, 333, 122, 335, 261, 369, 273,
+    363, 340, 341, 342, 343, 344, 345, 346, 347, 348, 123, 325,
+    0, 353, 354, 355, 356, 357, 146, 0, 183, 184, 365, 186,
+    173, 379, 321, 246, 308, 301, 391, 303, 328, 401, 258, 48,
+    115, 375, 319, 320, 411, 399, 350, 21, 0, 298, 422, 423,
+    424, 425, 426, 427, 212, 392, 240, 431, 432, 433, 434, 435,
+    0, 336, 33, 213, 229, 138, 37, 38, 390, 393, 230, 413,
+    414, 415, 416, 417, 0, 387, 349, 442, 457, 286, 385, 0,
+    384, 0, 0, 0, 0, 388, 412, 450, 329, 307, 456, 465,
+    458, 459, 460, 418, 327, 0, 421, 440, 441, 464, 443, 444,
+    351, 462, 463, 490, 480, 466, 467, 0, 396, 497, 471, 472,
+    473, 474, 475, 491, 252, 405, 406, 407, 408, 262, 0, 0,
+    381, 479, 502, 481, 482, 483, 446, 516, 400, 484, 402, 0,
+    371, 52, 188, 0, 447, 383, 24, 477, 451, 452, 272, 469,
+    378, 410, 527, 437, 175, 529, 372, 531, 0, 548, 368, 534,
+    370, 493, 500, 0, 83, 361, 362, 499, 364, 512, 337, 0,
+    550, 551, 552, 553, 562, 0, 386, 324, 488, 376, 377, 541,
+    542, 0, 0, 154, 510, 511, 569, 513, 68, 1, 523, 533,
+    575, 35, 536, 537, 538, 579, 519, 217, 218, 522, 598, 520,
+    461, 153, 595, 596, 597, 599, 606, 600, 0, 544, 589, 560,
+    571, 494, 501, 9, 428, 588, 563, 95, 612, 613, 614, 42,
+    621, 617, 618, 619, 620, 625, 622, 623, 323, 572, 584, 627,
+    559, 0, 604, 605, 607, 641, 608, 557, 503, 380, 639, 640,
+    642, 649, 643, 577, 438, 291, 514, 632, 259, 216, 0, 656,
+    655, 660, 657, 546, 545, 470, 647, 648, 650, 669, 651, 526,
+    586, 658, 645, 504, 505, 506, 507, 397, 468, 0, 436, 554,
+    535, 0, 0, 582, 0, 0, 686, 160, 565, 0, 661, 205,
+    439, 695, 662, 663, 583, 197, 0, 0, 672, 0, 601, 684,
+    0, 50, 221, 0, 358, 665, 489, 496, 508, 492, 674, 711,
+    0, 591, 715, 716, 717, 718, 719, 678, 702, 330, 685, 0,
+    287, 707, 708, 709, 710, 720, 712, 0, 0, 540, 389, 682,
+    285, 631, 0, 0, 611, 628, 576, 0, 745, 677, 630, 615,
+    755, 485, 670, 722, 594, 760, 723, 724, 725, 726, 727, 574,
+    749, 758, 754, 757, 756, 770, 419, 700, 762, 478, 518, 282,
+    654, 766, 765, 0, 445, 735, 736, 737, 738, 739, 0, 679,
+    231, 780, 781, 782, 753, 731, 0, 688, 701, 714, 694, 453,
+    787, 0, 804, 671, 653, 454, 394, 239, 697, 573, 763, 764,
+    783, 796, 817, 728, 750, 316, 0, 476, 136, 0, 790, 498,
+    592, 689, 800, 581, 530, 637, 772, 561, 801, 821, 829, 366,
+    826, 585, 759, 786, 807, 0, 0, 0, 668, 382, 732, 818,
+    673, 2, 652, 543, 610, 741, 813, 794, 795, 852, 792, 779,
+    698, 699, 776, 862, 824, 580, 832, 831, 837, 635, 409, 602,
+    721, 870, 871, 872, 873, 874, 865, 771, 593, 814, 768, 769,
+    751, 855, 856, 857, 802, 888, 828, 844, 894, 889, 693, 566,
+    567, 568, 664, 547, 373, 819, 603, 808, 521, 843, 910, 797,
+    659, 730, 798, 851, 733, 734, 896, 840, 841, 842, 911, 919,
+    332, 811, 93, 590, 878, 525, 289, 742, 830, 556, 174, 895,
+    555, 934, 634, 898, 890, 891, 892, 893, 863, 864, 886, 815,
+    816, 906, 868, 767, 913, 866, 947, 948, 949, 950, 951, 924,
+    853, 805, 788, 789, 827, 791, 825, 880, 881, 944, 803, 845,
+    398, 959, 930, 705, 942, 528, 903, 885, 680, 846, 420, 969,
+    0, 748, 932, 743, 744, 912, 746, 487, 945, 946, 907, 908,
+    909, 923, 998, 993, 994, 430, 952, 667, 849, 999, 1006, 996,
+    900, 690, 113, 812, 954, 974, 869, 929, 879, 968, 984, 882,
+    0, 0,
+};
+
+const struct dict dict_builtin = {
+    .id = 0x7532,
+    .size = 1022U,
+    .data = data,
+    .head = head,
+    .chain = chain,
+};
@@ -0,0 +1,111 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include "frame.h"
+
+BUILD_ASSERT(FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD <= CONFIG_APP_PKT_SIZE,
+             "a full frame must fit in one packet buffer");
+
+void frame_put_hdr(uint8_t *dst, const struct frame_hdr *hdr)
+{
+    dst[0] = FRAME_SYNC;
+    dst[1] = hdr->chan;
+    dst[2] = hdr->type;
+    sys_put_le16(hdr->len, &dst[3]);
+}
+
+int frame_get_hdr(const uint8_t *src, size_t len, struct frame_hdr *hdr)
+{
+    if (len > 0 && src[0] != FRAME_SYNC) {
+        return -EBADMSG;
+    }
+
+    if (len < FRAME_HDR_SIZE) {
+        return -EAGAIN;
+    }
+
+    hdr->chan = src[1];
+    hdr->type = src[2];
+    hdr->len = sys_get_le16(&src[3]);
+
+    if (hdr->type >= FRAME_TYPE_COUNT ||
+        hdr->len > CONFIG_APP_FRAME_MAX_PAYLOAD) {
+        return -EBADMSG;
+    }
+
+    return 0;
+}
+
+void frame_decoder_init(struct frame_decoder *dec, frame_cb_t cb, void *user)
+{
+    dec->cb = cb;
+    dec->user = user;
+    dec->fill = 0;
+    dec->dropped = 0;
+}
+
+/* Drop the first byte of a bad header and rescan what follows it. */
+static void frame_resync(struct frame_decoder *dec)
+{
+    const uint8_t *sync = memchr(&dec->buf[1], FRAME_SYNC, dec->fill - 1);
+    size_t skip = sync != NULL ? (size_t)(sync - dec->buf) : dec->fill;
+
+    dec->dropped += skip;
+    dec->fill -= skip;
+    memmove(dec->buf, &dec->buf[skip], dec->fill);
+}
+
+void frame_decode(struct frame_decoder *dec, const uint8_t *data, size_t len)
+{
+    struct frame_hdr hdr;
+
+    /* Every pass consumes input, completes a frame or drops a byte. */
+    while (true) {
+        size_t want;
+        size_t n;
+        int err;
+
+        if (dec->fill == 0) {
+            const uint8_t *sync;
+
+            if (len == 0) {
+                return;
+            }
+
+            sync = memchr(data, FRAME_SYNC, len);
+            if (sync == NULL) {
+                dec->dropped += len;
+                return;
+            }
+
+            dec->dropped += (size_t)(sync - data);
+            len -= (size_t)(sync - data);
+            data = sync;
+        }
+
+        err = frame_get_hdr(dec->buf, dec->fill, &hdr);
+        if (err == -EBADMSG) {
+            frame_resync(dec);
+            continue;
+        }
+
+        want = err == 0 ? FRAME_HDR_SIZE + hdr.len : FRAME_HDR_SIZE;
+
+        if (dec->fill == want && err == 0) {
+            dec->fill = 0;
+            dec->cb(dec->user, &hdr, &dec->buf[FRAME_HDR_SIZE]);
+            continue;
+        }
+
+        if (len == 0) {
+            return;
+        }
+
+        n = MIN(len, want - dec->fill);
+        memcpy(&dec->buf[dec->fill], data, n);
+        dec->fill += n;
+        data += n;
+        len -= n;
+    }
+}
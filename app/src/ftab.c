@@ -0,0 +1,132 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+#include "ftab.h"
+
+void ftab_get_hdr(const uint8_t *src, struct ftab_hdr *hdr)
+{
+    hdr->magic = sys_get_le32(&src[0]);
+    hdr->seq = sys_get_le32(&src[4]);
+    hdr->len = sys_get_le32(&src[8]);
+    hdr->crc = sys_get_le32(&src[12]);
+}
+
+void ftab_put_hdr(uint8_t *dst, const struct ftab_hdr *hdr)
+{
+    sys_put_le32(hdr->magic, &dst[0]);
+    sys_put_le32(hdr->seq, &dst[4]);
+    sys_put_le32(hdr->len, &dst[8]);
+    sys_put_le32(hdr->crc, &dst[12]);
+}
+
+uint32_t ftab_crc(const struct ftab_hdr *hdr, const uint8_t *body)
+{
+    uint8_t head[FTAB_HDR_SIZE];
+
+    ftab_put_hdr(head, hdr);
+
+    return crc32_ieee_update(crc32_ieee(head, 12U), body, hdr->len - FTAB_HDR_SIZE);
+}
+
+int ftab_check(const uint8_t *slot, size_t size, struct ftab_hdr *hdr)
+{
+    size_t dir_end;
+    uint16_t count;
+
+    if (size < FTAB_HDR_SIZE) {
+        return -ENOENT;
+    }
+
+    ftab_get_hdr(slot, hdr);
+    if (hdr->magic != FTAB_MAGIC) {
+        return -ENOENT;
+    }
+
+    if (hdr->len < FTAB_HDR_SIZE + FTAB_DIR_SIZE || hdr->len > size ||
+        ftab_crc(hdr, &slot[FTAB_HDR_SIZE]) != hdr->crc) {
+        return -EBADMSG;
+    }
+
+    count = sys_get_le16(&slot[FTAB_HDR_SIZE]);
+    dir_end = FTAB_HDR_SIZE + FTAB_DIR_SIZE + (size_t)count * FTAB_ENTRY_SIZE;
+    if (dir_end > hdr->len) {
+        return -EBADMSG;
+    }
+
+    /* Once checked, ftab_find() can trust the directory. */
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *e = &slot[FTAB_HDR_SIZE + FTAB_DIR_SIZE + i * FTAB_ENTRY_SIZE];
+        uint32_t off = sys_get_le32(&e[4]);
+        uint32_t len = sys_get_le32(&e[8]);
+
+        if (off % FTAB_ALIGN != 0 || off < dir_end || off > hdr->len ||
+            len > hdr->len - off) {
+            return -EBADMSG;
+        }
+    }
+
+    return 0;
+}
+
+int ftab_pick(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    const uint8_t *slot[2] = { a, b };
+    struct ftab_hdr ha;
+    struct ftab_hdr hb;
+    int newer = 0;
+
+    if (size < FTAB_HDR_SIZE) {
+        return -ENOENT;
+    }
+
+    /*
+     * The crc is most of the boot cost, so check the newer slot first
+     * (seq may wrap) and the older one only if that fails.
+     */
+    ftab_get_hdr(a, &ha);
+    ftab_get_hdr(b, &hb);
+    if (hb.magic == FTAB_MAGIC &&
+        (ha.magic != FTAB_MAGIC || (int32_t)(hb.seq - ha.seq) > 0)) {
+        newer = 1;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        int idx = newer ^ i;
+
+        if (ftab_check(slot[idx], size, &ha) == 0) {
+            return idx;
+        }
+    }
+
+    return -ENOENT;
+}
+
+const uint8_t *ftab_find(const uint8_t *img, uint16_t id, size_t *len)
+{
+    uint16_t count = sys_get_le16(&img[FTAB_HDR_SIZE]);
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *e = &img[FTAB_HDR_SIZE + FTAB_DIR_SIZE + i * FTAB_ENTRY_SIZE];
+
+        if (sys_get_le16(e) == id) {
+            *len = sys_get_le32(&e[8]);
+            return &img[sys_get_le32(&e[4])];
+        }
+    }
+
+    return NULL;
+}
+
+bool ftab_peer_listed(const uint8_t *tab, size_t len, uint8_t type,
+                      const uint8_t addr[6])
+{
+    for (size_t pos = 0; pos + FTAB_PEER_SIZE <= len; pos += FTAB_PEER_SIZE) {
+        if (tab[pos] == type && memcmp(&tab[pos + 1U], addr, 6) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,325 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#if defined(CONFIG_FLASH_SIMULATOR)
+#include <zephyr/drivers/flash/flash_simulator.h>
+#endif
+#include "agg.h"
+#include "ctrl.h"
+#include "cycles.h"
+#include "dict.h"
+#include "ftab.h"
+#include "stats.h"
+
+LOG_MODULE_REGISTER(ftab, LOG_LEVEL_INF);
+
+#define FTAB_CHUNK_MAX ROUND_UP(UINT8_MAX, FTAB_ALIGN)
+
+static const uint8_t slot_ids[2] = {
+    FIXED_PARTITION_ID(tables_a_partition),
+    FIXED_PARTITION_ID(tables_b_partition),
+};
+
+/* The image in use, fixed at boot. */
+static const uint8_t *image;
+static uint32_t image_seq;
+static int image_slot = -ENOENT;
+
+/* An update of the other slot. The header is kept back until commit. */
+static struct {
+    const struct flash_area *fa;
+    uint8_t hdr[FTAB_HDR_SIZE];
+    uint32_t len;
+    uint32_t next;
+} upd;
+
+static struct {
+    uint8_t op;
+    int8_t status;
+} reply;
+
+#if defined(CONFIG_APP_DICT)
+static struct dict table_dict;
+#endif
+
+/* Where the slot shows up in the address space. */
+static const uint8_t *slot_map(const struct flash_area *fa)
+{
+#if defined(CONFIG_FLASH_SIMULATOR)
+    size_t size;
+
+    return (const uint8_t *)flash_simulator_get_memory(flash_area_get_device(fa), &size) +
+           fa->fa_off;
+#else
+    return (const uint8_t *)(CONFIG_FLASH_BASE_ADDRESS + fa->fa_off);
+#endif
+}
+
+const uint8_t *ftab_get(uint16_t id, size_t *len)
+{
+    return image != NULL ? ftab_find(image, id, len) : NULL;
+}
+
+/* Hand the tables that have a consumer to it. Returns bytes used in place. */
+static size_t ftab_apply(void)
+{
+    const uint8_t *tab;
+    size_t in_place = 0;
+    size_t len;
+
+    tab = ftab_get(FTAB_AGG_RULES, &len);
+    if (IS_ENABLED(CONFIG_APP_AGG) && tab != NULL) {
+        int n = agg_load_rules(tab, len);
+
+        if (n < 0) {
+            LOG_WRN("aggregation rules rejected (%d)", n);
+        }
+    }
+
+    tab = ftab_get(FTAB_PEERS, &len);
+    if (tab != NULL) {
+        in_place += len;
+    }
+
+#if defined(CONFIG_APP_DICT)
+    tab = ftab_get(FTAB_DICT, &len);
+    if (tab != NULL) {
+        if (dict_from_table(tab, len, &table_dict) == 0) {
+            dict_use(&table_dict);
+            in_place += len;
+        } else {
+            LOG_WRN("dictionary table rejected");
+        }
+    }
+#endif
+
+    return in_place;
+}
+
+static int ftab_init(void)
+{
+    const struct flash_area *fa[2];
+    uint32_t start;
+    uint32_t checked;
+    struct ftab_hdr hdr;
+    size_t in_place;
+    size_t size;
+
+    cycles_init();
+    start = (uint32_t)cycles_now();
+
+    if (flash_area_open(slot_ids[0], &fa[0]) != 0 ||
+        flash_area_open(slot_ids[1], &fa[1]) != 0) {
+        LOG_ERR("no table partitions");
+        return 0;
+    }
+
+    size = MIN(fa[0]->fa_size, fa[1]->fa_size);
+    image_slot = ftab_pick(slot_map(fa[0]), slot_map(fa[1]), size);
+    checked = (uint32_t)cycles_now() - start;
+
+    if (image_slot < 0) {
+        LOG_INF("tables: none");
+        return 0;
+    }
+
+    image = slot_map(fa[image_slot]);
+    ftab_get_hdr(image, &hdr);
+    image_seq = hdr.seq;
+
+    in_place = ftab_apply();
+
+    LOG_INF("tables: slot %c seq %u, %u tables, %u bytes used in place, "
+            "checked in %u cycles, applied in %u", 'A' + image_slot, hdr.seq,
+            sys_get_le16(&image[FTAB_HDR_SIZE]), (uint32_t)in_place, checked,
+            (uint32_t)cycles_now() - start - checked);
+
+    return 0;
+}
+
+/* Before the links come up, so they negotiate the table dictionary. */
+SYS_INIT(ftab_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+static size_t ftab_fill_reply(uint8_t *dst, size_t cap)
+{
+    if (cap < 6U) {
+        return 0;
+    }
+
+    dst[0] = reply.op;
+    dst[1] = (uint8_t)reply.status;
+    sys_put_le32(image_seq, &dst[2]);
+
+    return 6U;
+}
+
+struct ftab_args {
+    uint32_t len;
+    uint32_t offset;
+    const uint8_t *data;
+    uint8_t data_len;
+};
+
+static int ftab_parse_tlv(void *user, const struct ctrl_tlv *tlv)
+{
+    struct ftab_args *args = user;
+
+    switch (tlv->tag) {
+    case FTAB_TAG_LEN:
+        if (tlv->len == 4U) {
+            args->len = sys_get_le32(tlv->value);
+        }
+        break;
+    case FTAB_TAG_OFFSET:
+        if (tlv->len == 4U) {
+            args->offset = sys_get_le32(tlv->value);
+        }
+        break;
+    case FTAB_TAG_DATA:
+        args->data = tlv->value;
+        args->data_len = tlv->len;
+        break;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+static int ftab_begin(const struct ftab_args *args)
+{
+    int err;
+
+    /* Never the slot in use; with none, A. */
+    err = flash_area_open(slot_ids[image_slot == 0 ? 1 : 0], &upd.fa);
+    if (err != 0) {
+        return err;
+    }
+
+    if (args->len < FTAB_HDR_SIZE + FTAB_DIR_SIZE || args->len > upd.fa->fa_size) {
+        upd.fa = NULL;
+        return -EFBIG;
+    }
+
+    err = flash_area_erase(upd.fa, 0, upd.fa->fa_size);
+    if (err != 0) {
+        upd.fa = NULL;
+        return err;
+    }
+
+    upd.len = args->len;
+    upd.next = 0;
+
+    return 0;
+}
+
+static int ftab_write(const struct ftab_args *args)
+{
+    uint8_t chunk[FTAB_CHUNK_MAX] __aligned(4);
+    uint32_t off = args->offset;
+    size_t n = args->data_len;
+    const uint8_t *data = args->data;
+    int err;
+
+    if (upd.fa == NULL || off != upd.next || n == 0 || n > upd.len - off ||
+        (n % FTAB_ALIGN != 0 && off + n != upd.len)) {
+        return -EINVAL;
+    }
+
+    if (off < FTAB_HDR_SIZE) {
+        size_t head = MIN(n, FTAB_HDR_SIZE - off);
+
+        memcpy(&upd.hdr[off], data, head);
+        off += head;
+        data += head;
+        n -= head;
+    }
+
+    if (n > 0) {
+        /* Pad the tail to whole flash words. */
+        memcpy(chunk, data, n);
+        memset(&chunk[n], 0xFF, ROUND_UP(n, FTAB_ALIGN) - n);
+
+        err = flash_area_write(upd.fa, off, chunk, ROUND_UP(n, FTAB_ALIGN));
+        if (err != 0) {
+            return err;
+        }
+    }
+
+    upd.next += args->data_len;
+
+    return 0;
+}
+
+static int ftab_commit(void)
+{
+    const uint8_t *slot;
+    struct ftab_hdr hdr;
+    struct ftab_hdr check;
+    int err;
+
+    if (upd.fa == NULL || upd.next != upd.len) {
+        return -EINVAL;
+    }
+
+    ftab_get_hdr(upd.hdr, &hdr);
+    slot = slot_map(upd.fa);
+
+    /* It must win over the image in use at the next boot. */
+    if (hdr.magic != FTAB_MAGIC || hdr.len != upd.len ||
+        (image != NULL && (int32_t)(hdr.seq - image_seq) <= 0) ||
+        ftab_crc(&hdr, &slot[FTAB_HDR_SIZE]) != hdr.crc) {
+        return -EBADMSG;
+    }
+
+    err = flash_area_write(upd.fa, 0, upd.hdr, FTAB_HDR_SIZE);
+    if (err != 0) {
+        return err;
+    }
+
+    err = ftab_check(slot, upd.fa->fa_size, &check);
+    upd.fa = NULL;
+    if (err != 0) {
+        return err;
+    }
+
+    LOG_INF("tables: seq %u written, in use after reboot", hdr.seq);
+
+    return 0;
+}
+
+int ftab_handle_ctrl(const uint8_t *payload, size_t len)
+{
+    struct ftab_args args = { 0 };
+    uint8_t op;
+    int err;
+
+    err = ctrl_parse(payload, len, &op, ftab_parse_tlv, &args);
+    if (err != 0) {
+        return err;
+    }
+
+    switch (op) {
+    case FTAB_OP_BEGIN:
+        err = ftab_begin(&args);
+        break;
+    case FTAB_OP_WRITE:
+        err = ftab_write(&args);
+        break;
+    case FTAB_OP_COMMIT:
+        err = ftab_commit();
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    reply.op = op;
+    reply.status = (int8_t)err;
+    (void)stats_send(STATS_REC_FTAB, ftab_fill_reply);
+
+    return err;
+}
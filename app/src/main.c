@@ -1,16 +1,455 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
-#include <stdio.h>
+#include "agg.h"
+#include "bt_central.h"
+#include "bt_relay.h"
+#include "caps.h"
+#include "credit.h"
+#include "dict.h"
+#include "frame.h"
+#include "ftab.h"
+#include "pawr.h"
+#include "pkt_pool.h"
+#include "pressure.h"
+#include "stats.h"
 #include "sum.h"
+#include "transport.h"
+#include "worker.h"
 
 LOG_MODULE_REGISTER(app);
 
+static const struct transport *host;
+static struct frame_decoder host_decoder;
+static struct caps host_session;
+static bool host_negotiated;
+
+#if defined(CONFIG_APP_BT_CENTRAL)
+#define HOST_LINKS CONFIG_BT_MAX_CONN
+#else
+#define HOST_LINKS 1
+#endif
+
+/*
+ * Credits for host data frames, one window per link channel. Under pool
+ * pressure the window shrinks to what the level allows, and credits short
+ * of a batch go back after its coalescing time.
+ */
+static struct credit_rx host_credits[HOST_LINKS];
+static struct k_spinlock host_credit_lock;
+
+/* Not the coalescing time, which is nil when buffers are scarcest. */
+#define HOST_CREDIT_RETRY K_MSEC(1)
+
+static void host_credit_flush(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(host_credit_work, host_credit_flush);
+
+/* No more in flight on a link channel than the peer on the link grants either. */
+static uint8_t host_window(size_t chan)
+{
+    uint8_t window = host_session.credits;
+
+    if (IS_ENABLED(CONFIG_APP_BT_CENTRAL)) {
+        window = MIN(window, bt_central_link_credits(chan));
+    }
+    if (IS_ENABLED(CONFIG_APP_PRESSURE)) {
+        window = MIN(window, pressure_policy()->credits);
+    }
+
+    return window;
+}
+
+static k_timeout_t host_coalesce(void)
+{
+    if (!IS_ENABLED(CONFIG_APP_PRESSURE)) {
+        return K_USEC(CONFIG_APP_COALESCE_US);
+    }
+
+    return K_USEC(pressure_policy()->coalesce_us);
+}
+
+static void host_grant(uint8_t chan, uint8_t count)
+{
+    struct frame_hdr hdr = { .chan = chan, .type = FRAME_CREDIT, .len = 1 };
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+    k_spinlock_key_t key;
+
+    /* Taken back for the next flush rather than lost to the window. */
+    if (buf == NULL) {
+        key = k_spin_lock(&host_credit_lock);
+        host_credits[chan].out -= count;
+        k_spin_unlock(&host_credit_lock, key);
+        k_work_schedule(&host_credit_work, HOST_CREDIT_RETRY);
+        return;
+    }
+
+    frame_put_hdr(net_buf_add(buf, FRAME_HDR_SIZE), &hdr);
+    net_buf_add_u8(buf, count);
+    (void)host->send(buf);
+}
+
+/* Send back what each channel has short of a batch, up to the current window. */
+static void host_credit_flush(struct k_work *work)
+{
+    k_spinlock_key_t key;
+    uint8_t grant;
+
+    ARG_UNUSED(work);
+
+    for (size_t i = 0; host_negotiated && i < ARRAY_SIZE(host_credits); i++) {
+        key = k_spin_lock(&host_credit_lock);
+        credit_rx_set_window(&host_credits[i], host_window(i));
+        grant = credit_rx_flush(&host_credits[i]);
+        k_spin_unlock(&host_credit_lock, key);
+
+        if (grant > 0) {
+            host_grant(i, grant);
+        }
+    }
+}
+
+/* A data frame from the host on chan is done with; its credit goes back in batches. */
+static void host_consumed(uint8_t chan)
+{
+    k_spinlock_key_t key;
+    uint8_t grant;
+
+    if (!host_negotiated || chan >= ARRAY_SIZE(host_credits)) {
+        return;
+    }
+
+    key = k_spin_lock(&host_credit_lock);
+    credit_rx_set_window(&host_credits[chan], host_window(chan));
+    grant = credit_rx_consumed(&host_credits[chan]);
+    k_spin_unlock(&host_credit_lock, key);
+
+    if (grant > 0) {
+        host_grant(chan, grant);
+    } else {
+        /* Left alone if already due, so no credit waits longer than that. */
+        k_work_schedule(&host_credit_work, host_coalesce());
+    }
+}
+
+/*
+ * On the way down a larger window opens, which a sender holding no
+ * credits would otherwise never see. Called from pool context.
+ */
+static void pressure_changed(enum pressure_level from, enum pressure_level to,
+                             const struct pressure_policy *policy)
+{
+    ARG_UNUSED(policy);
+
+    if (to < from) {
+        k_work_reschedule(&host_credit_work, K_NO_WAIT);
+    }
+}
+
+/*
+ * Frames to the host that are larger than it accepts are dropped. Before
+ * a hello there is no limit, as older hosts do not send one.
+ */
+static int host_send_frame(struct net_buf *buf)
+{
+    if (host_negotiated && buf->len > host_session.mtu) {
+        net_buf_unref(buf);
+        return -EMSGSIZE;
+    }
+
+    return host->send(buf);
+}
+
+/*
+ * Answer a host hello with ours and settle the session settings. Then
+ * open the negotiated credit window on each link channel.
+ */
+static void host_hello(uint8_t chan, const uint8_t *payload, size_t len)
+{
+    struct caps local;
+    struct caps remote;
+    struct net_buf *buf;
+
+    if (caps_parse_hello(payload, len, &remote) != 0) {
+        return;
+    }
+
+    caps_init(&local);
+    local.mtu = FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD;
+    /* Half the pool in flight is where the pressure controller steps in. */
+    local.batch = CONFIG_APP_PKT_COUNT / 2;
+    local.credits = CONFIG_APP_CREDITS;
+    /* Only as what the host can expand; it sends plain frames. */
+    if (IS_ENABLED(CONFIG_APP_DICT)) {
+        local.features |= CAPS_F_COMPRESSION;
+        local.dict = dict_active()->id;
+    }
+
+    host_negotiated = caps_select(&local, &remote, &host_session) == 0;
+    if (!host_negotiated) {
+        LOG_WRN("host protocol %08x not supported", remote.version);
+        caps_init(&host_session);
+    } else {
+        LOG_INF("host session: mtu %u batch %u credits %u features 0x%x",
+                host_session.mtu, host_session.batch, host_session.credits,
+                host_session.features);
+    }
+
+    if (IS_ENABLED(CONFIG_APP_BT_CENTRAL)) {
+        bt_central_set_host_dict(host_negotiated &&
+                                 (host_session.features & CAPS_F_COMPRESSION) != 0);
+    }
+
+    buf = pkt_alloc(K_NO_WAIT);
+    if (buf == NULL) {
+        return;
+    }
+
+    if (caps_add_hello(buf, chan, &local) != 0) {
+        net_buf_unref(buf);
+        return;
+    }
+
+    (void)host->send(buf);
+
+    for (size_t i = 0; host_negotiated && i < ARRAY_SIZE(host_credits); i++) {
+        k_spinlock_key_t key = k_spin_lock(&host_credit_lock);
+        uint8_t window = host_window(i);
+
+        credit_rx_init(&host_credits[i], window);
+        k_spin_unlock(&host_credit_lock, key);
+        host_grant(i, window);
+    }
+}
+
+/*
+ * Send a data frame to the peer on the link its channel names, reduced
+ * by the channel's aggregation stage first. Takes ownership of buf.
+ */
+static void link_send(struct net_buf *buf, struct frame_hdr *hdr)
+{
+    if (IS_ENABLED(CONFIG_APP_AGG)) {
+        net_buf_pull(buf, FRAME_HDR_SIZE);
+        agg_channel_apply(hdr->chan, buf);
+
+        /* Nothing until a window completes. */
+        if (buf->len == 0) {
+            net_buf_unref(buf);
+            return;
+        }
+
+        hdr->len = buf->len;
+        frame_put_hdr(net_buf_push(buf, FRAME_HDR_SIZE), hdr);
+    }
+
+    (void)bt_central_send(hdr->chan, buf);
+}
+
+/* Data frames on a link's channel go to the peer on that link. */
+static void host_data(const struct frame_hdr *hdr, const uint8_t *payload)
+{
+    struct frame_hdr out = *hdr;
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    host_consumed(hdr->chan);
+
+    if (buf == NULL) {
+        stats_add(STATS_RX_DROPPED_BYTES, FRAME_HDR_SIZE + hdr->len);
+        return;
+    }
+
+    frame_put_hdr(net_buf_add(buf, FRAME_HDR_SIZE), hdr);
+    net_buf_add_mem(buf, payload, hdr->len);
+    link_send(buf, &out);
+}
+
+static void host_frame(void *user, const struct frame_hdr *hdr,
+                       const uint8_t *payload)
+{
+    ARG_UNUSED(user);
+
+    stats_add(STATS_FRAMES_RX, 1);
+
+    if (IS_ENABLED(CONFIG_APP_BT_CENTRAL) && hdr->type == FRAME_DATA) {
+        host_data(hdr, payload);
+        return;
+    }
+
+    if (hdr->type == FRAME_CTRL && hdr->len > 0 && payload[0] == CAPS_OP_HELLO) {
+        host_hello(hdr->chan, payload, hdr->len);
+        return;
+    }
+
+    if (hdr->chan == CONFIG_APP_STATS_CHAN && hdr->type == FRAME_CTRL) {
+        if (IS_ENABLED(CONFIG_APP_FTAB) && hdr->len > 0 &&
+            payload[0] >= FTAB_OP_BEGIN && payload[0] <= FTAB_OP_COMMIT) {
+            (void)ftab_handle_ctrl(payload, hdr->len);
+            return;
+        }
+
+        (void)stats_handle_ctrl(payload, hdr->len);
+    }
+}
+
+/*
+ * A transfer holding exactly one data frame, with no earlier frame left
+ * half decoded, goes to its link in the buffer it arrived in.
+ */
+static bool host_pass(struct net_buf *buf)
+{
+    struct frame_hdr hdr;
+
+    if (!IS_ENABLED(CONFIG_APP_BT_CENTRAL) || host_decoder.fill != 0 ||
+        frame_get_hdr(buf->data, buf->len, &hdr) != 0 || hdr.type != FRAME_DATA ||
+        buf->len != FRAME_HDR_SIZE + hdr.len) {
+        return false;
+    }
+
+    stats_add(STATS_FRAMES_RX, 1);
+    host_consumed(hdr.chan);
+    link_send(buf, &hdr);
+
+    return true;
+}
+
+/* Decode one transfer from the host and give its buffer back. */
+static void host_rx(struct net_buf *buf)
+{
+    uint32_t dropped = host_decoder.dropped;
+
+    if (host_pass(buf)) {
+        /* The link owns the buffer now; only let the transport go on. */
+        host->release(NULL);
+        return;
+    }
+
+    frame_decode(&host_decoder, buf->data, buf->len);
+    stats_add(STATS_RX_DROPPED_BYTES, host_decoder.dropped - dropped);
+    host->release(buf);
+}
+
+#if defined(CONFIG_APP_WORKERS)
+K_THREAD_STACK_DEFINE(host_stack, CONFIG_APP_WORKER_STACK_SIZE);
+K_THREAD_STACK_DEFINE(peer_stack, CONFIG_APP_WORKER_STACK_SIZE);
+
+static struct worker host_worker;
+static struct worker peer_worker;
+
+static void host_work(void *ctx, struct net_buf *buf)
+{
+    ARG_UNUSED(ctx);
+
+    host_rx(buf);
+}
+
+static void peer_work(void *ctx, struct net_buf *buf)
+{
+    ARG_UNUSED(ctx);
+
+    (void)host_send_frame(buf);
+}
+
+static void host_submit(struct net_buf *buf)
+{
+    worker_submit(&host_worker, buf, CONFIG_APP_WORKER_HOST_BUDGET_US);
+}
+
+static int peer_submit(struct net_buf *buf)
+{
+    worker_submit(&peer_worker, buf, CONFIG_APP_WORKER_PEER_BUDGET_US);
+
+    return 0;
+}
+
+static void workers_start(void)
+{
+    bool edf = IS_ENABLED(CONFIG_APP_WORKERS_EDF);
+
+    /* Under EDF the priority only ranks the workers against other threads. */
+    worker_start(&host_worker, host_stack, K_THREAD_STACK_SIZEOF(host_stack),
+                 CONFIG_APP_WORKER_PRIO, edf, host_work, NULL, "host_worker");
+    worker_start(&peer_worker, peer_stack, K_THREAD_STACK_SIZEOF(peer_stack),
+                 edf ? CONFIG_APP_WORKER_PRIO : CONFIG_APP_WORKER_PEER_PRIO, edf, peer_work,
+                 NULL, "peer_worker");
+}
+#else
+static void host_submit(struct net_buf *buf)
+{
+    host_rx(buf);
+}
+
+static int peer_submit(struct net_buf *buf)
+{
+    return host_send_frame(buf);
+}
+
+static void workers_start(void)
+{
+}
+#endif
+
+/* A frame to a peer gave its buffer back, which the host link may be waiting for. */
+static void peer_sent(void)
+{
+    host->release(NULL);
+}
+
+/* The link to the host this build bridges over, if any. */
+static const struct transport *host_transport(void)
+{
+    if (IS_ENABLED(CONFIG_APP_UART_BRIDGE)) {
+        return &uart_transport;
+    }
+    if (IS_ENABLED(CONFIG_APP_SPI_BRIDGE)) {
+        return &spi_transport;
+    }
+    if (IS_ENABLED(CONFIG_APP_USB_BRIDGE)) {
+        return &usb_transport;
+    }
+
+    return NULL;
+}
+
 int main(void)
 {
     LOG_INF("Hello, Zephyr");
 
-    printf("2 + 3 = %d\n", add(2, 3));
+    printk("2 + 3 = %d\n", add(2, 3));
+
+    if (IS_ENABLED(CONFIG_APP_RELAY)) {
+        /* Frames go from link to link; there is no host to bridge to. */
+        (void)bt_relay_start();
+        return 0;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_PRESSURE)) {
+        pressure_init(pressure_changed);
+    }
+
+    host = host_transport();
+    if (host != NULL) {
+        if (host->init() != 0) {
+            return 0;
+        }
+
+        LOG_INF("bridging over %s", host->name);
+        stats_set_sink(host->send);
+        frame_decoder_init(&host_decoder, host_frame, NULL);
+        workers_start();
+
+        if (IS_ENABLED(CONFIG_APP_BT_CENTRAL)) {
+            /* Peer frames go to the host in the buffers they arrived in. */
+            bt_central_set_sink(peer_submit);
+            bt_central_set_sent(peer_sent);
+            (void)bt_central_start();
+        }
+        if (IS_ENABLED(CONFIG_APP_PAWR)) {
+            /* Responses go out on the stats channel, so after its sink. */
+            (void)pawr_start();
+        }
+
+        while (true) {
+            host_submit(host->recv(K_FOREVER));
+        }
+    }
 
     return 0;
 }
-
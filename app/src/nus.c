@@ -0,0 +1,95 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include "nus.h"
+
+/* ATT notification and write headers: opcode and handle. */
+#define ATT_HDR_SIZE 3U
+
+void nus_packer_init(struct nus_packer *p, nus_flush_t flush, void *user)
+{
+    p->flush = flush;
+    p->user = user;
+    p->len = 0;
+    nus_packer_set_mtu(p, 23);
+}
+
+void nus_packer_set_mtu(struct nus_packer *p, uint16_t att_mtu)
+{
+    p->cap = (uint16_t)CLAMP(att_mtu - (int)ATT_HDR_SIZE, 1, (int)NUS_PACKET_MAX);
+}
+
+int nus_packer_flush(struct nus_packer *p)
+{
+    int err;
+
+    if (p->len == 0) {
+        return 0;
+    }
+
+    err = p->flush(p->user, p->buf, p->len);
+    if (err == 0) {
+        p->len = 0;
+    }
+
+    return err;
+}
+
+size_t nus_packer_write(struct nus_packer *p, const uint8_t *data, size_t len)
+{
+    size_t taken = 0;
+
+    while (taken < len) {
+        size_t chunk;
+
+        if (p->len >= p->cap && nus_packer_flush(p) != 0) {
+            break;
+        }
+
+        chunk = MIN(len - taken, (size_t)(p->cap - p->len));
+        memcpy(&p->buf[p->len], &data[taken], chunk);
+        p->len += (uint16_t)chunk;
+        taken += chunk;
+    }
+
+    /* Send a full packet now rather than on the next write. */
+    if (p->len >= p->cap) {
+        (void)nus_packer_flush(p);
+    }
+
+    return taken;
+}
+
+void nus_tx_init(struct nus_tx *tx, nus_flush_t flush, void *user)
+{
+    nus_packer_init(&tx->packer, flush, user);
+    tx->len = 0;
+}
+
+bool nus_tx_pump(struct nus_tx *tx)
+{
+    size_t taken = nus_packer_write(&tx->packer, tx->backlog, tx->len);
+
+    memmove(tx->backlog, &tx->backlog[taken], tx->len - taken);
+    tx->len -= (uint16_t)taken;
+
+    /* Frames that came while the stack was busy share this packet. */
+    if (tx->len == 0) {
+        (void)nus_packer_flush(&tx->packer);
+    }
+
+    return tx->len > 0 || tx->packer.len > 0;
+}
+
+int nus_tx_frame(struct nus_tx *tx, const uint8_t *frame, size_t len)
+{
+    if (len > sizeof(tx->backlog) - tx->len) {
+        return -ENOBUFS;
+    }
+
+    memcpy(&tx->backlog[tx->len], frame, len);
+    tx->len += (uint16_t)len;
+    (void)nus_tx_pump(tx);
+
+    return 0;
+}
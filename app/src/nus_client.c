@@ -0,0 +1,208 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/att.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+#include "nus.h"
+
+LOG_MODULE_REGISTER(nus_client, LOG_LEVEL_INF);
+
+struct nus_client {
+    struct bt_conn *conn;
+    struct bt_gatt_exchange_params mtu;
+    struct bt_gatt_discover_params disc;
+    struct bt_gatt_subscribe_params sub;
+    uint16_t svc_end;
+    uint16_t rx_handle;
+    nus_client_ready_t ready;
+    nus_client_recv_t recv;
+    void *user;
+};
+
+static const struct bt_uuid_128 nus_svc_uuid = BT_UUID_INIT_128(NUS_SVC_UUID_VAL);
+static const struct bt_uuid_128 nus_rx_uuid = BT_UUID_INIT_128(NUS_RX_UUID_VAL);
+static const struct bt_uuid_128 nus_tx_uuid = BT_UUID_INIT_128(NUS_TX_UUID_VAL);
+
+static struct nus_client clients[CONFIG_BT_MAX_CONN];
+
+static void nus_done(struct nus_client *nus, int err)
+{
+    if (err != 0) {
+        LOG_WRN("slot %u: no usable NUS (%d)", (unsigned int)(nus - clients), err);
+    }
+
+    nus->ready(nus->user, err);
+}
+
+static uint8_t nus_notify(struct bt_conn *conn, struct bt_gatt_subscribe_params *params,
+                          const void *data, uint16_t length)
+{
+    struct nus_client *nus = CONTAINER_OF(params, struct nus_client, sub);
+
+    ARG_UNUSED(conn);
+
+    if (data == NULL) {
+        params->value_handle = 0;
+        return BT_GATT_ITER_STOP;
+    }
+
+    /* Straight from the ACL buffer; no copy into a net_buf first. */
+    nus->recv(nus->user, data, length);
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static uint8_t nus_discover(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                            struct bt_gatt_discover_params *params)
+{
+    struct nus_client *nus = CONTAINER_OF(params, struct nus_client, disc);
+    int err;
+
+    switch (params->type) {
+    case BT_GATT_DISCOVER_PRIMARY: {
+        const struct bt_gatt_service_val *svc;
+
+        if (attr == NULL) {
+            nus_done(nus, -ENOENT);
+            return BT_GATT_ITER_STOP;
+        }
+
+        svc = attr->user_data;
+        nus->svc_end = svc->end_handle;
+
+        params->uuid = NULL;
+        params->start_handle = attr->handle + 1;
+        params->end_handle = nus->svc_end;
+        params->type = BT_GATT_DISCOVER_CHARACTERISTIC;
+        break;
+    }
+    case BT_GATT_DISCOVER_CHARACTERISTIC: {
+        const struct bt_gatt_chrc *chrc;
+
+        if (attr != NULL) {
+            chrc = attr->user_data;
+            if (bt_uuid_cmp(chrc->uuid, &nus_rx_uuid.uuid) == 0) {
+                nus->rx_handle = chrc->value_handle;
+            } else if (bt_uuid_cmp(chrc->uuid, &nus_tx_uuid.uuid) == 0) {
+                nus->sub.value_handle = chrc->value_handle;
+            }
+            return BT_GATT_ITER_CONTINUE;
+        }
+
+        if (nus->rx_handle == 0 || nus->sub.value_handle == 0) {
+            nus_done(nus, -ENOENT);
+            return BT_GATT_ITER_STOP;
+        }
+
+        params->uuid = BT_UUID_GATT_CCC;
+        params->start_handle = nus->sub.value_handle + 1;
+        params->end_handle = nus->svc_end;
+        params->type = BT_GATT_DISCOVER_DESCRIPTOR;
+        break;
+    }
+    default:
+        if (attr == NULL) {
+            nus_done(nus, -ENOENT);
+            return BT_GATT_ITER_STOP;
+        }
+
+        nus->sub.ccc_handle = attr->handle;
+        nus->sub.notify = nus_notify;
+        nus->sub.value = BT_GATT_CCC_NOTIFY;
+
+        err = bt_gatt_subscribe(conn, &nus->sub);
+        nus_done(nus, err == -EALREADY ? 0 : err);
+        return BT_GATT_ITER_STOP;
+    }
+
+    err = bt_gatt_discover(conn, params);
+    if (err != 0) {
+        nus_done(nus, err);
+    }
+
+    return BT_GATT_ITER_STOP;
+}
+
+static void nus_mtu_done(struct bt_conn *conn, uint8_t att_err,
+                         struct bt_gatt_exchange_params *params)
+{
+    struct nus_client *nus = CONTAINER_OF(params, struct nus_client, mtu);
+    int err;
+
+    /* A peer that refuses the exchange still works at the default MTU. */
+    if (att_err != 0) {
+        LOG_DBG("MTU exchange failed (0x%02x)", att_err);
+    }
+
+    nus->disc.uuid = &nus_svc_uuid.uuid;
+    nus->disc.func = nus_discover;
+    nus->disc.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+    nus->disc.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+    nus->disc.type = BT_GATT_DISCOVER_PRIMARY;
+
+    err = bt_gatt_discover(conn, &nus->disc);
+    if (err != 0) {
+        nus_done(nus, err);
+    }
+}
+
+int nus_client_start(size_t slot, struct bt_conn *conn, nus_client_ready_t ready,
+                     nus_client_recv_t recv, void *user)
+{
+    struct nus_client *nus;
+    int err;
+
+    if (slot >= ARRAY_SIZE(clients)) {
+        return -EINVAL;
+    }
+
+    nus = &clients[slot];
+    memset(nus, 0, sizeof(*nus));
+    nus->conn = conn;
+    nus->ready = ready;
+    nus->recv = recv;
+    nus->user = user;
+    nus->mtu.func = nus_mtu_done;
+
+    err = bt_gatt_exchange_mtu(conn, &nus->mtu);
+    if (err == -EALREADY) {
+        /* The stack already did it (BT_GATT_AUTO_UPDATE_MTU). */
+        nus_mtu_done(conn, 0, &nus->mtu);
+        err = 0;
+    }
+
+    return err;
+}
+
+void nus_client_stop(size_t slot)
+{
+    if (slot < ARRAY_SIZE(clients)) {
+        clients[slot].conn = NULL;
+        clients[slot].rx_handle = 0;
+    }
+}
+
+int nus_client_send(size_t slot, const uint8_t *data, uint16_t len)
+{
+    struct nus_client *nus;
+
+    if (slot >= ARRAY_SIZE(clients) || clients[slot].rx_handle == 0) {
+        return -ENOTCONN;
+    }
+
+    nus = &clients[slot];
+
+    return bt_gatt_write_without_response(nus->conn, nus->rx_handle, data, len, false);
+}
+
+uint16_t nus_client_mtu(size_t slot)
+{
+    if (slot >= ARRAY_SIZE(clients) || clients[slot].conn == NULL) {
+        return BT_ATT_DEFAULT_LE_MTU;
+    }
+
+    return bt_gatt_get_mtu(clients[slot].conn);
+}
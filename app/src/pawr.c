@@ -0,0 +1,58 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include "pawr.h"
+
+void pawr_batch_init(struct pawr_batch *batch)
+{
+    batch->count = 0;
+    batch->len = 0;
+    batch->first_ms = 0;
+}
+
+int pawr_batch_add(struct pawr_batch *batch, uint16_t pos, int8_t rssi,
+                   const uint8_t *data, uint8_t len, int64_t now_ms)
+{
+    uint8_t *rec;
+
+    if (PAWR_RSP_HDR_SIZE + len > sizeof(batch->buf)) {
+        return -EMSGSIZE;
+    }
+
+    if (batch->len + PAWR_RSP_HDR_SIZE + len > sizeof(batch->buf) ||
+        batch->count == UINT8_MAX) {
+        return -ENOSPC;
+    }
+
+    if (batch->count == 0) {
+        batch->first_ms = now_ms;
+    }
+
+    rec = &batch->buf[batch->len];
+    sys_put_le16(pos, rec);
+    rec[2] = (uint8_t)rssi;
+    rec[3] = len;
+    if (len > 0) {
+        memcpy(&rec[PAWR_RSP_HDR_SIZE], data, len);
+    }
+
+    batch->len += PAWR_RSP_HDR_SIZE + len;
+    batch->count++;
+
+    return 0;
+}
+
+size_t pawr_batch_take(struct pawr_batch *batch, uint8_t *dst, size_t cap)
+{
+    size_t len = 1U + batch->len;
+
+    if (batch->count == 0 || cap < len) {
+        return 0;
+    }
+
+    dst[0] = batch->count;
+    memcpy(&dst[1], batch->buf, batch->len);
+    pawr_batch_init(batch);
+
+    return len;
+}
@@ -0,0 +1,184 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include "pawr.h"
+#include "stats.h"
+
+LOG_MODULE_REGISTER(pawr, LOG_LEVEL_INF);
+
+#define PAWR_HEARD_SIZE  DIV_ROUND_UP(CONFIG_APP_PAWR_SLOTS, 8)
+#define PAWR_SUB_SIZE    (PAWR_SUB_HDR_SIZE + PAWR_HEARD_SIZE)
+#define PAWR_INTERVAL_MS (CONFIG_APP_PAWR_INTERVAL * 5 / 4)
+
+BUILD_ASSERT(CONFIG_APP_PAWR_SUBEVENTS * CONFIG_APP_PAWR_SUBEVENT_INTERVAL <=
+             CONFIG_APP_PAWR_INTERVAL,
+             "subevents must fit in the periodic interval");
+BUILD_ASSERT(CONFIG_APP_PAWR_RSP_SLOT_DELAY * 10 +
+             CONFIG_APP_PAWR_SLOTS * CONFIG_APP_PAWR_RSP_SLOT_SPACING <=
+             CONFIG_APP_PAWR_SUBEVENT_INTERVAL * 10,
+             "response slots must fit in the subevent interval");
+
+static const struct bt_le_per_adv_param pawr_param = {
+    .interval_min = CONFIG_APP_PAWR_INTERVAL,
+    .interval_max = CONFIG_APP_PAWR_INTERVAL,
+    .num_subevents = CONFIG_APP_PAWR_SUBEVENTS,
+    .subevent_interval = CONFIG_APP_PAWR_SUBEVENT_INTERVAL,
+    .response_slot_delay = CONFIG_APP_PAWR_RSP_SLOT_DELAY,
+    .response_slot_spacing = CONFIG_APP_PAWR_RSP_SLOT_SPACING,
+    .num_response_slots = CONFIG_APP_PAWR_SLOTS,
+};
+
+static const struct bt_data pawr_ad[] = {
+    BT_DATA(BT_DATA_NAME_COMPLETE, CONFIG_BT_DEVICE_NAME,
+            sizeof(CONFIG_BT_DEVICE_NAME) - 1),
+};
+
+static struct bt_le_ext_adv *pawr_adv;
+static uint8_t pawr_seq;
+
+/* Slots heard since each subevent's data was last sent. */
+static uint8_t heard[CONFIG_APP_PAWR_SUBEVENTS][PAWR_HEARD_SIZE];
+
+static struct bt_le_per_adv_subevent_data_params sub_params[CONFIG_APP_PAWR_SUBEVENTS];
+static struct net_buf_simple sub_bufs[CONFIG_APP_PAWR_SUBEVENTS];
+static uint8_t sub_data[CONFIG_APP_PAWR_SUBEVENTS][PAWR_SUB_SIZE];
+
+static struct pawr_batch batch;
+static struct k_spinlock batch_lock;
+
+static void pawr_flush(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, pawr_flush);
+
+static size_t pawr_fill(uint8_t *dst, size_t cap)
+{
+    k_spinlock_key_t key = k_spin_lock(&batch_lock);
+    int64_t first_ms = batch.first_ms;
+    size_t len = pawr_batch_take(&batch, dst, cap);
+
+    k_spin_unlock(&batch_lock, key);
+
+    if (len > 0) {
+        stats_observe(STATS_HIST_PAWR_AGE_US,
+                      (uint32_t)((k_uptime_get() - first_ms) * USEC_PER_MSEC));
+    }
+
+    return len;
+}
+
+/* Send whatever arrived this interval, so no response waits longer. */
+static void pawr_flush(struct k_work *work)
+{
+    (void)stats_send(STATS_REC_PAWR, pawr_fill);
+    k_work_reschedule(k_work_delayable_from_work(work), K_MSEC(PAWR_INTERVAL_MS));
+}
+
+static void pawr_request(struct bt_le_ext_adv *adv,
+                         const struct bt_le_per_adv_data_request *request)
+{
+    uint8_t count = MIN(request->count, CONFIG_APP_PAWR_SUBEVENTS);
+    int err;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t subevent = (request->start + i) % CONFIG_APP_PAWR_SUBEVENTS;
+        struct net_buf_simple *buf = &sub_bufs[i];
+
+        net_buf_simple_init_with_data(buf, sub_data[i], sizeof(sub_data[i]));
+        sub_data[i][0] = pawr_seq;
+        sub_data[i][1] = CONFIG_APP_PAWR_SLOTS;
+        memcpy(&sub_data[i][PAWR_SUB_HDR_SIZE], heard[subevent], PAWR_HEARD_SIZE);
+        memset(heard[subevent], 0, PAWR_HEARD_SIZE);
+
+        sub_params[i].subevent = subevent;
+        sub_params[i].response_slot_start = 0;
+        sub_params[i].response_slot_count = CONFIG_APP_PAWR_SLOTS;
+        sub_params[i].data = buf;
+    }
+
+    pawr_seq++;
+
+    err = bt_le_per_adv_set_subevent_data(adv, count, sub_params);
+    if (err != 0) {
+        LOG_WRN("subevent data failed (%d)", err);
+    }
+}
+
+static void pawr_response(struct bt_le_ext_adv *adv, struct bt_le_per_adv_response_info *info,
+                          struct net_buf_simple *buf)
+{
+    uint16_t pos = pawr_position(info->subevent, info->response_slot,
+                                 CONFIG_APP_PAWR_SUBEVENTS);
+    k_spinlock_key_t key;
+    int err;
+
+    ARG_UNUSED(adv);
+
+    if (buf == NULL || buf->len > UINT8_MAX ||
+        info->subevent >= CONFIG_APP_PAWR_SUBEVENTS ||
+        info->response_slot >= CONFIG_APP_PAWR_SLOTS) {
+        return;
+    }
+
+    heard[info->subevent][info->response_slot / 8U] |= BIT(info->response_slot % 8U);
+    stats_add(STATS_PAWR_RSP, 1);
+
+    key = k_spin_lock(&batch_lock);
+    err = pawr_batch_add(&batch, pos, info->rssi, buf->data, (uint8_t)buf->len,
+                         k_uptime_get());
+    k_spin_unlock(&batch_lock, key);
+
+    if (err == -ENOSPC) {
+        (void)stats_send(STATS_REC_PAWR, pawr_fill);
+
+        key = k_spin_lock(&batch_lock);
+        (void)pawr_batch_add(&batch, pos, info->rssi, buf->data, (uint8_t)buf->len,
+                             k_uptime_get());
+        k_spin_unlock(&batch_lock, key);
+    }
+}
+
+static const struct bt_le_ext_adv_cb pawr_cb = {
+    .pawr_data_request = pawr_request,
+    .pawr_response = pawr_response,
+};
+
+int pawr_start(void)
+{
+    int err;
+
+    pawr_batch_init(&batch);
+
+    /* The central may have enabled Bluetooth already. */
+    err = bt_enable(NULL);
+    if (err == -EALREADY) {
+        err = 0;
+    }
+    if (err == 0) {
+        err = bt_le_ext_adv_create(BT_LE_EXT_ADV_NCONN, &pawr_cb, &pawr_adv);
+    }
+    if (err == 0) {
+        err = bt_le_ext_adv_set_data(pawr_adv, pawr_ad, ARRAY_SIZE(pawr_ad), NULL, 0);
+    }
+    if (err == 0) {
+        err = bt_le_per_adv_set_param(pawr_adv, &pawr_param);
+    }
+    if (err == 0) {
+        err = bt_le_per_adv_start(pawr_adv);
+    }
+    if (err == 0) {
+        err = bt_le_ext_adv_start(pawr_adv, BT_LE_EXT_ADV_START_DEFAULT);
+    }
+
+    if (err != 0) {
+        LOG_ERR("PAwR start failed (%d)", err);
+        return err;
+    }
+
+    k_work_schedule(&flush_work, K_MSEC(PAWR_INTERVAL_MS));
+
+    LOG_INF("PAwR up: %u subevents x %u slots every %u ms", CONFIG_APP_PAWR_SUBEVENTS,
+            CONFIG_APP_PAWR_SLOTS, PAWR_INTERVAL_MS);
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <zephyr/kernel.h>
+#include "phy_sel.h"
+
+/* Weight of a new window in the smoothed values, as a shift. */
+#define SMOOTH_SHIFT 1
+
+/* Receiver sensitivity in dBm, as for the nRF52840. */
+static const int8_t sensitivity[] = {
+    [ADMIT_PHY_1M] = -95,
+    [ADMIT_PHY_2M] = -92,
+    [ADMIT_PHY_CODED_S2] = -100,
+    [ADMIT_PHY_CODED_S8] = -103,
+};
+
+/* Margin over sensitivity from which the model expects no loss, and span down to total loss. */
+#define CLEAN_DB 8
+#define SPAN_DB  12
+
+void phy_sel_init(struct phy_sel *sel, enum admit_phy phy)
+{
+    sel->phy = (uint8_t)phy;
+    sel->votes = 0;
+    sel->rssi_valid = false;
+    sel->per_valid = false;
+    sel->rssi = 0;
+    sel->per_pm = 0;
+    sel->dwell_ms = 0;
+}
+
+uint16_t phy_sel_model_per(enum admit_phy phy, int rssi)
+{
+    int margin = rssi - sensitivity[phy];
+
+    if (margin >= CLEAN_DB) {
+        return 0;
+    }
+    if (margin <= CLEAN_DB - SPAN_DB) {
+        return 1000;
+    }
+
+    return (uint16_t)((CLEAN_DB - margin) * 1000 / SPAN_DB);
+}
+
+uint32_t phy_sel_goodput(enum admit_phy phy, uint16_t pdu_len, uint16_t per_pm)
+{
+    return (uint32_t)pdu_len * 8U * (1000U - MIN(per_pm, 1000U)) /
+           admit_exchange_us(phy, pdu_len);
+}
+
+enum admit_phy phy_sel_update(struct phy_sel *sel, const struct phy_sel_sample *sample,
+                              uint16_t pdu_len, const struct phy_sel_policy *policy)
+{
+    enum admit_phy cur = sel->phy;
+    enum admit_phy alt = cur == ADMIT_PHY_2M ? ADMIT_PHY_CODED_S2 : ADMIT_PHY_2M;
+    uint16_t model_cur;
+    uint16_t per_cur;
+    uint16_t per_alt;
+    uint32_t total = sample->ok + sample->lost;
+
+    sel->dwell_ms += sample->ms;
+
+    if (sample->rssi_valid) {
+        sel->rssi = sel->rssi_valid ? sel->rssi + ((sample->rssi - sel->rssi) >> SMOOTH_SHIFT)
+                                    : sample->rssi;
+        sel->rssi_valid = true;
+    }
+
+    if (total > 0) {
+        int32_t per = (int32_t)((uint64_t)sample->lost * 1000U / total);
+
+        sel->per_pm = sel->per_valid ? sel->per_pm + ((per - sel->per_pm) >> SMOOTH_SHIFT)
+                                     : per;
+        sel->per_valid = true;
+    }
+
+    if (!sel->rssi_valid || sel->dwell_ms < policy->dwell_ms) {
+        sel->votes = 0;
+        return cur;
+    }
+
+    model_cur = phy_sel_model_per(cur, sel->rssi);
+    per_cur = sel->per_valid ? sel->per_pm : model_cur;
+    per_alt = MIN(phy_sel_model_per(alt, sel->rssi) +
+                  (per_cur > model_cur ? per_cur - model_cur : 0), 1000);
+
+    if ((uint64_t)phy_sel_goodput(alt, pdu_len, per_alt) * 100U >
+        (uint64_t)phy_sel_goodput(cur, pdu_len, per_cur) * (100U + policy->hyst_pct)) {
+        sel->votes++;
+    } else {
+        sel->votes = 0;
+    }
+
+    if (sel->votes < policy->confirm) {
+        return cur;
+    }
+
+    /* The loss measured so far belongs to the PHY being left. */
+    sel->phy = (uint8_t)alt;
+    sel->votes = 0;
+    sel->per_valid = false;
+    sel->dwell_ms = 0;
+
+    return alt;
+}
@@ -0,0 +1,88 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include "pkt_pool.h"
+#include "pkt_track.h"
+#include "pressure.h"
+#include "trace.h"
+
+#if defined(CONFIG_APP_USB_BRIDGE)
+#include <zephyr/drivers/usb/udc.h>
+#endif
+
+/*
+ * One pool serves both stacks, so its buffers carry what either needs:
+ * the UDC's per-transfer info and the BT host's TX metadata share the
+ * user data, and the BT headers go in the headroom.
+ */
+#if defined(CONFIG_APP_USB_BRIDGE)
+#define PKT_UD_USB sizeof(struct udc_buf_info)
+#else
+#define PKT_UD_USB 0U
+#endif
+
+#if defined(CONFIG_APP_BT_CENTRAL)
+#define PKT_UD_BT CONFIG_BT_CONN_TX_USER_DATA_SIZE
+#else
+#define PKT_UD_BT 0U
+#endif
+
+#define PKT_USER_DATA_SIZE MAX(PKT_UD_USB, PKT_UD_BT)
+#define PKT_BUF_SIZE (CONFIG_APP_PKT_HEADROOM + CONFIG_APP_PKT_SIZE)
+
+static atomic_t pkt_in_use;
+
+static void pkt_update_pressure(void)
+{
+    if (IS_ENABLED(CONFIG_APP_PRESSURE)) {
+        pressure_update(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT);
+    }
+}
+
+static void pkt_destroy(struct net_buf *buf)
+{
+    if (IS_ENABLED(CONFIG_APP_TRACE)) {
+        trace_end(buf);
+    }
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_FREE);
+    }
+
+    atomic_dec(&pkt_in_use);
+    net_buf_destroy(buf);
+    pkt_update_pressure();
+}
+
+#if defined(CONFIG_APP_USB_BRIDGE)
+/* Buffers may be handed to the UDC driver directly, so they need its
+ * alignment, which the headroom must keep.
+ */
+BUILD_ASSERT(CONFIG_APP_PKT_HEADROOM % UDC_BUF_ALIGN == 0,
+             "headroom would misalign USB transfers");
+
+UDC_BUF_POOL_DEFINE(pkt_pool, CONFIG_APP_PKT_COUNT, PKT_BUF_SIZE,
+                    PKT_USER_DATA_SIZE, pkt_destroy);
+#else
+NET_BUF_POOL_FIXED_DEFINE(pkt_pool, CONFIG_APP_PKT_COUNT, PKT_BUF_SIZE,
+                          PKT_USER_DATA_SIZE, pkt_destroy);
+#endif
+
+struct net_buf *pkt_alloc(k_timeout_t timeout)
+{
+    struct net_buf *buf = net_buf_alloc(&pkt_pool, timeout);
+
+    if (buf != NULL) {
+        net_buf_reserve(buf, CONFIG_APP_PKT_HEADROOM);
+        if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+            pkt_track_set(buf, PKT_OWNER_ALLOC);
+        }
+        atomic_inc(&pkt_in_use);
+        pkt_update_pressure();
+    }
+
+    return buf;
+}
+
+size_t pkt_pool_free_count(void)
+{
+    return CONFIG_APP_PKT_COUNT - (size_t)atomic_get(&pkt_in_use);
+}
@@ -0,0 +1,159 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include "pkt_track.h"
+
+struct pkt_tag {
+    uint8_t owner;
+    uint32_t alloc_ms;
+    uint32_t since_ms;
+};
+
+static struct k_spinlock lock;
+static struct pkt_tag tags[CONFIG_APP_PKT_COUNT];
+
+static const char *const owner_names[PKT_OWNER_COUNT] = {
+    [PKT_OWNER_FREE] = "free",
+    [PKT_OWNER_ALLOC] = "alloc",
+    [PKT_OWNER_USB_OUT] = "usb_out",
+    [PKT_OWNER_USB_RX] = "usb_rx",
+    [PKT_OWNER_APP] = "app",
+    [PKT_OWNER_USB_IN] = "usb_in",
+    [PKT_OWNER_BT_RX] = "bt_rx",
+    [PKT_OWNER_BT_TX] = "bt_tx",
+    [PKT_OWNER_RELAY] = "relay",
+    [PKT_OWNER_WORKER] = "worker",
+    [PKT_OWNER_UART_RX] = "uart_rx",
+    [PKT_OWNER_UART_TX] = "uart_tx",
+    [PKT_OWNER_SPI_RX] = "spi_rx",
+    [PKT_OWNER_SPI_TX] = "spi_tx",
+};
+
+const char *pkt_owner_name(enum pkt_owner owner)
+{
+    return owner < PKT_OWNER_COUNT ? owner_names[owner] : "?";
+}
+
+void pkt_track_set(struct net_buf *buf, enum pkt_owner owner)
+{
+    int id = net_buf_id(buf);
+    uint32_t now = k_uptime_get_32();
+    k_spinlock_key_t key;
+
+    if (id < 0 || id >= CONFIG_APP_PKT_COUNT) {
+        return;
+    }
+
+    key = k_spin_lock(&lock);
+
+    if (owner == PKT_OWNER_ALLOC) {
+        tags[id].alloc_ms = now;
+    }
+    tags[id].owner = (uint8_t)owner;
+    tags[id].since_ms = now;
+
+    k_spin_unlock(&lock, key);
+}
+
+/* Whether a goes before b: by owner, then longest held first. */
+static bool list_before(const struct pkt_track_info *a, const struct pkt_track_info *b)
+{
+    return a->owner != b->owner ? a->owner < b->owner : a->held_ms > b->held_ms;
+}
+
+size_t pkt_track_list(struct pkt_track_info *out, size_t cap)
+{
+    struct pkt_tag snap[CONFIG_APP_PKT_COUNT];
+    uint32_t now = k_uptime_get_32();
+    k_spinlock_key_t key;
+    size_t total = 0;
+    size_t n = 0;
+
+    /* Copy first so the lock is not held while sorting. */
+    key = k_spin_lock(&lock);
+    memcpy(snap, tags, sizeof(snap));
+    k_spin_unlock(&lock, key);
+
+    for (size_t id = 0; id < ARRAY_SIZE(snap); id++) {
+        struct pkt_track_info info = {
+            .id = (uint16_t)id,
+            .owner = snap[id].owner,
+            .held_ms = now - snap[id].since_ms,
+            .age_ms = now - snap[id].alloc_ms,
+        };
+        size_t pos = n;
+
+        if (info.owner == PKT_OWNER_FREE) {
+            continue;
+        }
+
+        total++;
+
+        /* Insertion sort into out, keeping the first cap entries. */
+        while (pos > 0 && list_before(&info, &out[pos - 1U])) {
+            if (pos < cap) {
+                out[pos] = out[pos - 1U];
+            }
+            pos--;
+        }
+        if (pos < cap) {
+            out[pos] = info;
+            n = MIN(n + 1U, cap);
+        }
+    }
+
+    return total;
+}
+
+#if defined(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+
+static struct pkt_track_info shell_list[CONFIG_APP_PKT_COUNT];
+
+static int cmd_pkt_list(const struct shell *sh, size_t argc, char **argv)
+{
+    size_t n = pkt_track_list(shell_list, ARRAY_SIZE(shell_list));
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "%u of %u buffers out", (unsigned int)n, CONFIG_APP_PKT_COUNT);
+    for (size_t i = 0; i < n; i++) {
+        shell_print(sh, "%3u %-8s held %6u ms, allocated %6u ms ago", shell_list[i].id,
+                    pkt_owner_name(shell_list[i].owner), shell_list[i].held_ms,
+                    shell_list[i].age_ms);
+    }
+
+    return 0;
+}
+
+static int cmd_pkt_owners(const struct shell *sh, size_t argc, char **argv)
+{
+    size_t n = pkt_track_list(shell_list, ARRAY_SIZE(shell_list));
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    /* The list is grouped by owner, longest held first. */
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+
+        while (j < n && shell_list[j].owner == shell_list[i].owner) {
+            j++;
+        }
+        shell_print(sh, "%-8s %3u buffers, oldest held %6u ms",
+                    pkt_owner_name(shell_list[i].owner), (unsigned int)(j - i),
+                    shell_list[i].held_ms);
+        i = j;
+    }
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(pkt_cmds,
+    SHELL_CMD(list, NULL, "Outstanding buffers by owner and age", cmd_pkt_list),
+    SHELL_CMD(owners, NULL, "Outstanding buffers per owner", cmd_pkt_owners),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(pkt, &pkt_cmds, "Packet buffer owners", NULL);
+#endif
@@ -0,0 +1,132 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "pressure.h"
+
+LOG_MODULE_REGISTER(pressure, LOG_LEVEL_INF);
+
+/* Free percentage a level is entered below, indexed by level. */
+static const uint8_t enter_pct[] = {
+    [PRESSURE_NORMAL] = 100,
+    [PRESSURE_ELEVATED] = CONFIG_APP_PRESSURE_ELEVATED_PCT,
+    [PRESSURE_HIGH] = CONFIG_APP_PRESSURE_HIGH_PCT,
+    [PRESSURE_CRITICAL] = CONFIG_APP_PRESSURE_CRITICAL_PCT,
+};
+
+static const struct pressure_policy policies[] = {
+    [PRESSURE_NORMAL] = {
+        .compression = true,
+        .capture = true,
+        .coalesce_us = CONFIG_APP_COALESCE_US,
+        .credits = CONFIG_APP_CREDITS,
+    },
+    [PRESSURE_ELEVATED] = {
+        .compression = true,
+        .capture = false,
+        .coalesce_us = CONFIG_APP_COALESCE_US,
+        .credits = CONFIG_APP_CREDITS,
+    },
+    [PRESSURE_HIGH] = {
+        .compression = false,
+        .capture = false,
+        .coalesce_us = CONFIG_APP_COALESCE_US / 2,
+        .credits = (CONFIG_APP_CREDITS + 1) / 2,
+    },
+    [PRESSURE_CRITICAL] = {
+        .compression = false,
+        .capture = false,
+        .coalesce_us = 0,
+        .credits = 1,
+    },
+};
+
+static struct k_spinlock lock;
+static enum pressure_level level;
+static pressure_cb_t level_cb;
+
+/*
+ * Report each step from one level to the other. Called after the lock is
+ * dropped, as pkt_alloc() and pkt_destroy() take it and cb may log or
+ * allocate.
+ */
+static void report(enum pressure_level from, enum pressure_level to, pressure_cb_t cb)
+{
+    int step = to > from ? 1 : -1;
+
+    for (int lvl = from; lvl != (int)to; lvl += step) {
+        LOG_INF("%s -> %s", pressure_level_str(lvl), pressure_level_str(lvl + step));
+
+        if (cb != NULL) {
+            cb(lvl, lvl + step, &policies[lvl + step]);
+        }
+    }
+}
+
+void pressure_init(pressure_cb_t cb)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    level = PRESSURE_NORMAL;
+    level_cb = cb;
+
+    k_spin_unlock(&lock, key);
+}
+
+enum pressure_level pressure_update(size_t free, size_t total)
+{
+    k_spinlock_key_t key;
+    enum pressure_level from;
+    enum pressure_level ret;
+    pressure_cb_t cb;
+    size_t pct;
+
+    if (total == 0) {
+        return level;
+    }
+
+    pct = free * 100U / total;
+
+    key = k_spin_lock(&lock);
+
+    from = level;
+
+    while (level < PRESSURE_CRITICAL && pct < enter_pct[level + 1]) {
+        level++;
+    }
+
+    while (level > PRESSURE_NORMAL &&
+           pct >= enter_pct[level] + CONFIG_APP_PRESSURE_HYST_PCT) {
+        level--;
+    }
+
+    ret = level;
+    cb = level_cb;
+
+    k_spin_unlock(&lock, key);
+
+    /* Every level passed on the way is reported. */
+    report(from, ret, cb);
+
+    return ret;
+}
+
+enum pressure_level pressure_level(void)
+{
+    return level;
+}
+
+const struct pressure_policy *pressure_policy(void)
+{
+    return &policies[level];
+}
+
+const char *pressure_level_str(enum pressure_level lvl)
+{
+    static const char *const names[] = {
+        [PRESSURE_NORMAL] = "normal",
+        [PRESSURE_ELEVATED] = "elevated",
+        [PRESSURE_HIGH] = "high",
+        [PRESSURE_CRITICAL] = "critical",
+    };
+
+    return lvl < ARRAY_SIZE(names) ? names[lvl] : "?";
+}
@@ -0,0 +1,108 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "frame.h"
+#include "pkt_track.h"
+#include "relay.h"
+
+LOG_MODULE_REGISTER(relay, LOG_LEVEL_INF);
+
+static void port_init(struct relay_port *port, relay_send_t send, void *ctx)
+{
+    port->send = send;
+    port->ctx = ctx;
+    sys_slist_init(&port->backlog);
+    port->backlog_len = 0;
+    port->frames = 0;
+    port->bytes = 0;
+    port->drops = 0;
+}
+
+static bool port_send(struct relay_port *port, struct net_buf *buf)
+{
+    uint16_t len = buf->len;
+
+    if (port->send(port->ctx, buf) != 0) {
+        return false;
+    }
+
+    port->frames++;
+    port->bytes += len;
+
+    return true;
+}
+
+static void port_flush(struct relay_port *port)
+{
+    struct net_buf *buf;
+
+    while (port->backlog_len > 0) {
+        /* Unlink first: the link may queue the buffer itself. */
+        buf = CONTAINER_OF(sys_slist_get_not_empty(&port->backlog),
+                           struct net_buf, node);
+
+        if (!port_send(port, buf)) {
+            sys_slist_prepend(&port->backlog, &buf->node);
+            break;
+        }
+
+        port->backlog_len--;
+    }
+}
+
+static int port_forward(struct relay_port *port, struct net_buf *buf)
+{
+    struct frame_hdr hdr;
+
+    if (frame_get_hdr(buf->data, buf->len, &hdr) != 0 ||
+        buf->len != FRAME_HDR_SIZE + hdr.len) {
+        port->drops++;
+        net_buf_unref(buf);
+        return -EBADMSG;
+    }
+
+    /* Older frames first; cut through if none are left waiting. */
+    port_flush(port);
+    if (port->backlog_len == 0 && port_send(port, buf)) {
+        return 0;
+    }
+
+    if (port->backlog_len >= CONFIG_APP_RELAY_BACKLOG) {
+        /* Only a peer ignoring its credits can get here. */
+        LOG_WRN("backlog overrun, chan %u", hdr.chan);
+        port->drops++;
+        net_buf_unref(buf);
+        return -ENOBUFS;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_RELAY);
+    }
+    sys_slist_append(&port->backlog, &buf->node);
+    port->backlog_len++;
+
+    return -EINPROGRESS;
+}
+
+void relay_init(struct relay *r, relay_send_t up_send, void *up_ctx,
+                relay_send_t down_send, void *down_ctx)
+{
+    port_init(&r->up, up_send, up_ctx);
+    port_init(&r->down, down_send, down_ctx);
+}
+
+int relay_from_upstream(struct relay *r, struct net_buf *buf)
+{
+    return port_forward(&r->down, buf);
+}
+
+int relay_from_downstream(struct relay *r, struct net_buf *buf)
+{
+    return port_forward(&r->up, buf);
+}
+
+void relay_kick(struct relay *r)
+{
+    port_flush(&r->down);
+    port_flush(&r->up);
+}
@@ -0,0 +1,318 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/logging/log.h>
+#include "frame.h"
+#include "pkt_pool.h"
+#include "pkt_track.h"
+#include "spi_xfer.h"
+#include "stats.h"
+#include "transport.h"
+
+LOG_MODULE_REGISTER(spi_bridge, LOG_LEVEL_INF);
+
+#define XFER_SIZE CONFIG_APP_SPI_XFER_SIZE
+
+/* Width of the pulse on the ready line that asks the host for a transaction. */
+#define IRQ_PULSE_US 2
+
+BUILD_ASSERT(SPI_XFER_HDR_SIZE + FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD <= XFER_SIZE,
+             "a full frame must fit in one transaction");
+
+/*
+ * The host clocks transactions of XFER_SIZE bytes. The ready line is
+ * high while one is armed; it drops when the host ends one and rises
+ * again once the next is armed. A pulse while it is high asks the host
+ * for a transaction because frames are waiting.
+ */
+static const struct device *const spi = DEVICE_DT_GET(DT_CHOSEN(app_bridge_spi));
+static const struct gpio_dt_spec ready =
+    GPIO_DT_SPEC_GET(DT_PATH(zephyr_user), bridge_ready_gpios);
+
+static const struct spi_config spi_cfg = {
+    .operation = SPI_OP_MODE_SLAVE | SPI_WORD_SET(8) | SPI_TRANSFER_MSB,
+};
+
+/*
+ * Frames to the host are copied into one of two transaction buffers
+ * while the other is armed, and go out in the next transaction. What
+ * does not fit waits in the backlog.
+ */
+static uint8_t tx_slots[2][XFER_SIZE];
+static uint8_t tx_armed;
+static sys_slist_t tx_backlog;
+
+/* The host writes straight into a packet buffer, which goes on as is. */
+static struct net_buf *rx_buf;
+static K_FIFO_DEFINE(rx_fifo);
+
+static struct spi_buf tx_spi_buf = { .len = XFER_SIZE };
+static struct spi_buf rx_spi_buf = { .len = XFER_SIZE };
+static const struct spi_buf_set tx_set = { .buffers = &tx_spi_buf, .count = 1 };
+static const struct spi_buf_set rx_set = { .buffers = &rx_spi_buf, .count = 1 };
+
+static struct k_spinlock lock;
+static bool armed;
+/* The host will clock the armed transaction without being asked. */
+static bool host_told;
+/* No packet buffer to arm the next transaction with. */
+static bool stalled;
+static int xfer_result;
+
+static void xfer_work_handler(struct k_work *work);
+static K_WORK_DEFINE(xfer_work, xfer_work_handler);
+
+static uint8_t *tx_filling(void)
+{
+    return tx_slots[tx_armed ^ 1U];
+}
+
+static bool tx_waiting(void)
+{
+    return spi_xfer_len(tx_slots[tx_armed]) > 0 || spi_xfer_len(tx_filling()) > 0 ||
+           !sys_slist_is_empty(&tx_backlog);
+}
+
+/* Called with the lock held, so the end of a transaction cannot come in between. */
+static void ready_pulse(void)
+{
+    gpio_pin_set_dt(&ready, 0);
+    k_busy_wait(IRQ_PULSE_US);
+    gpio_pin_set_dt(&ready, 1);
+}
+
+/* Move backlog frames into the filling slot while they fit; copied ones go to done. */
+static void tx_fill(sys_slist_t *done)
+{
+    sys_snode_t *node;
+
+    while ((node = sys_slist_peek_head(&tx_backlog)) != NULL) {
+        struct net_buf *buf = CONTAINER_OF(node, struct net_buf, node);
+
+        if (!spi_xfer_add(tx_filling(), XFER_SIZE, buf->data, buf->len)) {
+            break;
+        }
+
+        (void)sys_slist_get(&tx_backlog);
+        sys_slist_append(done, node);
+    }
+}
+
+static void free_all(sys_slist_t *list)
+{
+    sys_snode_t *node;
+
+    while ((node = sys_slist_get(list)) != NULL) {
+        net_buf_unref(CONTAINER_OF(node, struct net_buf, node));
+    }
+}
+
+static void xfer_done(const struct device *dev, int result, void *user_data)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(user_data);
+
+    gpio_pin_set_dt(&ready, 0);
+    armed = false;
+    xfer_result = result;
+    k_spin_unlock(&lock, key);
+
+    k_work_submit(&xfer_work);
+}
+
+/* Hand on what the host sent in the transaction just ended. */
+static void rx_take(struct net_buf *buf, int result)
+{
+    int len = result > 0 ? spi_xfer_parse(buf->data, (size_t)result, NULL) : -EIO;
+
+    if (len <= 0) {
+        net_buf_unref(buf);
+        return;
+    }
+
+    net_buf_add(buf, SPI_XFER_HDR_SIZE + (size_t)len);
+    net_buf_pull(buf, SPI_XFER_HDR_SIZE);
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_SPI_RX);
+    }
+    k_fifo_put(&rx_fifo, buf);
+}
+
+static int xfer_arm(void)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+    int err;
+
+    if (buf == NULL) {
+        return -ENOMEM;
+    }
+
+    tx_spi_buf.buf = tx_slots[tx_armed];
+    rx_spi_buf.buf = buf->data;
+    rx_buf = buf;
+
+    err = spi_transceive_cb(spi, &spi_cfg, &tx_set, &rx_set, xfer_done, NULL);
+    if (err != 0) {
+        rx_buf = NULL;
+        net_buf_unref(buf);
+    }
+
+    return err;
+}
+
+static void xfer_work_handler(struct k_work *work)
+{
+    sys_slist_t done;
+    k_spinlock_key_t key;
+    struct net_buf *buf = NULL;
+    bool pending;
+    int result = 0;
+    int err;
+
+    ARG_UNUSED(work);
+
+    sys_slist_init(&done);
+
+    key = k_spin_lock(&lock);
+    if (armed) {
+        k_spin_unlock(&lock, key);
+        return;
+    }
+
+    if (rx_buf != NULL) {
+        buf = rx_buf;
+        rx_buf = NULL;
+        result = xfer_result;
+
+        /* On an error the same frames go again. */
+        if (result >= 0) {
+            (void)spi_xfer_parse(tx_slots[tx_armed], XFER_SIZE, &pending);
+            spi_xfer_init(tx_slots[tx_armed]);
+            tx_armed ^= 1U;
+            tx_fill(&done);
+            spi_xfer_set_pending(tx_slots[tx_armed],
+                                 spi_xfer_len(tx_filling()) > 0 ||
+                                     !sys_slist_is_empty(&tx_backlog));
+            /* Told by the header just sent that another transaction is due. */
+            host_told = pending;
+        }
+    }
+    k_spin_unlock(&lock, key);
+
+    if (buf != NULL) {
+        rx_take(buf, result);
+    }
+    free_all(&done);
+
+    err = xfer_arm();
+
+    key = k_spin_lock(&lock);
+    stalled = err != 0;
+    if (err == 0) {
+        armed = true;
+        gpio_pin_set_dt(&ready, 1);
+        if (!host_told && tx_waiting()) {
+            host_told = true;
+            ready_pulse();
+        }
+    }
+    k_spin_unlock(&lock, key);
+
+    if (err != 0 && err != -ENOMEM) {
+        LOG_WRN("arming failed (%d)", err);
+    }
+}
+
+/* Arm again if that had to wait for a packet buffer. */
+static void xfer_resume(void)
+{
+    if (stalled) {
+        k_work_submit(&xfer_work);
+    }
+}
+
+static int spi_bridge_init(void)
+{
+    int err;
+
+    if (!device_is_ready(spi) || !gpio_is_ready_dt(&ready)) {
+        LOG_ERR("SPI or ready line not ready");
+        return -ENODEV;
+    }
+
+    err = gpio_pin_configure_dt(&ready, GPIO_OUTPUT_INACTIVE);
+    if (err != 0) {
+        LOG_ERR("ready line setup failed (%d)", err);
+        return err;
+    }
+
+    spi_xfer_init(tx_slots[0]);
+    spi_xfer_init(tx_slots[1]);
+    sys_slist_init(&tx_backlog);
+    k_work_submit(&xfer_work);
+
+    return 0;
+}
+
+static struct net_buf *spi_bridge_recv(k_timeout_t timeout)
+{
+    struct net_buf *buf = k_fifo_get(&rx_fifo, timeout);
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK) && buf != NULL) {
+        pkt_track_set(buf, PKT_OWNER_APP);
+    }
+
+    return buf;
+}
+
+static void spi_bridge_release(struct net_buf *buf)
+{
+    if (buf != NULL) {
+        net_buf_unref(buf);
+    }
+    xfer_resume();
+}
+
+static int spi_bridge_send(struct net_buf *buf)
+{
+    sys_slist_t done;
+    k_spinlock_key_t key;
+
+    if (buf->len + SPI_XFER_HDR_SIZE > XFER_SIZE) {
+        net_buf_unref(buf);
+        return -EMSGSIZE;
+    }
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_SPI_TX);
+    }
+
+    sys_slist_init(&done);
+
+    key = k_spin_lock(&lock);
+    sys_slist_append(&tx_backlog, &buf->node);
+    tx_fill(&done);
+    /* Ask for the armed transaction, so the next one can carry these. */
+    if (armed && !host_told) {
+        host_told = true;
+        ready_pulse();
+    }
+    k_spin_unlock(&lock, key);
+
+    free_all(&done);
+    xfer_resume();
+
+    return 0;
+}
+
+const struct transport spi_transport = {
+    .name = "spi",
+    .init = spi_bridge_init,
+    .recv = spi_bridge_recv,
+    .release = spi_bridge_release,
+    .send = spi_bridge_send,
+};
@@ -0,0 +1,56 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include "spi_xfer.h"
+
+void spi_xfer_init(uint8_t *xfer)
+{
+    xfer[0] = SPI_XFER_MAGIC;
+    xfer[1] = 0;
+    sys_put_le16(0, &xfer[2]);
+}
+
+bool spi_xfer_add(uint8_t *xfer, size_t size, const uint8_t *data, size_t len)
+{
+    size_t used = spi_xfer_len(xfer);
+
+    if (SPI_XFER_HDR_SIZE + used + len > size) {
+        return false;
+    }
+
+    memcpy(&xfer[SPI_XFER_HDR_SIZE + used], data, len);
+    sys_put_le16((uint16_t)(used + len), &xfer[2]);
+
+    return true;
+}
+
+size_t spi_xfer_len(const uint8_t *xfer)
+{
+    return sys_get_le16(&xfer[2]);
+}
+
+void spi_xfer_set_pending(uint8_t *xfer, bool pending)
+{
+    xfer[1] = pending ? 1U : 0U;
+}
+
+int spi_xfer_parse(const uint8_t *xfer, size_t len, bool *pending)
+{
+    size_t payload;
+
+    if (len < SPI_XFER_HDR_SIZE || xfer[0] != SPI_XFER_MAGIC) {
+        return -EBADMSG;
+    }
+
+    payload = spi_xfer_len(xfer);
+    if (SPI_XFER_HDR_SIZE + payload > len) {
+        return -EBADMSG;
+    }
+
+    if (pending != NULL) {
+        *pending = xfer[1] != 0U;
+    }
+
+    return (int)payload;
+}
@@ -0,0 +1,149 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include "ctrl.h"
+#include "frame.h"
+#include "pkt_pool.h"
+#include "pressure.h"
+#include "stats.h"
+
+#define STATS_SNAPSHOT_SIZE                                                  \
+    (4U + 1U + 4U * STATS_COUNTER_COUNT + 1U +                               \
+     STATS_HIST_COUNT * (1U + 4U * STATS_HIST_BUCKETS + 8U))
+
+BUILD_ASSERT(STATS_SNAPSHOT_SIZE < CONFIG_APP_FRAME_MAX_PAYLOAD,
+             "a snapshot must fit in one frame");
+
+struct stats_hist_data {
+    uint32_t buckets[STATS_HIST_BUCKETS];
+    uint64_t sum_us;
+};
+
+static stats_sink_t stats_sink;
+static atomic_t counters[STATS_COUNTER_COUNT];
+static struct stats_hist_data hists[STATS_HIST_COUNT];
+static struct k_spinlock hist_lock;
+
+void stats_set_sink(stats_sink_t sink)
+{
+    stats_sink = sink;
+}
+
+int stats_send(uint8_t rec_type, stats_fill_t fill)
+{
+    struct frame_hdr hdr = { .chan = CONFIG_APP_STATS_CHAN, .type = FRAME_DATA };
+    struct net_buf *buf;
+    uint8_t *hdr_pos;
+    size_t body;
+
+    if (stats_sink == NULL) {
+        return -ENODEV;
+    }
+
+    buf = pkt_alloc(K_NO_WAIT);
+    if (buf == NULL) {
+        return -ENOMEM;
+    }
+
+    hdr_pos = net_buf_add(buf, FRAME_HDR_SIZE);
+    net_buf_add_u8(buf, rec_type);
+
+    body = fill(buf->data + buf->len,
+                MIN(net_buf_tailroom(buf), CONFIG_APP_FRAME_MAX_PAYLOAD - 1U));
+    if (body == 0) {
+        net_buf_unref(buf);
+        return -ENODATA;
+    }
+
+    net_buf_add(buf, body);
+    hdr.len = (uint16_t)(buf->len - FRAME_HDR_SIZE);
+    frame_put_hdr(hdr_pos, &hdr);
+
+    return stats_sink(buf);
+}
+
+void stats_add(enum stats_counter counter, uint32_t value)
+{
+    atomic_add(&counters[counter], (atomic_val_t)value);
+}
+
+void stats_observe(enum stats_hist hist, uint32_t value_us)
+{
+    k_spinlock_key_t key;
+    uint32_t bucket = 0;
+
+    while (bucket < STATS_HIST_BUCKETS - 1U && value_us >= BIT(bucket)) {
+        bucket++;
+    }
+
+    key = k_spin_lock(&hist_lock);
+    hists[hist].buckets[bucket]++;
+    hists[hist].sum_us += value_us;
+    k_spin_unlock(&hist_lock, key);
+}
+
+size_t stats_snapshot(uint8_t *dst, size_t cap)
+{
+    k_spinlock_key_t key;
+    uint8_t *p = dst;
+
+    if (cap < STATS_SNAPSHOT_SIZE) {
+        return 0;
+    }
+
+    /* Gauges are sampled now rather than tracked on every change. */
+    atomic_set(&counters[STATS_POOL_FREE], (atomic_val_t)pkt_pool_free_count());
+    if (IS_ENABLED(CONFIG_APP_PRESSURE)) {
+        atomic_set(&counters[STATS_PRESSURE_LEVEL], pressure_level());
+    }
+
+    sys_put_le32(k_uptime_get_32(), p);
+    p += 4;
+
+    *p++ = STATS_COUNTER_COUNT;
+    for (size_t i = 0; i < STATS_COUNTER_COUNT; i++) {
+        sys_put_le32((uint32_t)atomic_get(&counters[i]), p);
+        p += 4;
+    }
+
+    *p++ = STATS_HIST_COUNT;
+
+    key = k_spin_lock(&hist_lock);
+    for (size_t h = 0; h < STATS_HIST_COUNT; h++) {
+        *p++ = STATS_HIST_BUCKETS;
+        for (size_t i = 0; i < STATS_HIST_BUCKETS; i++) {
+            sys_put_le32(hists[h].buckets[i], p);
+            p += 4;
+        }
+        sys_put_le64(hists[h].sum_us, p);
+        p += 8;
+    }
+    k_spin_unlock(&hist_lock, key);
+
+    return (size_t)(p - dst);
+}
+
+static int stats_ignore_tlv(void *user, const struct ctrl_tlv *tlv)
+{
+    ARG_UNUSED(user);
+    ARG_UNUSED(tlv);
+
+    return 0;
+}
+
+int stats_handle_ctrl(const uint8_t *payload, size_t len)
+{
+    uint8_t op;
+    int err;
+
+    err = ctrl_parse(payload, len, &op, stats_ignore_tlv, NULL);
+    if (err != 0) {
+        return err;
+    }
+
+    if (op != STATS_OP_SNAPSHOT) {
+        return -ENOTSUP;
+    }
+
+    return stats_send(STATS_REC_SNAPSHOT, stats_snapshot);
+}
@@ -1,7 +1,271 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include "cycles.h"
 #include "sum.h"
 
+LOG_MODULE_REGISTER(sum, LOG_LEVEL_INF);
+
+#if defined(__i386__) || defined(__x86_64__)
+#define SUM_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(CONFIG_CPU_CORTEX_M) && defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SUM_ARM_DSP 1
+#include <cmsis_core.h>
+#endif
+
+#define SUM_BENCH_SAMPLES 256U
+#define SUM_BENCH_ROUNDS  8U
+
 int add(int a, int b)
 {
     return a + b;
 }
 
+/* Fold n more samples into out. */
+static void i16_fold(const uint8_t *src, size_t n, struct sum_i16 *out)
+{
+    for (size_t i = 0; i < n; i++) {
+        int16_t s = (int16_t)sys_get_le16(&src[i * 2U]);
+
+        out->sum += s;
+        out->min = MIN(out->min, s);
+        out->max = MAX(out->max, s);
+    }
+}
+
+static void i16_empty(struct sum_i16 *out)
+{
+    out->sum = 0;
+    out->min = INT16_MAX;
+    out->max = INT16_MIN;
+}
+
+static void i16_le_scalar(const uint8_t *src, size_t n, struct sum_i16 *out)
+{
+    i16_empty(out);
+    i16_fold(src, n, out);
+}
+
+#if defined(SUM_X86)
+/* Lanes of the vector accumulators, folded into out once at the end. */
+static void i16_lanes(const int32_t *sums, size_t nsums, const int16_t *mins,
+                      const int16_t *maxs, size_t nlanes, struct sum_i16 *out)
+{
+    for (size_t i = 0; i < nsums; i++) {
+        out->sum += sums[i];
+    }
+    for (size_t i = 0; i < nlanes; i++) {
+        out->min = MIN(out->min, mins[i]);
+        out->max = MAX(out->max, maxs[i]);
+    }
+}
+
+/* madd against ones adds sample pairs into int32_t lanes. */
+__attribute__((target("sse2")))
+static void i16_le_sse2(const uint8_t *src, size_t n, struct sum_i16 *out)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    __m128i lo = _mm_set1_epi16(INT16_MAX);
+    __m128i hi = _mm_set1_epi16(INT16_MIN);
+    int32_t sums[4];
+    int16_t mins[8];
+    int16_t maxs[8];
+    size_t i = 0;
+
+    for (; i + 8U <= n; i += 8U) {
+        __m128i v = _mm_loadu_si128((const void *)&src[i * 2U]);
+
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(v, ones));
+        lo = _mm_min_epi16(lo, v);
+        hi = _mm_max_epi16(hi, v);
+    }
+
+    _mm_storeu_si128((void *)sums, acc);
+    _mm_storeu_si128((void *)mins, lo);
+    _mm_storeu_si128((void *)maxs, hi);
+
+    i16_empty(out);
+    i16_lanes(sums, ARRAY_SIZE(sums), mins, maxs, ARRAY_SIZE(mins), out);
+    i16_fold(&src[i * 2U], n - i, out);
+}
+
+__attribute__((target("avx2")))
+static void i16_le_avx2(const uint8_t *src, size_t n, struct sum_i16 *out)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    __m256i lo = _mm256_set1_epi16(INT16_MAX);
+    __m256i hi = _mm256_set1_epi16(INT16_MIN);
+    int32_t sums[8];
+    int16_t mins[16];
+    int16_t maxs[16];
+    size_t i = 0;
+
+    for (; i + 16U <= n; i += 16U) {
+        __m256i v = _mm256_loadu_si256((const void *)&src[i * 2U]);
+
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(v, ones));
+        lo = _mm256_min_epi16(lo, v);
+        hi = _mm256_max_epi16(hi, v);
+    }
+
+    _mm256_storeu_si256((void *)sums, acc);
+    _mm256_storeu_si256((void *)mins, lo);
+    _mm256_storeu_si256((void *)maxs, hi);
+
+    i16_empty(out);
+    i16_lanes(sums, ARRAY_SIZE(sums), mins, maxs, ARRAY_SIZE(mins), out);
+    i16_fold(&src[i * 2U], n - i, out);
+}
+#endif /* SUM_X86 */
+
+#if defined(SUM_ARM_DSP)
+/*
+ * Two samples per word: SMLAD against 1|1 adds both halves into the sum,
+ * and SSUB16 sets the GE flags per half so SEL can keep the min and max.
+ */
+static void i16_le_dsp(const uint8_t *src, size_t n, struct sum_i16 *out)
+{
+    uint32_t sum = 0;
+    uint32_t lo = 0x7FFF7FFFU;
+    uint32_t hi = 0x80008000U;
+    size_t i = 0;
+
+    for (; i + 2U <= n; i += 2U) {
+        uint32_t v;
+
+        memcpy(&v, &src[i * 2U], sizeof(v));
+        sum = __SMLAD(v, 0x00010001U, sum);
+        (void)__SSUB16(v, lo);
+        lo = __SEL(lo, v);
+        (void)__SSUB16(v, hi);
+        hi = __SEL(v, hi);
+    }
+
+    out->sum = (int32_t)sum;
+    out->min = MIN((int16_t)(lo & 0xFFFFU), (int16_t)(lo >> 16));
+    out->max = MAX((int16_t)(hi & 0xFFFFU), (int16_t)(hi >> 16));
+    i16_fold(&src[i * 2U], n - i, out);
+}
+#endif /* SUM_ARM_DSP */
+
+static const struct sum_impl impl_scalar = { "scalar", i16_le_scalar };
+#if defined(SUM_X86)
+static const struct sum_impl impl_sse2 = { "sse2", i16_le_sse2 };
+static const struct sum_impl impl_avx2 = { "avx2", i16_le_avx2 };
+#endif
+#if defined(SUM_ARM_DSP)
+static const struct sum_impl impl_dsp = { "dsp", i16_le_dsp };
+#endif
+
+/* Resolved once by sum_resolve(); scalar is always usable. */
+static const struct sum_impl *impls[3] = { &impl_scalar };
+static size_t impl_count;
+static const struct sum_impl *active = &impl_scalar;
+
+static void sum_resolve(void)
+{
+    if (impl_count != 0) {
+        return;
+    }
+
+    impl_count = 1;
+
+#if defined(SUM_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        impls[impl_count++] = &impl_sse2;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        impls[impl_count++] = &impl_avx2;
+    }
+#endif
+#if defined(SUM_ARM_DSP)
+    /* Cortex-M4 and up; there is nothing to probe at run time. */
+    impls[impl_count++] = &impl_dsp;
+#endif
+}
+
+void sum_i16_le(const uint8_t *src, size_t n, struct sum_i16 *out)
+{
+    active->i16_le(src, n, out);
+}
+
+size_t sum_impl_count(void)
+{
+    sum_resolve();
+
+    return impl_count;
+}
+
+const struct sum_impl *sum_impl_get(size_t idx)
+{
+    sum_resolve();
+
+    return idx < impl_count ? impls[idx] : NULL;
+}
+
+const struct sum_impl *sum_select(void)
+{
+    static uint8_t bench[SUM_BENCH_SAMPLES * 2U];
+    struct sum_i16 ref;
+    uint32_t best_cycles = UINT32_MAX;
+    const struct sum_impl *best = &impl_scalar;
+
+    sum_resolve();
+    cycles_init();
+
+    /* Odd length and offset so every variant also runs its tail. */
+    for (size_t i = 0; i < sizeof(bench); i++) {
+        bench[i] = (uint8_t)(i * 73U + 11U);
+    }
+    i16_le_scalar(&bench[1], SUM_BENCH_SAMPLES - 1U, &ref);
+
+    for (size_t i = 0; i < impl_count; i++) {
+        const struct sum_impl *impl = impls[i];
+        uint32_t cycles = UINT32_MAX;
+        struct sum_i16 r;
+
+        for (uint32_t round = 0; round < SUM_BENCH_ROUNDS; round++) {
+            uint32_t start = (uint32_t)cycles_now();
+
+            impl->i16_le(&bench[1], SUM_BENCH_SAMPLES - 1U, &r);
+            cycles = MIN(cycles, (uint32_t)cycles_now() - start);
+        }
+
+        if (r.sum != ref.sum || r.min != ref.min || r.max != ref.max) {
+            LOG_WRN("%s disagrees with scalar, not used", impl->name);
+            continue;
+        }
+
+        LOG_DBG("%s: %u cycles", impl->name, cycles);
+
+        /* Ties go to the later, wider variant. */
+        if (cycles <= best_cycles) {
+            best_cycles = cycles;
+            best = impl;
+        }
+    }
+
+    active = best;
+
+    LOG_INF("kernels: %s (%u cycles per %u samples)", best->name, best_cycles,
+            SUM_BENCH_SAMPLES - 1U);
+
+    return best;
+}
+
+static int sum_init(void)
+{
+    (void)sum_select();
+
+    return 0;
+}
+
+SYS_INIT(sum_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,204 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include "stats.h"
+#include "trace.h"
+
+#define TRACE_NONE 0xFFU
+
+struct trace_rec {
+    uint32_t seq;
+    uint16_t buf_id;
+    uint8_t stages;
+    uint8_t depth[TRACE_STAGE_COUNT];
+    uint32_t cycles[TRACE_STAGE_COUNT];
+};
+
+BUILD_ASSERT(TRACE_STAGE_COUNT <= 8, "stage mask is a u8");
+
+static atomic_t countdown = ATOMIC_INIT(CONFIG_APP_TRACE_DEFAULT_RATE);
+static uint32_t rate = CONFIG_APP_TRACE_DEFAULT_RATE;
+static uint32_t seq;
+
+static struct k_spinlock lock;
+static struct trace_rec active[CONFIG_APP_TRACE_ACTIVE];
+static bool active_used[CONFIG_APP_TRACE_ACTIVE];
+static uint8_t slot_of[CONFIG_APP_PKT_COUNT] = {
+    [0 ... CONFIG_APP_PKT_COUNT - 1] = TRACE_NONE,
+};
+
+static struct trace_rec done[CONFIG_APP_TRACE_RECORDS];
+static size_t done_head;
+static size_t done_count;
+
+static void trace_export_work(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(export_work, trace_export_work);
+
+void trace_set_rate(uint32_t new_rate)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    rate = new_rate;
+    atomic_set(&countdown, new_rate);
+
+    k_spin_unlock(&lock, key);
+
+    if (new_rate != 0) {
+        k_work_reschedule(&export_work, K_MSEC(CONFIG_APP_TRACE_EXPORT_MS));
+    }
+}
+
+void trace_begin(struct net_buf *buf)
+{
+    k_spinlock_key_t key;
+    int id = net_buf_id(buf);
+
+    if (atomic_dec(&countdown) > 1) {
+        return;
+    }
+
+    key = k_spin_lock(&lock);
+
+    if (rate == 0) {
+        /* Off: park the countdown far away so we rarely get here. */
+        atomic_set(&countdown, INT32_MAX);
+        k_spin_unlock(&lock, key);
+        return;
+    }
+
+    atomic_set(&countdown, rate);
+    seq++;
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(active); i++) {
+        if (!active_used[i]) {
+            active_used[i] = true;
+            active[i] = (struct trace_rec) {
+                .seq = seq,
+                .buf_id = (uint16_t)id,
+            };
+            slot_of[id] = i;
+            break;
+        }
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+void trace_mark(struct net_buf *buf, enum trace_stage stage, uint8_t depth)
+{
+    uint8_t slot = slot_of[net_buf_id(buf)];
+
+    if (slot == TRACE_NONE) {
+        return;
+    }
+
+    active[slot].cycles[stage] = k_cycle_get_32();
+    active[slot].depth[stage] = depth;
+    active[slot].stages |= BIT(stage);
+}
+
+void trace_end(struct net_buf *buf)
+{
+    int id = net_buf_id(buf);
+    k_spinlock_key_t key;
+    uint8_t slot = slot_of[id];
+
+    if (slot == TRACE_NONE) {
+        return;
+    }
+
+    trace_mark(buf, TRACE_FREE, 0);
+
+    key = k_spin_lock(&lock);
+
+    /* Keep the newest records when the host does not keep up. */
+    done[(done_head + done_count) % ARRAY_SIZE(done)] = active[slot];
+    if (done_count < ARRAY_SIZE(done)) {
+        done_count++;
+    } else {
+        done_head = (done_head + 1) % ARRAY_SIZE(done);
+    }
+
+    active_used[slot] = false;
+    slot_of[id] = TRACE_NONE;
+
+    k_spin_unlock(&lock, key);
+}
+
+size_t trace_export(uint8_t *dst, size_t cap)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    size_t len = 0;
+
+    while (done_count > 0 && cap - len >= TRACE_REC_SIZE) {
+        const struct trace_rec *rec = &done[done_head];
+        uint8_t *p = &dst[len];
+
+        sys_put_le32(rec->seq, p);
+        sys_put_le16(rec->buf_id, p + 4);
+        p[6] = rec->stages;
+        p[7] = TRACE_STAGE_COUNT;
+        p += 8;
+
+        for (size_t i = 0; i < TRACE_STAGE_COUNT; i++) {
+            sys_put_le32(rec->cycles[i], p);
+            p[4] = rec->depth[i];
+            p += 5;
+        }
+
+        len += TRACE_REC_SIZE;
+        done_head = (done_head + 1) % ARRAY_SIZE(done);
+        done_count--;
+    }
+
+    k_spin_unlock(&lock, key);
+
+    return len;
+}
+
+static void trace_export_work(struct k_work *work)
+{
+    while (done_count > 0) {
+        if (stats_send(STATS_REC_TRACE, trace_export) != 0) {
+            break;
+        }
+    }
+
+    if (rate != 0) {
+        k_work_reschedule(k_work_delayable_from_work(work),
+                          K_MSEC(CONFIG_APP_TRACE_EXPORT_MS));
+    }
+}
+
+static int trace_init(void)
+{
+    if (rate != 0) {
+        k_work_schedule(&export_work, K_MSEC(CONFIG_APP_TRACE_EXPORT_MS));
+    }
+
+    return 0;
+}
+
+SYS_INIT(trace_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if defined(CONFIG_SHELL)
+#include <stdlib.h>
+#include <zephyr/shell/shell.h>
+
+static int cmd_trace_rate(const struct shell *sh, size_t argc, char **argv)
+{
+    if (argc > 1) {
+        trace_set_rate((uint32_t)strtoul(argv[1], NULL, 0));
+    }
+
+    shell_print(sh, "sampling 1 in %u packets", rate);
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(trace_cmds,
+    SHELL_CMD_ARG(rate, NULL, "Show or set sampling rate: rate [N]", cmd_trace_rate, 1, 1),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(trace, &trace_cmds, "Sampled packet tracing", NULL);
+#endif
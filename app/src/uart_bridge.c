@@ -0,0 +1,213 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log.h>
+#include "pkt_pool.h"
+#include "pkt_track.h"
+#include "stats.h"
+#include "transport.h"
+
+LOG_MODULE_REGISTER(uart_bridge, LOG_LEVEL_INF);
+
+/*
+ * Free packet buffers needed to hand the UART its next receive buffer:
+ * one for what is left of the current buffer, one for the next, and one
+ * for a timeout in between. With fewer, reception stops once the current
+ * buffer is full and RTS holds the host off until buffers come back.
+ */
+#define RX_RESERVE 3U
+
+static const struct device *const uart = DEVICE_DT_GET(DT_CHOSEN(app_bridge_uart));
+
+/* One buffer receiving, the next queued behind it; the UARTE fills them by EasyDMA. */
+static uint8_t rx_bufs[2][CONFIG_APP_UART_RX_BUF_SIZE];
+static uint8_t rx_next;
+static atomic_t rx_stalled;
+static K_FIFO_DEFINE(rx_fifo);
+
+/* Frames go out of their packet buffers as they are, one at a time. */
+static K_FIFO_DEFINE(tx_fifo);
+static struct net_buf *tx_buf;
+static atomic_t tx_busy;
+
+static bool rx_room(void)
+{
+    return pkt_pool_free_count() >= RX_RESERVE;
+}
+
+static int rx_start(void)
+{
+    uint8_t *buf = rx_bufs[rx_next];
+
+    rx_next ^= 1U;
+
+    return uart_rx_enable(uart, buf, sizeof(rx_bufs[0]), CONFIG_APP_UART_RX_TIMEOUT_US);
+}
+
+/* Resume reception stopped for want of packet buffers, if there are some now. */
+static void rx_resume(void)
+{
+    if (rx_room() && atomic_cas(&rx_stalled, 1, 0)) {
+        int err = rx_start();
+
+        if (err != 0) {
+            LOG_WRN("RX restart failed (%d)", err);
+            atomic_set(&rx_stalled, 1);
+        }
+    }
+}
+
+/* Copy out what the UART received, so its buffer can go straight back. */
+static void rx_chunk(const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+        size_t n;
+
+        if (buf == NULL) {
+            stats_add(STATS_RX_DROPPED_BYTES, len);
+            return;
+        }
+
+        n = MIN(len, net_buf_tailroom(buf));
+        net_buf_add_mem(buf, data, n);
+        if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+            pkt_track_set(buf, PKT_OWNER_UART_RX);
+        }
+        k_fifo_put(&rx_fifo, buf);
+
+        data += n;
+        len -= n;
+    }
+}
+
+static void tx_next(void)
+{
+    while (atomic_cas(&tx_busy, 0, 1)) {
+        struct net_buf *buf = k_fifo_get(&tx_fifo, K_NO_WAIT);
+        int err;
+
+        if (buf == NULL) {
+            atomic_clear(&tx_busy);
+            /* A frame queued before the flag was cleared would be left behind. */
+            if (k_fifo_is_empty(&tx_fifo)) {
+                return;
+            }
+            continue;
+        }
+
+        tx_buf = buf;
+        err = uart_tx(uart, buf->data, buf->len, SYS_FOREVER_US);
+        if (err == 0) {
+            return;
+        }
+
+        LOG_WRN("TX failed (%d)", err);
+        tx_buf = NULL;
+        net_buf_unref(buf);
+        atomic_clear(&tx_busy);
+    }
+}
+
+static void uart_cb(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(user_data);
+
+    switch (evt->type) {
+    case UART_TX_DONE:
+    case UART_TX_ABORTED:
+        net_buf_unref(tx_buf);
+        tx_buf = NULL;
+        atomic_clear(&tx_busy);
+        tx_next();
+        rx_resume();
+        break;
+    case UART_RX_RDY:
+        rx_chunk(&evt->data.rx.buf[evt->data.rx.offset], evt->data.rx.len);
+        break;
+    case UART_RX_BUF_REQUEST:
+        /* Left without one, the UART stops at the end of the current buffer. */
+        if (rx_room()) {
+            (void)uart_rx_buf_rsp(uart, rx_bufs[rx_next], sizeof(rx_bufs[0]));
+            rx_next ^= 1U;
+        }
+        break;
+    case UART_RX_STOPPED:
+        LOG_WRN("RX stopped (reason %d)", evt->data.rx_stop.reason);
+        break;
+    case UART_RX_DISABLED:
+        atomic_set(&rx_stalled, 1);
+        rx_resume();
+        break;
+    default:
+        break;
+    }
+}
+
+static int uart_bridge_init(void)
+{
+    struct uart_config cfg;
+    int err;
+
+    if (!device_is_ready(uart)) {
+        LOG_ERR("%s not ready", uart->name);
+        return -ENODEV;
+    }
+
+    if (uart_config_get(uart, &cfg) == 0) {
+        LOG_INF("%s: %u baud, flow control %s", uart->name, cfg.baudrate,
+                cfg.flow_ctrl == UART_CFG_FLOW_CTRL_RTS_CTS ? "RTS/CTS" : "off");
+    }
+
+    err = uart_callback_set(uart, uart_cb, NULL);
+    if (err == 0) {
+        err = rx_start();
+    }
+
+    if (err != 0) {
+        LOG_ERR("UART setup failed (%d)", err);
+    }
+
+    return err;
+}
+
+static struct net_buf *uart_bridge_recv(k_timeout_t timeout)
+{
+    struct net_buf *buf = k_fifo_get(&rx_fifo, timeout);
+
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK) && buf != NULL) {
+        pkt_track_set(buf, PKT_OWNER_APP);
+    }
+
+    return buf;
+}
+
+static void uart_bridge_release(struct net_buf *buf)
+{
+    if (buf != NULL) {
+        net_buf_unref(buf);
+    }
+    rx_resume();
+}
+
+static int uart_bridge_send(struct net_buf *buf)
+{
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_UART_TX);
+    }
+
+    k_fifo_put(&tx_fifo, buf);
+    tx_next();
+
+    return 0;
+}
+
+const struct transport uart_transport = {
+    .name = "uart",
+    .init = uart_bridge_init,
+    .recv = uart_bridge_recv,
+    .release = uart_bridge_release,
+    .send = uart_bridge_send,
+};
@@ -0,0 +1,315 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/usb/usbd.h>
+#include <zephyr/drivers/usb/udc.h>
+#include "pkt_pool.h"
+#include "pkt_track.h"
+#include "pressure.h"
+#include "stats.h"
+#include "trace.h"
+#include "transport.h"
+#include "usb_bridge.h"
+#include "usb_out.h"
+
+LOG_MODULE_REGISTER(usb_bridge, LOG_LEVEL_INF);
+
+#define USB_BRIDGE_MPS 64U
+
+struct usb_bridge_desc {
+    struct usb_if_descriptor if0;
+    struct usb_ep_descriptor if0_out_ep;
+    struct usb_ep_descriptor if0_in_ep;
+    struct usb_desc_header nil_desc;
+};
+
+struct usb_bridge_data {
+    struct usbd_class_data *c_data;
+    struct usb_bridge_desc *desc;
+    const struct usb_desc_header **fs_desc;
+    struct usb_out_ep out;
+    struct k_fifo rx_fifo;
+    /* Buffers in rx_fifo; a k_fifo keeps no count. */
+    atomic_t rx_queued;
+    atomic_t enabled;
+};
+
+static struct usb_bridge_desc bridge_desc = {
+    .if0 = {
+        .bLength = sizeof(struct usb_if_descriptor),
+        .bDescriptorType = USB_DESC_INTERFACE,
+        .bInterfaceNumber = 0,
+        .bAlternateSetting = 0,
+        .bNumEndpoints = 2,
+        .bInterfaceClass = USB_BCC_VENDOR,
+        .bInterfaceSubClass = 0,
+        .bInterfaceProtocol = 0,
+        .iInterface = 0,
+    },
+    .if0_out_ep = {
+        .bLength = sizeof(struct usb_ep_descriptor),
+        .bDescriptorType = USB_DESC_ENDPOINT,
+        .bEndpointAddress = 0x01,
+        .bmAttributes = USB_EP_TYPE_BULK,
+        .wMaxPacketSize = sys_cpu_to_le16(USB_BRIDGE_MPS),
+        .bInterval = 0,
+    },
+    .if0_in_ep = {
+        .bLength = sizeof(struct usb_ep_descriptor),
+        .bDescriptorType = USB_DESC_ENDPOINT,
+        .bEndpointAddress = 0x81,
+        .bmAttributes = USB_EP_TYPE_BULK,
+        .wMaxPacketSize = sys_cpu_to_le16(USB_BRIDGE_MPS),
+        .bInterval = 0,
+    },
+    .nil_desc = {
+        .bLength = 0,
+        .bDescriptorType = 0,
+    },
+};
+
+static const struct usb_desc_header *bridge_fs_desc[] = {
+    (struct usb_desc_header *)&bridge_desc.if0,
+    (struct usb_desc_header *)&bridge_desc.if0_out_ep,
+    (struct usb_desc_header *)&bridge_desc.if0_in_ep,
+    (struct usb_desc_header *)&bridge_desc.nil_desc,
+};
+
+/* Completion time of each received buffer, indexed by buffer ID. */
+static uint32_t rx_cycles[CONFIG_APP_PKT_COUNT];
+
+static struct usb_bridge_data bridge_data = {
+    .desc = &bridge_desc,
+    .fs_desc = bridge_fs_desc,
+};
+
+static uint8_t bridge_out_ep(const struct usb_bridge_data *data)
+{
+    return data->desc->if0_out_ep.bEndpointAddress;
+}
+
+static uint8_t bridge_in_ep(const struct usb_bridge_data *data)
+{
+    return data->desc->if0_in_ep.bEndpointAddress;
+}
+
+static int bridge_out_submit(void *ctx, struct net_buf *buf)
+{
+    struct usb_bridge_data *data = ctx;
+
+    if (!atomic_get(&data->enabled)) {
+        return -EPERM;
+    }
+
+    udc_get_buf_info(buf)->ep = bridge_out_ep(data);
+
+    return usbd_ep_enqueue(data->c_data, buf);
+}
+
+static int bridge_request(struct usbd_class_data *const c_data,
+                          struct net_buf *buf, int err)
+{
+    struct usb_bridge_data *data = usbd_class_get_private(c_data);
+    struct udc_buf_info *bi = udc_get_buf_info(buf);
+
+    if (bi->ep == bridge_out_ep(data)) {
+        atomic_val_t starved = atomic_get(&data->out.starved);
+
+        buf = usb_out_ep_done(&data->out, buf, err);
+
+        if (atomic_get(&data->out.starved) != starved) {
+            stats_add(STATS_USB_STARVED, 1);
+        }
+
+        if (buf != NULL) {
+            rx_cycles[net_buf_id(buf)] = k_cycle_get_32();
+            stats_add(STATS_USB_RX_XFERS, 1);
+            stats_add(STATS_USB_RX_BYTES, buf->len);
+
+            /* Not traced while pool pressure has capture off. */
+            if (IS_ENABLED(CONFIG_APP_TRACE) &&
+                (!IS_ENABLED(CONFIG_APP_PRESSURE) || pressure_policy()->capture)) {
+                trace_begin(buf);
+                trace_mark(buf, TRACE_USB_RX, (uint8_t)atomic_get(&data->out.armed));
+            }
+            if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+                pkt_track_set(buf, PKT_OWNER_USB_RX);
+            }
+            atomic_inc(&data->rx_queued);
+            k_fifo_put(&data->rx_fifo, buf);
+        }
+        return 0;
+    }
+
+    if (err != 0 && err != -ECONNABORTED) {
+        LOG_WRN("IN transfer failed (%d)", err);
+    }
+
+    net_buf_unref(buf);
+
+    return 0;
+}
+
+static void bridge_enable(struct usbd_class_data *const c_data)
+{
+    struct usb_bridge_data *data = usbd_class_get_private(c_data);
+
+    atomic_set(&data->enabled, 1);
+    usb_out_ep_arm(&data->out);
+}
+
+static void bridge_disable(struct usbd_class_data *const c_data)
+{
+    struct usb_bridge_data *data = usbd_class_get_private(c_data);
+
+    atomic_set(&data->enabled, 0);
+    LOG_INF("OUT: %ld transfers, %ld bytes, starved %ld times",
+            atomic_get(&data->out.rx_xfers), atomic_get(&data->out.rx_bytes),
+            atomic_get(&data->out.starved));
+}
+
+static void *bridge_get_desc(struct usbd_class_data *const c_data,
+                             const enum usbd_speed speed)
+{
+    struct usb_bridge_data *data = usbd_class_get_private(c_data);
+
+    ARG_UNUSED(speed);
+
+    return data->fs_desc;
+}
+
+static int bridge_init(struct usbd_class_data *const c_data)
+{
+    struct usb_bridge_data *data = usbd_class_get_private(c_data);
+
+    data->c_data = c_data;
+    k_fifo_init(&data->rx_fifo);
+    atomic_set(&data->rx_queued, 0);
+    usb_out_ep_init(&data->out, CONFIG_APP_USB_OUT_DEPTH, bridge_out_submit,
+                    data);
+
+    return 0;
+}
+
+static const struct usbd_class_api bridge_api = {
+    .request = bridge_request,
+    .enable = bridge_enable,
+    .disable = bridge_disable,
+    .get_desc = bridge_get_desc,
+    .init = bridge_init,
+};
+
+USBD_DEFINE_CLASS(usb_bridge_0, &bridge_api, &bridge_data, NULL);
+
+USBD_DEVICE_DEFINE(bridge_usbd, DEVICE_DT_GET(DT_NODELABEL(zephyr_udc0)),
+                   CONFIG_APP_USB_VID, CONFIG_APP_USB_PID);
+
+USBD_DESC_LANG_DEFINE(bridge_lang);
+USBD_DESC_MANUFACTURER_DEFINE(bridge_mfr, "ooonak");
+USBD_DESC_PRODUCT_DEFINE(bridge_product, "Dongle Bridge");
+USBD_DESC_CONFIG_DEFINE(bridge_fs_cfg_desc, "FS Configuration");
+USBD_CONFIGURATION_DEFINE(bridge_fs_config, 0, 125, &bridge_fs_cfg_desc);
+
+int usb_bridge_init(void)
+{
+    int err;
+
+    err = usbd_add_descriptor(&bridge_usbd, &bridge_lang);
+    if (err == 0) {
+        err = usbd_add_descriptor(&bridge_usbd, &bridge_mfr);
+    }
+    if (err == 0) {
+        err = usbd_add_descriptor(&bridge_usbd, &bridge_product);
+    }
+    if (err == 0) {
+        err = usbd_add_configuration(&bridge_usbd, USBD_SPEED_FS,
+                                     &bridge_fs_config);
+    }
+    if (err == 0) {
+        err = usbd_register_class(&bridge_usbd, "usb_bridge_0", USBD_SPEED_FS, 1);
+    }
+    if (err == 0) {
+        err = usbd_init(&bridge_usbd);
+    }
+    if (err == 0) {
+        err = usbd_enable(&bridge_usbd);
+    }
+
+    if (err != 0) {
+        LOG_ERR("USB device setup failed (%d)", err);
+    }
+
+    return err;
+}
+
+struct net_buf *usb_bridge_recv(k_timeout_t timeout)
+{
+    struct net_buf *buf = k_fifo_get(&bridge_data.rx_fifo, timeout);
+    atomic_val_t depth;
+
+    if (buf == NULL) {
+        return NULL;
+    }
+
+    /* Including the one just taken. */
+    depth = atomic_dec(&bridge_data.rx_queued);
+    if (IS_ENABLED(CONFIG_APP_TRACE)) {
+        trace_mark(buf, TRACE_APP_RX, (uint8_t)MIN(depth, UINT8_MAX));
+    }
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_APP);
+    }
+
+    return buf;
+}
+
+void usb_bridge_release(struct net_buf *buf)
+{
+    if (buf != NULL) {
+        uint32_t held = k_cycle_get_32() - rx_cycles[net_buf_id(buf)];
+
+        stats_observe(STATS_HIST_HOLD_US, k_cyc_to_us_floor32(held));
+        net_buf_unref(buf);
+    }
+    usb_out_ep_arm(&bridge_data.out);
+}
+
+int usb_bridge_send(struct net_buf *buf)
+{
+    uint16_t len = buf->len;
+    int err;
+
+    if (!atomic_get(&bridge_data.enabled)) {
+        net_buf_unref(buf);
+        return -EPERM;
+    }
+
+    udc_get_buf_info(buf)->ep = bridge_in_ep(&bridge_data);
+    /*
+     * A transfer that ends on a full packet needs a ZLP, or the host's
+     * read waits for the next frame to end it.
+     */
+    udc_get_buf_info(buf)->zlp = len > 0 && len % USB_BRIDGE_MPS == 0;
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_USB_IN);
+    }
+
+    err = usbd_ep_enqueue(bridge_data.c_data, buf);
+    if (err != 0) {
+        net_buf_unref(buf);
+        return err;
+    }
+
+    stats_add(STATS_USB_TX_BYTES, len);
+
+    return 0;
+}
+
+const struct transport usb_transport = {
+    .name = "usb",
+    .init = usb_bridge_init,
+    .recv = usb_bridge_recv,
+    .release = usb_bridge_release,
+    .send = usb_bridge_send,
+};
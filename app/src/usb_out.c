@@ -0,0 +1,59 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include "pkt_pool.h"
+#include "pkt_track.h"
+#include "usb_out.h"
+
+void usb_out_ep_init(struct usb_out_ep *ep, uint8_t depth,
+                     usb_out_submit_t submit, void *ctx)
+{
+    ep->submit = submit;
+    ep->ctx = ctx;
+    ep->depth = depth;
+    atomic_set(&ep->armed, 0);
+    atomic_set(&ep->starved, 0);
+    atomic_set(&ep->rx_xfers, 0);
+    atomic_set(&ep->rx_bytes, 0);
+}
+
+int usb_out_ep_arm(struct usb_out_ep *ep)
+{
+    while (atomic_inc(&ep->armed) < ep->depth) {
+        struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+        if (IS_ENABLED(CONFIG_APP_PKT_TRACK) && buf != NULL) {
+            pkt_track_set(buf, PKT_OWNER_USB_OUT);
+        }
+        if (buf == NULL || ep->submit(ep->ctx, buf) != 0) {
+            if (buf != NULL) {
+                net_buf_unref(buf);
+            }
+            break;
+        }
+    }
+
+    return atomic_dec(&ep->armed) - 1;
+}
+
+struct net_buf *usb_out_ep_done(struct usb_out_ep *ep, struct net_buf *buf,
+                                int err)
+{
+    atomic_dec(&ep->armed);
+
+    /* Re-arm before handing the data on so the endpoint is never idle
+     * while the application works on this transfer.
+     */
+    if (err != -ECONNABORTED && usb_out_ep_arm(ep) == 0) {
+        atomic_inc(&ep->starved);
+    }
+
+    if (err != 0 || buf->len == 0) {
+        net_buf_unref(buf);
+        return NULL;
+    }
+
+    atomic_inc(&ep->rx_xfers);
+    atomic_add(&ep->rx_bytes, buf->len);
+
+    return buf;
+}
@@ -0,0 +1,123 @@
+#include <zephyr/kernel.h>
+#include "pkt_track.h"
+#include "stats.h"
+#include "worker.h"
+
+/* Deadline of each queued frame in cycles, indexed by buffer ID. */
+static uint32_t due_cycles[CONFIG_APP_PKT_COUNT];
+
+static void worker_deadline(struct worker *w, uint32_t due, uint32_t now)
+{
+#if defined(CONFIG_SCHED_DEADLINE)
+    /* Relative to now; one already due stays ahead of any still to come. */
+    k_thread_deadline_set(&w->thread, MAX((int32_t)(due - now), 0));
+#else
+    ARG_UNUSED(w);
+    ARG_UNUSED(due);
+    ARG_UNUSED(now);
+#endif
+}
+
+static struct net_buf *worker_head(struct worker *w)
+{
+    sys_snode_t *node = sys_slist_peek_head(&w->queue);
+
+    return node != NULL ? CONTAINER_OF(node, struct net_buf, node) : NULL;
+}
+
+static void worker_run(void *p1, void *p2, void *p3)
+{
+    struct worker *w = p1;
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (true) {
+        struct net_buf *buf;
+        struct net_buf *next;
+        k_spinlock_key_t key;
+        uint32_t due;
+        uint32_t now;
+        int32_t late;
+
+        (void)k_sem_take(&w->ready, K_FOREVER);
+
+        key = k_spin_lock(&w->lock);
+        buf = CONTAINER_OF(sys_slist_get(&w->queue), struct net_buf, node);
+        k_spin_unlock(&w->lock, key);
+
+        due = due_cycles[net_buf_id(buf)];
+        w->fn(w->ctx, buf);
+
+        now = k_cycle_get_32();
+        late = (int32_t)(now - due);
+
+        key = k_spin_lock(&w->lock);
+        w->pending--;
+        w->stats.frames++;
+        if (late > 0) {
+            w->stats.misses++;
+            w->stats.max_late_us = MAX(w->stats.max_late_us, k_cyc_to_us_ceil32(late));
+        }
+        next = worker_head(w);
+        if (w->edf && next != NULL) {
+            worker_deadline(w, due_cycles[net_buf_id(next)], now);
+        }
+        k_spin_unlock(&w->lock, key);
+
+        if (late > 0) {
+            stats_add(STATS_DEADLINE_MISSES, 1);
+        }
+        if (w->edf && next != NULL) {
+            /* A later deadline does not give up the CPU by itself. */
+            k_yield();
+        }
+    }
+}
+
+void worker_start(struct worker *w, k_thread_stack_t *stack, size_t stack_size, int prio,
+                  bool edf, worker_fn_t fn, void *ctx, const char *name)
+{
+    sys_slist_init(&w->queue);
+    k_sem_init(&w->ready, 0, K_SEM_MAX_LIMIT);
+    w->fn = fn;
+    w->ctx = ctx;
+    w->edf = edf && IS_ENABLED(CONFIG_SCHED_DEADLINE);
+    w->pending = 0;
+    w->stats = (struct worker_stats){ 0 };
+
+    k_thread_create(&w->thread, stack, stack_size, worker_run, w, NULL, NULL, prio, 0,
+                    K_NO_WAIT);
+    k_thread_name_set(&w->thread, name);
+}
+
+void worker_submit(struct worker *w, struct net_buf *buf, uint32_t budget_us)
+{
+    uint32_t now = k_cycle_get_32();
+    uint32_t due = now + k_us_to_cyc_ceil32(budget_us);
+    k_spinlock_key_t key;
+
+    due_cycles[net_buf_id(buf)] = due;
+    if (IS_ENABLED(CONFIG_APP_PKT_TRACK)) {
+        pkt_track_set(buf, PKT_OWNER_WORKER);
+    }
+
+    key = k_spin_lock(&w->lock);
+    sys_slist_append(&w->queue, &buf->node);
+    /* A busy worker moves on to the head's deadline when it is done. */
+    if (w->pending++ == 0 && w->edf) {
+        worker_deadline(w, due, now);
+    }
+    k_spin_unlock(&w->lock, key);
+
+    k_sem_give(&w->ready);
+}
+
+void worker_stats(struct worker *w, struct worker_stats *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&w->lock);
+
+    *stats = w->stats;
+    w->stats = (struct worker_stats){ 0 };
+    k_spin_unlock(&w->lock, key);
+}
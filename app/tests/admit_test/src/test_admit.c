@@ -0,0 +1,114 @@
+#include <zephyr/ztest.h>
+#include "admit.h"
+
+/* 50 ms, the default CONFIG_APP_BT_CONN_INTERVAL. */
+#define INTERVAL 40U
+#define PDU_LEN  251U
+
+static const struct admit_policy policy = {
+    .budget_ppm = 800000U,
+    .new_rate = 8000U,
+    .margin_pct = 25U,
+    .downgrade = 4U,
+};
+
+ZTEST(admit_suite, test_air_times)
+{
+    zassert_equal(admit_pdu_us(ADMIT_PHY_1M, 251), 2088);
+    zassert_equal(admit_pdu_us(ADMIT_PHY_2M, 251), 1048);
+    zassert_equal(admit_pdu_us(ADMIT_PHY_2M, 0), 44);
+    /* 251 bytes plus a 4 byte MIC: the 17040 us of the specification. */
+    zassert_equal(admit_pdu_us(ADMIT_PHY_CODED_S8, 255), 17040);
+    zassert_true(admit_pdu_us(ADMIT_PHY_CODED_S2, 251) < admit_pdu_us(ADMIT_PHY_CODED_S8, 251));
+    zassert_equal(admit_exchange_us(ADMIT_PHY_2M, 251), 1048 + 150 + 44 + 150);
+}
+
+ZTEST(admit_suite, test_rate_estimate)
+{
+    struct admit_link link;
+
+    admit_link_init(&link, &policy, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+    zassert_equal(link.rate, policy.new_rate);
+
+    for (int i = 0; i < 30; i++) {
+        admit_observe(&link, 50000U, 500U);
+    }
+    zassert_within(link.rate, 100000U, 1000U);
+
+    for (int i = 0; i < 30; i++) {
+        admit_observe(&link, 0, 1000U);
+    }
+    zassert_within(link.rate, 0, 1000U);
+}
+
+ZTEST(admit_suite, test_link_air_time)
+{
+    struct admit_link link;
+
+    admit_link_init(&link, &policy, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+
+    /* An idle link still has its connection event. */
+    link.rate = 0;
+    zassert_equal(admit_link_ppm(&link, &policy), 1392U * 1000000U / 50000U);
+
+    /* 100 kB/s plus margin is 6250 bytes an interval: 25 PDUs. */
+    link.rate = 100000U;
+    zassert_equal(admit_link_ppm(&link, &policy), 25U * 1392U * 20U);
+
+    /* No more than fits in one interval. */
+    link.rate = 1000000U;
+    zassert_equal(admit_link_ppm(&link, &policy), 35U * 1392U * 20U);
+
+    link.phy = ADMIT_PHY_1M;
+    link.rate = 100000U;
+    zassert_true(admit_link_ppm(&link, &policy) > 25U * 1392U * 20U);
+}
+
+ZTEST(admit_suite, test_accept_downgrade_reject)
+{
+    struct admit_link links[4] = { 0 };
+    struct admit_link cand;
+
+    admit_link_init(&links[0], &policy, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+    links[0].rate = 100000U;
+
+    admit_link_init(&cand, &policy, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+    zassert_equal(admit_check(links, ARRAY_SIZE(links), &cand, &policy), ADMIT_ACCEPT);
+    zassert_equal(cand.interval, INTERVAL);
+    links[1] = cand;
+
+    /* The busy link and a new one leave no room for another at full rate. */
+    admit_link_init(&cand, &policy, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+    zassert_equal(admit_check(links, ARRAY_SIZE(links), &cand, &policy), ADMIT_DOWNGRADE);
+    zassert_equal(cand.interval, INTERVAL * policy.downgrade);
+    zassert_equal(cand.rate, 0);
+    links[2] = cand;
+
+    /* Once the busy link needs more, there is no room at all. */
+    links[0].rate = 110000U;
+    admit_link_init(&cand, &policy, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+    zassert_equal(admit_check(links, ARRAY_SIZE(links), &cand, &policy), ADMIT_REJECT);
+    zassert_true(admit_committed_ppm(links, ARRAY_SIZE(links), &policy) > policy.budget_ppm);
+
+    /* A link going away frees its share. */
+    links[0].active = false;
+    zassert_equal(admit_check(links, ARRAY_SIZE(links), &cand, &policy), ADMIT_ACCEPT);
+}
+
+ZTEST(admit_suite, test_no_downgrade)
+{
+    struct admit_policy strict = policy;
+    struct admit_link links[1];
+    struct admit_link cand;
+
+    strict.downgrade = 1U;
+    admit_link_init(&links[0], &strict, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+    links[0].rate = 120000U;
+
+    admit_link_init(&cand, &strict, ADMIT_PHY_2M, INTERVAL, PDU_LEN);
+    zassert_equal(admit_check(links, ARRAY_SIZE(links), &cand, &strict), ADMIT_REJECT);
+    zassert_equal(cand.interval, INTERVAL);
+    zassert_str_equal(admit_verdict_str(ADMIT_REJECT), "reject");
+}
+
+ZTEST_SUITE(admit_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,180 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include "agg.h"
+#include "cycles.h"
+
+#define BENCH_SAMPLES 1024
+
+static void put_samples(uint8_t *buf, const int16_t *samples, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        sys_put_le16((uint16_t)samples[i], &buf[2 * i]);
+    }
+}
+
+static int16_t get_sample(const uint8_t *buf, size_t i)
+{
+    return (int16_t)sys_get_le16(&buf[2 * i]);
+}
+
+ZTEST_SUITE(agg_suite, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(agg_suite, test_decimate)
+{
+    const int16_t in[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t buf[sizeof(in)];
+    struct agg_stage st;
+
+    zassert_ok(agg_init(&st, AGG_DECIMATE, 4));
+    put_samples(buf, in, ARRAY_SIZE(in));
+
+    zassert_equal(agg_process(&st, buf, sizeof(buf), buf), 4);
+    zassert_equal(get_sample(buf, 0), 1);
+    zassert_equal(get_sample(buf, 1), 5);
+}
+
+ZTEST(agg_suite, test_mean_rounds_to_nearest)
+{
+    const int16_t in[] = { 1, 2, -1, -2, 32767, 32767 };
+    uint8_t buf[sizeof(in)];
+    struct agg_stage st;
+
+    zassert_ok(agg_init(&st, AGG_MEAN, 2));
+    put_samples(buf, in, ARRAY_SIZE(in));
+
+    zassert_equal(agg_process(&st, buf, sizeof(buf), buf), 6);
+    zassert_equal(get_sample(buf, 0), 2);
+    zassert_equal(get_sample(buf, 1), -2);
+    zassert_equal(get_sample(buf, 2), 32767);
+}
+
+ZTEST(agg_suite, test_window_spans_calls)
+{
+    const int16_t a[] = { 5, -3, 9 };
+    const int16_t b[] = { 0, 4, 4 };
+    uint8_t buf[sizeof(a)];
+    struct agg_stage st;
+
+    zassert_ok(agg_init(&st, AGG_MAX, 4));
+
+    put_samples(buf, a, ARRAY_SIZE(a));
+    zassert_equal(agg_process(&st, buf, sizeof(buf), buf), 0);
+
+    put_samples(buf, b, ARRAY_SIZE(b));
+    zassert_equal(agg_process(&st, buf, sizeof(buf), buf), 2);
+    zassert_equal(get_sample(buf, 0), 9);
+}
+
+ZTEST(agg_suite, test_min_max_mean_in_place)
+{
+    const int16_t a[] = { 4, -8, 10 };
+    const int16_t b[] = { 2 };
+    const int16_t c[] = { 7, 7 };
+    uint8_t buf[sizeof(a)];
+    struct agg_stage st;
+
+    zassert_ok(agg_init(&st, AGG_MIN_MAX_MEAN, 4));
+
+    put_samples(buf, a, ARRAY_SIZE(a));
+    zassert_equal(agg_process(&st, buf, sizeof(buf), buf), 0);
+
+    /* The window completes on a one-sample packet: only one output fits. */
+    put_samples(buf, b, ARRAY_SIZE(b));
+    zassert_equal(agg_process(&st, buf, 2, buf), 2);
+    zassert_equal(get_sample(buf, 0), -8);
+
+    put_samples(buf, c, ARRAY_SIZE(c));
+    zassert_equal(agg_process(&st, buf, 4, buf), 4);
+    zassert_equal(get_sample(buf, 0), 10);
+    zassert_equal(get_sample(buf, 1), 2);
+}
+
+ZTEST(agg_suite, test_init_clears_pending)
+{
+    const int16_t a[] = { 4, -8, 10, 2 };
+    const int16_t b[] = { 6, 6 };
+    uint8_t buf[sizeof(a)];
+    struct agg_stage st;
+
+    /* Whatever the stack held before must not come out as outputs. */
+    memset(&st, 0xa5, sizeof(st));
+    zassert_ok(agg_init(&st, AGG_MIN_MAX_MEAN, 4));
+
+    /* A window done on its last sample leaves two outputs pending... */
+    put_samples(buf, a, ARRAY_SIZE(a));
+    zassert_equal(agg_process(&st, buf, sizeof(buf), buf), 2);
+    zassert_equal(get_sample(buf, 0), -8);
+
+    /* ...which a new setting drops. */
+    zassert_ok(agg_init(&st, AGG_MAX, 2));
+    put_samples(buf, b, ARRAY_SIZE(b));
+    zassert_equal(agg_process(&st, buf, 4, buf), 2);
+    zassert_equal(get_sample(buf, 0), 6);
+}
+
+ZTEST(agg_suite, test_invalid_window)
+{
+    struct agg_stage st;
+
+    zassert_equal(agg_init(&st, AGG_MEAN, 0), -EINVAL);
+    zassert_equal(agg_init(&st, AGG_MIN_MAX_MEAN, 2), -EINVAL);
+    zassert_equal(agg_channel_set(CONFIG_APP_AGG_CHANNELS, AGG_MEAN, 4), -EINVAL);
+}
+
+ZTEST(agg_suite, test_load_rules)
+{
+    /* chan | mode | window le16, as in a FTAB_AGG_RULES flash table. */
+    static const uint8_t rules[] = { 0, AGG_MAX, 2, 0, 1, AGG_MEAN, 0, 0 };
+    uint8_t buf[8];
+    struct net_buf nb = { .data = buf, .len = sizeof(buf) };
+    const int16_t in[] = { 3, 9, -4, 1 };
+
+    /* The second rule has no window; the first still holds. */
+    zassert_equal(agg_load_rules(rules, sizeof(rules)), -EINVAL);
+    zassert_equal(agg_load_rules(rules, 4), 1);
+
+    put_samples(buf, in, ARRAY_SIZE(in));
+    agg_channel_apply(0, &nb);
+    zassert_equal(nb.len, 4);
+    zassert_equal(get_sample(buf, 0), 9);
+    zassert_equal(get_sample(buf, 1), 1);
+
+    zassert_ok(agg_channel_set(0, AGG_NONE, 1));
+}
+
+ZTEST(agg_suite, test_bench)
+{
+    static const struct {
+        enum agg_mode mode;
+        uint16_t window;
+        const char *name;
+    } cases[] = {
+        { AGG_DECIMATE, 8, "decimate/8" },
+        { AGG_MEAN, 8, "mean/8" },
+        { AGG_MIN_MAX_MEAN, 16, "min-max-mean/16" },
+    };
+    static uint8_t buf[2 * BENCH_SAMPLES];
+
+    for (size_t c = 0; c < ARRAY_SIZE(cases); c++) {
+        struct agg_stage st;
+        uint64_t start;
+        uint32_t cycles;
+        size_t out;
+
+        for (size_t i = 0; i < BENCH_SAMPLES; i++) {
+            sys_put_le16((uint16_t)(i * 37U), &buf[2 * i]);
+        }
+
+        zassert_ok(agg_init(&st, cases[c].mode, cases[c].window));
+
+        start = cycles_now();
+        out = agg_process(&st, buf, sizeof(buf), buf);
+        cycles = (uint32_t)(cycles_now() - start);
+
+        TC_PRINT("%s: %u -> %u bytes (%u%% saved), %u cycles/sample\n",
+                 cases[c].name, (unsigned int)sizeof(buf), (unsigned int)out,
+                 (unsigned int)(100U - out * 100U / sizeof(buf)),
+                 cycles / BENCH_SAMPLES);
+    }
+}
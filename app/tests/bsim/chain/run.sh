@@ -0,0 +1,102 @@
+#!/bin/bash
+# Relay chain scenario: the bridge at one end, the reference peer at the
+# other and HOPS-1 relays between them in BabbleSim. Needs BSIM_OUT_PATH
+# and BSIM_COMPONENTS_PATH set up as for Zephyr's own BabbleSim tests.
+# Run from the workspace root.
+#
+#   HOPS="1 2 3 4" SIM_SECONDS=20 app/tests/bsim/chain/run.sh
+#
+# Relay k advertises as "Relay k" and connects on to relay k-1, relay 1
+# to the peer. Each hop count runs twice: with the peer as a source for
+# kbps, then echoing the bridge's probes for the round trip time. hop_us
+# is the one-way time per hop, half the RTT over the hops. relay_drops
+# counts frames the relays dropped under the source's load.
+
+set -euo pipefail
+
+HOPS=${HOPS:-"1 2 3 4"}
+SIM_SECONDS=${SIM_SECONDS:-20}
+SIM_ID=bridge_chain
+BIN=${BSIM_OUT_PATH}/bin
+
+# The name the node k hops from the peer connects to.
+target() {
+  if [ "$1" -le 1 ]; then
+    echo "Bridge Peer"
+  else
+    echo "Relay $(($1 - 1))"
+  fi
+}
+
+max=0
+for h in ${HOPS}; do
+  max=$((h > max ? h : max))
+done
+
+for h in ${HOPS}; do
+  west build -p -b nrf52_bsim -d "build/bsim-chain-${h}" app/tests/bsim/chain -- \
+    "-DCONFIG_APP_BT_PEER_NAME=\"$(target "${h}")\""
+  cp "build/bsim-chain-${h}/zephyr/zephyr.exe" "${BIN}/bs_nrf52_bsim_app_bsim_chain_${h}"
+done
+
+for k in $(seq 1 $((max - 1))); do
+  west build -p -b nrf52_bsim -d "build/bsim-relay-${k}" app/tests/bsim/chain -- \
+    -DEXTRA_CONF_FILE=relay.conf "-DCONFIG_BT_DEVICE_NAME=\"Relay ${k}\"" \
+    "-DCONFIG_APP_BT_PEER_NAME=\"$(target "${k}")\""
+  cp "build/bsim-relay-${k}/zephyr/zephyr.exe" "${BIN}/bs_nrf52_bsim_app_bsim_relay_${k}"
+done
+
+for mode in source echo; do
+  west build -p -b nrf52_bsim -d "build/bsim-peer-${mode}" peer -- \
+    "-DCONFIG_PEER_MODE_$(echo "${mode}" | tr a-z A-Z)=y"
+  cp "build/bsim-peer-${mode}/zephyr/zephyr.exe" "${BIN}/bs_nrf52_bsim_peer_${mode}"
+done
+
+cd "${BIN}"
+
+# Run the chain of h hops with the peer in the given mode; prints the
+# bridge's last report and what the relays dropped.
+run() {
+  local h=$1 mode=$2
+  local log
+  local pids=()
+  local drops=0
+
+  log=$(mktemp -d)
+
+  ./bs_nrf52_bsim_app_bsim_chain_${h} -s=${SIM_ID} -d=0 -RealEncryption=0 > "${log}/end" &
+  pids+=($!)
+
+  # Device d is relay h-d, so device numbers run along the chain.
+  for d in $(seq 1 $((h - 1))); do
+    ./bs_nrf52_bsim_app_bsim_relay_$((h - d)) -s=${SIM_ID} -d=${d} -RealEncryption=0 \
+      > "${log}/relay${d}" &
+    pids+=($!)
+  done
+
+  ./bs_nrf52_bsim_peer_${mode} -s=${SIM_ID} -d=${h} -RealEncryption=0 > /dev/null &
+  pids+=($!)
+
+  ./bs_2G4_phy_v1 -s=${SIM_ID} -D=$((h + 1)) -sim_length=$((SIM_SECONDS * 1000000)) > /dev/null
+
+  wait "${pids[@]}" || true
+
+  for d in $(seq 1 $((h - 1))); do
+    last=$(grep '^relay ' "${log}/relay${d}" | tail -n 1 || true)
+    down=$(echo "${last}" | sed -n 's/.*down_drops=\([0-9]*\).*/\1/p')
+    up=$(echo "${last}" | sed -n 's/.*up_drops=\([0-9]*\).*/\1/p')
+    drops=$((drops + ${down:-0} + ${up:-0}))
+  done
+
+  echo "$(grep '^up=' "${log}/end" | tail -n 1 || true) relay_drops=${drops}"
+  rm -rf "${log}"
+}
+
+for h in ${HOPS}; do
+  sourced=$(run "${h}" source)
+  kbps=$(echo "${sourced}" | sed -n 's/.* kbps=\([0-9]*\).*/\1/p')
+  drops=$(echo "${sourced}" | sed -n 's/.*relay_drops=\([0-9]*\).*/\1/p')
+  rtt=$(run "${h}" echo | sed -n 's/.*rtt_avg_us=\([0-9]*\).*/\1/p')
+  echo "hops=${h} kbps=${kbps:-0} rtt_avg_us=${rtt:-0} hop_us=$(( ${rtt:-0} / (2 * h) ))" \
+       "relay_drops=${drops:-0}"
+done
@@ -0,0 +1,128 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include "bt_central.h"
+#include "bt_relay.h"
+#include "frame.h"
+#include "pkt_pool.h"
+
+#define REPORT_MS 1000U
+
+#if defined(CONFIG_APP_RELAY)
+int main(void)
+{
+    struct bt_relay_stats last = { 0 };
+
+    if (bt_relay_start() != 0) {
+        return 0;
+    }
+
+    while (true) {
+        struct bt_relay_stats now;
+
+        k_msleep(REPORT_MS);
+
+        bt_relay_stats(&now);
+        printk("relay down_kbps=%u up_kbps=%u down_drops=%u up_drops=%u\n",
+               (now.down_bytes - last.down_bytes) * 8U / REPORT_MS,
+               (now.up_bytes - last.up_bytes) * 8U / REPORT_MS, now.down_drops,
+               now.up_drops);
+        last = now;
+    }
+
+    return 0;
+}
+#else
+/*
+ * The bridge at the end of the chain. It counts what the peer sends and
+ * times probe frames through the chain and back: with the peer in echo
+ * mode each comes back once it has crossed every hop twice. Simulated
+ * devices share one clock, so the RTT is the air and relay time alone.
+ */
+#define PROBE_MS    100U
+#define PROBE_MAGIC 0x43484e31U /* "CHN1" */
+#define PROBE_LEN   8U
+
+static atomic_t rx_bytes;
+static atomic_t probes;
+static atomic_t rtt_sum_us;
+static atomic_t rtt_max_us;
+
+static bool is_probe(const struct net_buf *buf, uint32_t *sent)
+{
+    struct frame_hdr hdr;
+
+    if (frame_get_hdr(buf->data, buf->len, &hdr) != 0 || hdr.type != FRAME_DATA ||
+        hdr.len != PROBE_LEN || buf->len != FRAME_HDR_SIZE + PROBE_LEN ||
+        sys_get_le32(&buf->data[FRAME_HDR_SIZE]) != PROBE_MAGIC) {
+        return false;
+    }
+
+    *sent = sys_get_le32(&buf->data[FRAME_HDR_SIZE + 4]);
+
+    return true;
+}
+
+static int peer_sink(struct net_buf *buf)
+{
+    uint32_t sent;
+
+    if (is_probe(buf, &sent)) {
+        uint32_t rtt = k_cyc_to_us_floor32(k_cycle_get_32() - sent);
+
+        atomic_inc(&probes);
+        atomic_add(&rtt_sum_us, rtt);
+        if (rtt > (uint32_t)atomic_get(&rtt_max_us)) {
+            atomic_set(&rtt_max_us, rtt);
+        }
+    } else {
+        atomic_add(&rx_bytes, buf->len);
+    }
+
+    net_buf_unref(buf);
+
+    return 0;
+}
+
+static void send_probe(void)
+{
+    struct frame_hdr hdr = { .chan = 0, .type = FRAME_DATA, .len = PROBE_LEN };
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    if (buf == NULL) {
+        return;
+    }
+
+    frame_put_hdr(net_buf_add(buf, FRAME_HDR_SIZE), &hdr);
+    net_buf_add_le32(buf, PROBE_MAGIC);
+    net_buf_add_le32(buf, k_cycle_get_32());
+    (void)bt_central_send(0, buf);
+}
+
+int main(void)
+{
+    bt_central_set_sink(peer_sink);
+    if (bt_central_start() != 0) {
+        return 0;
+    }
+
+    while (true) {
+        uint32_t n;
+
+        for (uint32_t t = 0; t < REPORT_MS; t += PROBE_MS) {
+            k_msleep(PROBE_MS);
+            if (bt_central_link_count() > 0) {
+                send_probe();
+            }
+        }
+
+        n = (uint32_t)atomic_set(&probes, 0);
+        printk("up=%u kbps=%u probes=%u rtt_avg_us=%u rtt_max_us=%u\n",
+               (unsigned int)bt_central_link_count(),
+               (uint32_t)atomic_set(&rx_bytes, 0) * 8U / REPORT_MS, n,
+               n > 0 ? (uint32_t)atomic_set(&rtt_sum_us, 0) / n : 0U,
+               (uint32_t)atomic_set(&rtt_max_us, 0));
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,48 @@
+#!/bin/bash
+# PAwR scenario: the bridge's PAwR train against N reference peers built as
+# PAwR nodes in BabbleSim. Needs BSIM_OUT_PATH and BSIM_COMPONENTS_PATH set
+# up as for Zephyr's own BabbleSim tests. Run from the workspace root.
+#
+#   NODES="10 50 100 200" SIM_SECONDS=30 app/tests/bsim/pawr/run.sh
+#
+# Compare with app/tests/bsim/scale/run.sh, which connects to each peer.
+# Every interval is 1 s by default, so latency is bounded by one interval
+# plus one subevent.
+
+set -euo pipefail
+
+NODES=${NODES:-"10 50 100 200"}
+SIM_SECONDS=${SIM_SECONDS:-30}
+SIM_ID=bridge_pawr
+BIN=${BSIM_OUT_PATH}/bin
+
+west build -p -b nrf52_bsim -d build/bsim-pawr app/tests/bsim/pawr
+cp build/bsim-pawr/zephyr/zephyr.exe "${BIN}/bs_nrf52_bsim_app_bsim_pawr"
+
+west build -p -b nrf52_bsim -d build/bsim-pawr-node peer -- \
+  -DEXTRA_CONF_FILE=overlays/pawr-node.conf
+cp build/bsim-pawr-node/zephyr/zephyr.exe "${BIN}/bs_nrf52_bsim_peer_pawr_node"
+
+cd "${BIN}"
+
+for n in ${NODES}; do
+  log=$(mktemp)
+  pids=()
+
+  ./bs_nrf52_bsim_app_bsim_pawr -s=${SIM_ID} -d=0 -RealEncryption=0 > "${log}" &
+  pids+=($!)
+
+  for d in $(seq 1 "${n}"); do
+    ./bs_nrf52_bsim_peer_pawr_node -s=${SIM_ID} -d=${d} -RealEncryption=0 > /dev/null &
+    pids+=($!)
+  done
+
+  ./bs_2G4_phy_v1 -s=${SIM_ID} -D=$((n + 1)) -sim_length=$((SIM_SECONDS * 1000000)) > /dev/null
+
+  wait "${pids[@]}" || true
+
+  # Nodes need a few intervals to sync and settle into free slots.
+  summary=$(grep '^nodes=' "${log}" | tail -n 1)
+  echo "n=${n} ${summary}"
+  rm -f "${log}"
+done
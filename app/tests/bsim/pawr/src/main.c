@@ -0,0 +1,113 @@
+#include <zephyr/kernel.h>
+#include <zephyr/kernel/thread.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/sys/byteorder.h>
+#include "frame.h"
+#include "pawr.h"
+#include "stats.h"
+
+#define REPORT_MS 1000U
+#define POSITIONS (CONFIG_APP_PAWR_SUBEVENTS * CONFIG_APP_PAWR_SLOTS)
+
+static ATOMIC_DEFINE(heard, POSITIONS);
+static atomic_t responses;
+static atomic_t latency_sum_ms;
+static atomic_t latency_max_ms;
+
+static uint32_t cpu_pct(void)
+{
+    static uint64_t last_total;
+    static uint64_t last_idle;
+    k_thread_runtime_stats_t stats;
+    uint64_t total;
+    uint64_t idle;
+
+    if (k_thread_runtime_stats_all_get(&stats) != 0) {
+        return 0;
+    }
+
+    total = stats.execution_cycles + stats.idle_cycles - last_total;
+    idle = stats.idle_cycles - last_idle;
+    last_total = stats.execution_cycles + stats.idle_cycles;
+    last_idle = stats.idle_cycles;
+
+    return total == 0 ? 0 : (uint32_t)(100U - idle * 100U / total);
+}
+
+/*
+ * Stands in for the USB link: decode each STATS_REC_PAWR record as the
+ * host would. Simulated devices share one clock, so the node's uptime
+ * stamp gives the latency from response to host.
+ */
+static int host_sink(struct net_buf *buf)
+{
+    uint32_t now = k_uptime_get_32();
+    const uint8_t *rec = &buf->data[FRAME_HDR_SIZE];
+    size_t len = buf->len - FRAME_HDR_SIZE;
+    size_t pos = 2;
+
+    if (len < 2 || rec[0] != STATS_REC_PAWR) {
+        net_buf_unref(buf);
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < rec[1] && pos + PAWR_RSP_HDR_SIZE <= len; i++) {
+        uint16_t position = sys_get_le16(&rec[pos]);
+        uint8_t rsp_len = rec[pos + 3];
+        const uint8_t *rsp = &rec[pos + PAWR_RSP_HDR_SIZE];
+
+        if (position < POSITIONS) {
+            atomic_set_bit(heard, position);
+        }
+
+        if (rsp_len >= PAWR_NODE_HDR_SIZE) {
+            uint32_t latency = now - sys_get_le32(&rsp[2]);
+
+            atomic_add(&latency_sum_ms, (atomic_val_t)latency);
+            if (latency > (uint32_t)atomic_get(&latency_max_ms)) {
+                atomic_set(&latency_max_ms, (atomic_val_t)latency);
+            }
+        }
+
+        atomic_inc(&responses);
+        pos += PAWR_RSP_HDR_SIZE + rsp_len;
+    }
+
+    net_buf_unref(buf);
+
+    return 0;
+}
+
+int main(void)
+{
+    if (bt_enable(NULL) != 0) {
+        return 0;
+    }
+
+    stats_set_sink(host_sink);
+
+    if (pawr_start() != 0) {
+        return 0;
+    }
+
+    while (true) {
+        uint32_t nodes = 0;
+        uint32_t count;
+        uint32_t sum;
+
+        k_msleep(REPORT_MS);
+
+        for (size_t i = 0; i < POSITIONS; i++) {
+            nodes += atomic_test_and_clear_bit(heard, i) ? 1U : 0U;
+        }
+
+        count = (uint32_t)atomic_set(&responses, 0);
+        sum = (uint32_t)atomic_set(&latency_sum_ms, 0);
+
+        printk("nodes=%u rsp_per_s=%u latency_avg_ms=%u latency_max_ms=%u cpu_pct=%u\n",
+               nodes, count * 1000U / REPORT_MS, count > 0 ? sum / count : 0U,
+               (uint32_t)atomic_set(&latency_max_ms, 0), cpu_pct());
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#!/bin/bash
+# Scalability scenario: the bridge central against N reference peers in
+# BabbleSim. Needs BSIM_OUT_PATH and BSIM_COMPONENTS_PATH set up as for
+# Zephyr's own BabbleSim tests. Run from the workspace root.
+#
+#   PEERS="1 5 10 20 30" SIM_SECONDS=20 app/tests/bsim/scale/run.sh
+#
+# PROFILE=nus runs the same sweep with the peers serving the Nordic UART
+# Service, to compare against the native L2CAP CoC profile.
+#
+# ADMIT=1 builds the bridge with admission control (admit.conf). Peers
+# beyond what the air time budget holds are then connected at a longer
+# interval or not at all; compare min_kbps, the slowest link, with and
+# without it.
+#
+# PHY_SEL=1 builds it with goodput-driven PHY selection (phy.conf) and
+# ATT=<dB> puts that much path loss between all devices (BabbleSim's
+# multiatt channel; peers transmit at 0 dBm). Sweep ATT with and without
+# PHY_SEL to compare total_kbps; coded= counts links that went to S=2.
+#
+#   for a in 60 88 92 96; do ATT=$a PHY_SEL=1 PEERS=4 app/tests/bsim/scale/run.sh; done
+#
+# OVERLAY=<path> adds a .conf to the bridge builds and DONGLE_BUILD moves
+# the dongle build, the one ram_static is taken from. scripts/bsim-bench.sh
+# sets both for scripts/bt-tune.py.
+
+set -euo pipefail
+
+PEERS=${PEERS:-"1 5 10 20 30"}
+SIM_SECONDS=${SIM_SECONDS:-20}
+PROFILE=${PROFILE:-l2cap}
+ADMIT=${ADMIT:-0}
+PHY_SEL=${PHY_SEL:-0}
+ATT=${ATT:-}
+OVERLAY=${OVERLAY:-}
+DONGLE_BUILD=${DONGLE_BUILD:-build/dongle-scale}
+SIM_ID=bridge_scale
+BIN=${BSIM_OUT_PATH}/bin
+
+app_files=()
+app_conf=()
+peer_conf=()
+if [ "${PROFILE}" = nus ]; then
+  app_files+=(nus.conf)
+  peer_conf=(-DEXTRA_CONF_FILE=overlays/nus.conf)
+fi
+if [ "${ADMIT}" = 1 ]; then
+  app_files+=(admit.conf)
+fi
+if [ "${PHY_SEL}" = 1 ]; then
+  app_files+=(phy.conf)
+  peer_conf+=(-DCONFIG_BT_CTLR_PHY_CODED=y)
+fi
+if [ -n "${OVERLAY}" ]; then
+  app_files+=("$(realpath "${OVERLAY}")")
+fi
+channel=()
+if [ -n "${ATT}" ]; then
+  channel=(-channel=multiatt -argschannel -at="${ATT}")
+fi
+if [ ${#app_files[@]} -gt 0 ]; then
+  app_conf=("-DEXTRA_CONF_FILE=$(IFS=';'; echo "${app_files[*]}")")
+fi
+
+west build -p -b nrf52_bsim -d build/bsim-scale app/tests/bsim/scale -- "${app_conf[@]}"
+cp build/bsim-scale/zephyr/zephyr.exe "${BIN}/bs_nrf52_bsim_app_bsim_scale"
+
+west build -p -b nrf52_bsim -d build/bsim-peer peer -- -DCONFIG_PEER_MODE_SOURCE=y "${peer_conf[@]}"
+cp build/bsim-peer/zephyr/zephyr.exe "${BIN}/bs_nrf52_bsim_peer_source"
+
+# The bsim executable is an x86 program, so take static RAM from the
+# same scenario built for the dongle.
+west build -p -b nrf52840dongle -d "${DONGLE_BUILD}" app/tests/bsim/scale -- "${app_conf[@]}"
+ram=$(west build -d "${DONGLE_BUILD}" -t ram_report | awk '$1 == "Root" { print $2; exit }')
+
+cd "${BIN}"
+
+for n in ${PEERS}; do
+  log=$(mktemp)
+  pids=()
+
+  ./bs_nrf52_bsim_app_bsim_scale -s=${SIM_ID} -d=0 -RealEncryption=0 > "${log}" &
+  pids+=($!)
+
+  for d in $(seq 1 "${n}"); do
+    ./bs_nrf52_bsim_peer_source -s=${SIM_ID} -d=${d} -RealEncryption=0 > /dev/null &
+    pids+=($!)
+  done
+
+  ./bs_2G4_phy_v1 -s=${SIM_ID} -D=$((n + 1)) -sim_length=$((SIM_SECONDS * 1000000)) \
+    "${channel[@]}" > /dev/null
+
+  wait "${pids[@]}" || true
+
+  summary=$(grep '^peers=' "${log}" | tail -n 1)
+  up=$(echo "${summary}" | sed -n 's/^peers=\([0-9]*\).*/\1/p')
+  setup=$(grep '^link=' "${log}" | sed -n 's/.*setup_ms=\([0-9]*\).*/\1/p' | sort -n | tail -n 1)
+  # The links of the last report.
+  min=$(grep '^link=' "${log}" | tail -n "${up:-0}" | sed -n 's/.* kbps=\([0-9]*\).*/\1/p' |
+        sort -n | head -n 1)
+  coded=$(grep '^link=' "${log}" | tail -n "${up:-0}" | grep -c 'phy=coded' || true)
+  admit=$(grep '^admit ' "${log}" | tail -n 1 | cut -d' ' -f2-)
+  echo "profile=${PROFILE} admit=${ADMIT} phy_sel=${PHY_SEL} att=${ATT:-0} n=${n} ${summary}" \
+       "min_kbps=${min:-0} coded=${coded} max_setup_ms=${setup:-0} ram_static=${ram} ${admit}"
+  rm -f "${log}"
+done
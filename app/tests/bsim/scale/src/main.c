@@ -0,0 +1,100 @@
+#include <zephyr/kernel.h>
+#include <zephyr/kernel/thread.h>
+#include "admit.h"
+#include "bt_central.h"
+
+#define REPORT_MS 1000U
+
+static const char *const phy_names[] = {
+    [ADMIT_PHY_1M] = "1m",
+    [ADMIT_PHY_2M] = "2m",
+    [ADMIT_PHY_CODED_S2] = "coded-s2",
+    [ADMIT_PHY_CODED_S8] = "coded-s8",
+};
+
+/* Jain's fairness index in percent: 100 when every link gets the same. */
+static uint32_t fairness_pct(const uint32_t *rates, size_t n)
+{
+    uint64_t sum = 0;
+    uint64_t sum_sq = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        sum += rates[i];
+        sum_sq += (uint64_t)rates[i] * rates[i];
+    }
+
+    if (sum_sq == 0) {
+        return 100;
+    }
+
+    return (uint32_t)(sum * sum * 100U / (n * sum_sq));
+}
+
+static uint32_t cpu_pct(void)
+{
+    static uint64_t last_total;
+    static uint64_t last_idle;
+    k_thread_runtime_stats_t stats;
+    uint64_t total;
+    uint64_t idle;
+
+    if (k_thread_runtime_stats_all_get(&stats) != 0) {
+        return 0;
+    }
+
+    total = stats.execution_cycles + stats.idle_cycles - last_total;
+    idle = stats.idle_cycles - last_idle;
+    last_total = stats.execution_cycles + stats.idle_cycles;
+    last_idle = stats.idle_cycles;
+
+    return total == 0 ? 0 : (uint32_t)(100U - idle * 100U / total);
+}
+
+int main(void)
+{
+    static uint32_t rates[CONFIG_BT_MAX_CONN];
+
+    if (bt_central_start() != 0) {
+        return 0;
+    }
+
+    while (true) {
+        struct bt_central_link_stats stats;
+        uint32_t total = 0;
+        size_t n = 0;
+
+        k_msleep(REPORT_MS);
+
+        for (size_t i = 0; bt_central_link_stats(i, &stats); i++) {
+            if (!stats.up) {
+                continue;
+            }
+
+            rates[n] = stats.rx_bytes * 8U / REPORT_MS;
+            total += rates[n];
+            printk("link=%u profile=%s kbps=%u setup_ms=%u mtu=%u interval=%u phy=%s "
+                   "rx_cycles_per_frame=%u tx_cycles_per_frame=%u\n",
+                   (unsigned int)i, stats.nus ? "nus" : "l2cap", rates[n], stats.setup_ms,
+                   stats.mtu, stats.interval,
+                   stats.phy < ARRAY_SIZE(phy_names) ? phy_names[stats.phy] : "?",
+                   stats.rx_frames > 0 ? stats.rx_cycles / stats.rx_frames : 0U,
+                   stats.tx_frames > 0 ? stats.tx_cycles / stats.tx_frames : 0U);
+            n++;
+        }
+
+        printk("peers=%u total_kbps=%u fairness_pct=%u cpu_pct=%u\n",
+               (unsigned int)n, total, n > 0 ? fairness_pct(rates, n) : 100U,
+               cpu_pct());
+
+        if (IS_ENABLED(CONFIG_APP_ADMIT)) {
+            struct bt_central_admit_stats admit;
+
+            bt_central_admit_stats(&admit);
+            printk("admit accepted=%u downgraded=%u rejected=%u committed_pct=%u\n",
+                   admit.accepted, admit.downgraded, admit.rejected,
+                   admit.committed_ppm / 10000U);
+        }
+    }
+
+    return 0;
+}
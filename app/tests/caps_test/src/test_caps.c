@@ -0,0 +1,153 @@
+#include <zephyr/ztest.h>
+#include <zephyr/net_buf.h>
+#include <app_version.h>
+#include "caps.h"
+#include "ctrl.h"
+#include "frame.h"
+
+NET_BUF_POOL_FIXED_DEFINE(test_pool, 1, FRAME_HDR_SIZE + CAPS_HELLO_SIZE, 0, NULL);
+
+static const struct caps fast = {
+    .version = APPVERSION,
+    .mtu = 249,
+    .features = CAPS_F_L2CAP_COC | CAPS_F_EATT | CAPS_F_COMPRESSION,
+    .batch = 8,
+    .credits = 16,
+    .dict = 0x1234,
+};
+
+static void assert_caps_equal(const struct caps *a, const struct caps *b)
+{
+    zassert_equal(a->version, b->version);
+    zassert_equal(a->mtu, b->mtu);
+    zassert_equal(a->features, b->features);
+    zassert_equal(a->batch, b->batch);
+    zassert_equal(a->credits, b->credits);
+    zassert_equal(a->dict, b->dict);
+}
+
+ZTEST(caps_suite, test_hello_round_trip)
+{
+    uint8_t hello[CAPS_HELLO_SIZE];
+    struct caps parsed;
+
+    zassert_equal(caps_put_hello(hello, sizeof(hello), &fast), sizeof(hello));
+    zassert_equal(caps_put_hello(hello, sizeof(hello) - 1U, &fast), 0);
+
+    zassert_ok(caps_parse_hello(hello, sizeof(hello), &parsed));
+    assert_caps_equal(&parsed, &fast);
+}
+
+ZTEST(caps_suite, test_older_peer_gets_defaults)
+{
+    /* A hello with only a version, as the first protocol release sent. */
+    uint8_t hello[] = { CAPS_OP_HELLO, CAPS_TAG_VERSION, 4, 0x00, 0x00, 0x00, 0x01 };
+    struct caps parsed;
+    struct caps session;
+
+    zassert_ok(caps_parse_hello(hello, sizeof(hello), &parsed));
+    zassert_equal(parsed.version, 0x01000000);
+    zassert_equal(parsed.mtu, CAPS_MTU_MIN);
+    zassert_equal(parsed.features, 0);
+
+    zassert_ok(caps_select(&fast, &parsed, &session));
+    zassert_equal(session.mtu, CAPS_MTU_MIN);
+    zassert_equal(session.features, 0);
+    zassert_equal(session.batch, 1);
+    zassert_equal(session.credits, 1);
+}
+
+ZTEST(caps_suite, test_newer_peer_fields_skipped)
+{
+    /* Unknown tag 0x70 and a VERSION value grown to 6 bytes. */
+    uint8_t hello[] = { CAPS_OP_HELLO, 0x70, 2, 0xaa, 0xbb,
+                        CAPS_TAG_VERSION, 6, 0x00, 0x00, 0x02, 0x01, 0xcc, 0xdd,
+                        CAPS_TAG_BATCH, 2, 0x04, 0x00 };
+    struct caps parsed;
+
+    zassert_ok(caps_parse_hello(hello, sizeof(hello), &parsed));
+    zassert_equal(parsed.version, 0x01020000);
+    zassert_equal(parsed.batch, 4);
+}
+
+ZTEST(caps_suite, test_malformed_hello)
+{
+    uint8_t no_version[] = { CAPS_OP_HELLO, CAPS_TAG_MTU, 2, 0xf4, 0x00 };
+    uint8_t short_field[] = { CAPS_OP_HELLO, CAPS_TAG_VERSION, 2, 0x00, 0x01 };
+    uint8_t other_op[] = { 0x01 };
+    struct caps parsed;
+
+    zassert_equal(caps_parse_hello(no_version, sizeof(no_version), &parsed), -EBADMSG);
+    zassert_equal(caps_parse_hello(short_field, sizeof(short_field), &parsed), -EBADMSG);
+    zassert_equal(caps_parse_hello(other_op, sizeof(other_op), &parsed), -ENOMSG);
+}
+
+ZTEST(caps_suite, test_select_is_symmetric)
+{
+    struct caps slow = {
+        .version = APPVERSION - 0x00010000 + 0x00020000,
+        .mtu = 100,
+        .features = CAPS_F_L2CAP_COC | CAPS_F_RELIABLE,
+        .batch = 16,
+        .credits = 4,
+    };
+    struct caps ab;
+    struct caps ba;
+
+    zassert_ok(caps_select(&fast, &slow, &ab));
+    zassert_ok(caps_select(&slow, &fast, &ba));
+    assert_caps_equal(&ab, &ba);
+
+    zassert_equal(ab.version, MIN(fast.version, slow.version));
+    zassert_equal(ab.mtu, 100);
+    zassert_equal(ab.features, CAPS_F_L2CAP_COC);
+    zassert_equal(ab.batch, 8);
+    zassert_equal(ab.credits, 4);
+}
+
+ZTEST(caps_suite, test_compression_needs_same_dict)
+{
+    struct caps other = fast;
+    struct caps session;
+
+    zassert_ok(caps_select(&fast, &other, &session));
+    zassert_true(session.features & CAPS_F_COMPRESSION);
+    zassert_equal(session.dict, 0x1234);
+
+    other.dict = 0x4321;
+    zassert_ok(caps_select(&fast, &other, &session));
+    zassert_false(session.features & CAPS_F_COMPRESSION);
+    zassert_equal(session.dict, 0);
+}
+
+ZTEST(caps_suite, test_major_mismatch)
+{
+    struct caps next = fast;
+    struct caps session;
+
+    next.version += 0x01000000;
+
+    zassert_equal(caps_select(&fast, &next, &session), -EPROTO);
+}
+
+ZTEST(caps_suite, test_hello_frame)
+{
+    struct net_buf *buf = net_buf_alloc(&test_pool, K_NO_WAIT);
+    struct frame_hdr hdr;
+    struct caps parsed;
+
+    zassert_not_null(buf);
+    zassert_ok(caps_add_hello(buf, 7, &fast));
+
+    zassert_ok(frame_get_hdr(buf->data, buf->len, &hdr));
+    zassert_equal(hdr.chan, 7);
+    zassert_equal(hdr.type, FRAME_CTRL);
+    zassert_equal(hdr.len, CAPS_HELLO_SIZE);
+    zassert_ok(caps_parse_hello(buf->data + FRAME_HDR_SIZE, hdr.len, &parsed));
+    zassert_equal(parsed.mtu, fast.mtu);
+
+    zassert_equal(caps_add_hello(buf, 7, &fast), -ENOMEM);
+    net_buf_unref(buf);
+}
+
+ZTEST_SUITE(caps_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,67 @@
+#include <zephyr/ztest.h>
+#include "ctrl.h"
+
+static struct ctrl_tlv seen[4];
+static size_t seen_count;
+
+static int collect(void *user, const struct ctrl_tlv *tlv)
+{
+    ARG_UNUSED(user);
+
+    if (seen_count == ARRAY_SIZE(seen)) {
+        return -ENOSPC;
+    }
+
+    seen[seen_count++] = *tlv;
+
+    return 0;
+}
+
+static void reset(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    seen_count = 0;
+}
+
+ZTEST_SUITE(ctrl_suite, NULL, NULL, reset, NULL, NULL);
+
+ZTEST(ctrl_suite, test_roundtrip)
+{
+    const uint8_t mtu[] = { 0xf7, 0x00 };
+    uint8_t buf[16] = { 0x42 };
+    size_t len = 1;
+    uint8_t op;
+
+    len += ctrl_put_tlv(&buf[len], sizeof(buf) - len, 1, mtu, sizeof(mtu));
+    len += ctrl_put_tlv(&buf[len], sizeof(buf) - len, 2, NULL, 0);
+
+    zassert_ok(ctrl_parse(buf, len, &op, collect, NULL));
+    zassert_equal(op, 0x42);
+    zassert_equal(seen_count, 2);
+    zassert_equal(seen[0].tag, 1);
+    zassert_mem_equal(seen[0].value, mtu, sizeof(mtu));
+    zassert_equal(seen[1].len, 0);
+}
+
+ZTEST(ctrl_suite, test_truncated)
+{
+    const uint8_t short_hdr[] = { 0x01, 0x05 };
+    const uint8_t short_value[] = { 0x01, 0x05, 0x03, 0xaa };
+    uint8_t op;
+
+    zassert_equal(ctrl_parse(short_hdr, 0, &op, collect, NULL), -EBADMSG);
+    zassert_equal(ctrl_parse(short_hdr, sizeof(short_hdr), &op, collect, NULL),
+                  -EBADMSG);
+    zassert_equal(ctrl_parse(short_value, sizeof(short_value), &op, collect, NULL),
+                  -EBADMSG);
+    zassert_equal(seen_count, 0);
+}
+
+ZTEST(ctrl_suite, test_put_overflow)
+{
+    uint8_t buf[3];
+
+    zassert_equal(ctrl_put_tlv(buf, sizeof(buf), 1, "ab", 2), 0);
+    zassert_equal(ctrl_put_tlv(buf, sizeof(buf), 1, "a", 1), 3);
+}
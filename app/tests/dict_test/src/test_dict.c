@@ -0,0 +1,218 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include "cycles.h"
+#include "dict.h"
+#include "frame.h"
+
+static const uint8_t trace[] = {
+#include "sample_trace.inc"
+};
+
+static uint8_t packed[CONFIG_APP_DICT_MAX_LEN];
+static uint8_t expanded[CONFIG_APP_DICT_MAX_LEN];
+
+static void assert_round_trip(const uint8_t *msg, size_t len)
+{
+    size_t n = dict_compress(msg, len, packed, sizeof(packed));
+
+    zassert_true(n > 0 && n < len, "%zu byte message not compressed", len);
+    zassert_equal(dict_decompress(packed, n, expanded, sizeof(expanded)), (int)len);
+    zassert_mem_equal(expanded, msg, len);
+}
+
+ZTEST(dict_suite, test_index_finds_every_position)
+{
+    zassert_not_equal(dict_builtin.id, 0);
+
+    for (size_t pos = 0; pos + 3U <= dict_builtin.size; pos++) {
+        uint16_t cand = dict_builtin.head[dict_hash(&dict_builtin.data[pos])];
+
+        while (cand != 0 && cand - 1U != pos) {
+            zassert_true(cand - 1U > pos, "chain not in descending order");
+            cand = dict_builtin.chain[cand - 1U];
+        }
+        zassert_equal(cand, pos + 1U, "position %zu not indexed", pos);
+    }
+}
+
+ZTEST(dict_suite, test_dictionary_and_self_matches)
+{
+    static const char json[] = "{\"id\":\"node-07\",\"seq\":412,\"t\":21.53,\"h\":40.2}";
+    static const char repeat[] = "abcdefghabcdefghabcdefghabcdefgh";
+    uint8_t copy[40];
+
+    assert_round_trip((const uint8_t *)json, sizeof(json) - 1U);
+    assert_round_trip((const uint8_t *)repeat, sizeof(repeat) - 1U);
+
+    /* The tail of the dictionary, first in its hash chains, is one match. */
+    memcpy(copy, &dict_builtin.data[dict_builtin.size - sizeof(copy)], sizeof(copy));
+    zassert_equal(dict_compress(copy, sizeof(copy), packed, sizeof(packed)), 3);
+    assert_round_trip(copy, sizeof(copy));
+}
+
+ZTEST(dict_suite, test_incompressible_is_left_alone)
+{
+    uint8_t noise[64];
+    uint32_t x = 0x12345678;
+
+    for (size_t i = 0; i < sizeof(noise); i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        noise[i] = (uint8_t)x;
+    }
+
+    zassert_equal(dict_compress(noise, sizeof(noise), packed, sizeof(packed)), 0);
+    zassert_equal(dict_compress(noise, 0, packed, sizeof(packed)), 0);
+}
+
+ZTEST(dict_suite, test_malformed_input)
+{
+    uint8_t short_literal[] = { 0x03, 'a', 'b' };
+    uint8_t short_match[] = { 0x80, 0x01 };
+    uint8_t zero_dist[] = { 0x80, 0x00, 0x00 };
+    uint8_t far_dist[] = { 0x00, 'a', 0x80, 0x00, 0x00 };
+    uint8_t ok[] = { 0x00, 'a', 0x81, 0x01, 0x00 };
+
+    sys_put_le16(dict_builtin.size + 2U, &far_dist[3]);
+
+    zassert_equal(dict_decompress(short_literal, sizeof(short_literal), expanded,
+                                  sizeof(expanded)), -EBADMSG);
+    zassert_equal(dict_decompress(short_match, sizeof(short_match), expanded,
+                                  sizeof(expanded)), -EBADMSG);
+    zassert_equal(dict_decompress(zero_dist, sizeof(zero_dist), expanded,
+                                  sizeof(expanded)), -EBADMSG);
+    zassert_equal(dict_decompress(far_dist, sizeof(far_dist), expanded,
+                                  sizeof(expanded)), -EBADMSG);
+
+    /* 'a' then five more copies of it, overlapping the output. */
+    zassert_equal(dict_decompress(ok, sizeof(ok), expanded, sizeof(expanded)), 6);
+    zassert_mem_equal(expanded, "aaaaaa", 6);
+    zassert_equal(dict_decompress(ok, sizeof(ok), expanded, 5), -ENOMEM);
+}
+
+ZTEST(dict_suite, test_pack_frame)
+{
+    static const char text[] = "<inf> peer: session: mtu 247 batch 8 credits 8 features 0x5";
+    uint8_t frame[FRAME_HDR_SIZE + CONFIG_APP_DICT_MAX_LEN + 1U];
+    uint8_t out[FRAME_HDR_SIZE + CONFIG_APP_DICT_MAX_LEN];
+    struct frame_hdr hdr = { .chan = 3, .type = FRAME_DATA, .len = sizeof(text) - 1U };
+    size_t len = FRAME_HDR_SIZE + hdr.len;
+    size_t packed_len;
+
+    frame_put_hdr(frame, &hdr);
+    memcpy(&frame[FRAME_HDR_SIZE], text, hdr.len);
+
+    packed_len = dict_pack_frame(frame, len);
+    zassert_true(packed_len < len);
+    zassert_ok(frame_get_hdr(frame, packed_len, &hdr));
+    zassert_equal(hdr.type, FRAME_DATA_DICT);
+    zassert_equal(hdr.chan, 3);
+
+    zassert_equal(dict_unpack_frame(frame, packed_len, out, sizeof(out)), (int)len);
+    zassert_ok(frame_get_hdr(out, len, &hdr));
+    zassert_equal(hdr.type, FRAME_DATA);
+    zassert_mem_equal(&out[FRAME_HDR_SIZE], text, hdr.len);
+
+    /* Control frames and payloads over the limit go out as they are. */
+    hdr.type = FRAME_CTRL;
+    frame_put_hdr(out, &hdr);
+    zassert_equal(dict_pack_frame(out, len), len);
+
+    hdr.type = FRAME_DATA;
+    hdr.len = CONFIG_APP_DICT_MAX_LEN + 1U;
+    frame_put_hdr(frame, &hdr);
+    memset(&frame[FRAME_HDR_SIZE], 'x', hdr.len);
+    zassert_equal(dict_pack_frame(frame, FRAME_HDR_SIZE + hdr.len), FRAME_HDR_SIZE + hdr.len);
+}
+
+ZTEST(dict_suite, test_table_in_place)
+{
+    static uint16_t tab[2U + 512U + DICT_HASH_SIZE + 1024U];
+    const struct dict *b = &dict_builtin;
+    uint8_t *raw = (uint8_t *)tab;
+    size_t head = 4U + ROUND_UP(b->size, 2U);
+    size_t len = head + (DICT_HASH_SIZE + b->size) * 2U;
+    struct dict d;
+
+    zassert_true(len <= sizeof(tab));
+
+    /* The builtin dictionary laid out as dict-train.py --table writes it. */
+    sys_put_le16(b->id, &raw[0]);
+    sys_put_le16(b->size, &raw[2]);
+    memcpy(&raw[4], b->data, b->size);
+    memcpy(&raw[head], b->head, DICT_HASH_SIZE * 2U);
+    memcpy(&raw[head + DICT_HASH_SIZE * 2U], b->chain, b->size * 2U);
+
+    zassert_ok(dict_from_table(raw, len, &d));
+    zassert_equal(d.id, b->id);
+    zassert_equal_ptr(d.data, &raw[4], "table was copied");
+
+    dict_use(&d);
+    zassert_equal_ptr(dict_active(), &d);
+    assert_round_trip(&b->data[b->size - 40U], 40U);
+    zassert_equal(dict_compress(&b->data[b->size - 40U], 40U, packed, sizeof(packed)), 3);
+    dict_use(&dict_builtin);
+
+    zassert_equal(dict_from_table(raw, len - 2U, &d), -EBADMSG);
+    zassert_equal(dict_from_table(&raw[1], len, &d), -EBADMSG);
+
+    /* A chain entry past the data would send the compressor out of bounds. */
+    sys_put_le16(b->size + 1U, &raw[len - 2U]);
+    zassert_equal(dict_from_table(raw, len, &d), -EBADMSG);
+}
+
+/*
+ * Ratio and cost over the recorded trace. Messages that do not compress
+ * count at their raw size, as they would go out on the link.
+ */
+ZTEST(dict_suite, test_trace_benchmark)
+{
+    uint64_t pack_cycles = 0;
+    uint64_t expand_cycles = 0;
+    uint32_t raw = 0;
+    uint32_t sent = 0;
+    uint32_t count = 0;
+    size_t pos = 0;
+    struct frame_hdr hdr;
+
+    while (frame_get_hdr(&trace[pos], sizeof(trace) - pos, &hdr) == 0 &&
+           pos + FRAME_HDR_SIZE + hdr.len <= sizeof(trace)) {
+        const uint8_t *msg = &trace[pos + FRAME_HDR_SIZE];
+        uint64_t start;
+        size_t n;
+
+        pos += FRAME_HDR_SIZE + hdr.len;
+        if (hdr.type == FRAME_CREDIT || hdr.len == 0 || hdr.len > CONFIG_APP_DICT_MAX_LEN) {
+            continue;
+        }
+
+        start = cycles_now();
+        n = dict_compress(msg, hdr.len, packed, sizeof(packed));
+        pack_cycles += cycles_now() - start;
+
+        if (n > 0) {
+            start = cycles_now();
+            zassert_equal(dict_decompress(packed, n, expanded, sizeof(expanded)), hdr.len);
+            expand_cycles += cycles_now() - start;
+            zassert_mem_equal(expanded, msg, hdr.len);
+        }
+
+        raw += hdr.len;
+        sent += n > 0 ? n : hdr.len;
+        count++;
+    }
+
+    zassert_equal(pos, sizeof(trace), "trace is not a clean frame stream");
+    zassert_true(count > 0);
+    zassert_true(sent < raw);
+
+    TC_PRINT("dict 0x%04x (%u bytes): %u messages, %u -> %u bytes, ratio %u.%03u, "
+             "compress %u cycles/msg, expand %u cycles/msg\n", dict_builtin.id,
+             dict_builtin.size, count,
+             raw, sent, sent / raw, (uint32_t)((uint64_t)sent * 1000U / raw % 1000U),
+             (uint32_t)(pack_cycles / count), (uint32_t)(expand_cycles / count));
+}
+
+ZTEST_SUITE(dict_suite, NULL, NULL, NULL, NULL, NULL);
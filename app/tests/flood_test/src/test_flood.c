@@ -0,0 +1,197 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+#include "credit.h"
+#include "frame.h"
+#include "pkt_pool.h"
+#include "usb_out.h"
+
+/*
+ * Flood benchmark for scripts/qsim.py. The host offers full frames faster
+ * than one link drains them; the pool, the USB OUT endpoint and the
+ * credit window are the bridge's own code, the bus, the dongle's frame
+ * handling and the connection events run on a clock stepped here. The
+ * rates are qsim.py's defaults, so its output can be checked with
+ *
+ *   qsim.py flood.csv --pool 16 --compare <this test's output>
+ *
+ * where flood.csv holds FLOOD_FRAMES rows "<n * FLOOD_GAP_US>,FLOOD_BYTES".
+ */
+#define FLOOD_FRAMES    1000U
+#define FLOOD_GAP_US    1000U
+#define FLOOD_BYTES     (CONFIG_APP_PKT_SIZE - FRAME_HDR_SIZE)
+
+#define STEP_US         10U
+#define HOST_QUEUE      64U
+#define USB_MBPS        8U
+#define PROC_US         20U
+#define INTERVAL_US     7500U
+#define PKTS_PER_EVENT  6U
+#define PEER_US         1000U
+
+/* Timestamps and buffers waiting between two stages, oldest first. */
+struct ring {
+    uintptr_t v[HOST_QUEUE];
+    size_t head;
+    size_t len;
+};
+
+static void ring_put(struct ring *r, uintptr_t v)
+{
+    r->v[(r->head + r->len++) % ARRAY_SIZE(r->v)] = v;
+}
+
+static uintptr_t ring_peek(const struct ring *r)
+{
+    return r->v[r->head];
+}
+
+static uintptr_t ring_take(struct ring *r)
+{
+    uintptr_t v = r->v[r->head];
+
+    r->head = (r->head + 1) % ARRAY_SIZE(r->v);
+    r->len--;
+
+    return v;
+}
+
+static struct ring host_q;
+static struct ring armed;
+static struct ring proc_q;
+static struct ring tx_q;
+/* Due times of frames the peer is consuming and of credit frames in flight. */
+static struct ring peer_q;
+static struct ring grant_q;
+static struct ring grant_n;
+
+static uint32_t latency_us[FLOOD_FRAMES];
+static size_t delivered;
+
+static int arm(void *ctx, struct net_buf *buf)
+{
+    ARG_UNUSED(ctx);
+
+    ring_put(&armed, (uintptr_t)buf);
+
+    return 0;
+}
+
+static uint32_t percentile(size_t pct)
+{
+    /* Insertion sort; the run is short. */
+    for (size_t i = 1; i < delivered; i++) {
+        uint32_t v = latency_us[i];
+        size_t j = i;
+
+        for (; j > 0 && latency_us[j - 1] > v; j--) {
+            latency_us[j] = latency_us[j - 1];
+        }
+        latency_us[j] = v;
+    }
+
+    return delivered > 0 ? latency_us[MIN(delivered - 1, pct * delivered / 100U)] : 0;
+}
+
+ZTEST(flood_suite, test_flood)
+{
+    struct usb_out_ep ep;
+    struct credit_tx tx;
+    struct credit_rx rx;
+    struct net_buf *usb_buf = NULL;
+    struct net_buf *proc_buf = NULL;
+    uint32_t usb_done = 0;
+    uint32_t proc_done = 0;
+    uint32_t next_event = 0;
+    uint32_t offered = 0;
+    uint32_t dropped = 0;
+    uint32_t loss;
+    uint32_t now;
+
+    credit_tx_init(&tx);
+    credit_rx_init(&rx, CONFIG_APP_CREDITS);
+    credit_tx_grant(&tx, CONFIG_APP_CREDITS);
+    usb_out_ep_init(&ep, CONFIG_APP_USB_OUT_DEPTH, arm, NULL);
+    usb_out_ep_arm(&ep);
+
+    for (now = 0; offered < FLOOD_FRAMES || host_q.len > 0 || usb_buf != NULL ||
+                  proc_q.len > 0 || proc_buf != NULL || tx_q.len > 0;
+         now += STEP_US) {
+        if (offered < FLOOD_FRAMES && now >= offered * FLOOD_GAP_US) {
+            if (host_q.len == HOST_QUEUE) {
+                dropped++;
+            } else {
+                ring_put(&host_q, offered * FLOOD_GAP_US);
+            }
+            offered++;
+        }
+
+        /* The host sends into the next armed buffer; transfers are serialised. */
+        if (usb_buf != NULL && now >= usb_done) {
+            usb_buf = usb_out_ep_done(&ep, usb_buf, 0);
+            zassert_not_null(usb_buf);
+            ring_put(&proc_q, (uintptr_t)usb_buf);
+            usb_buf = NULL;
+        }
+        if (usb_buf == NULL && host_q.len > 0 && armed.len > 0) {
+            usb_buf = (struct net_buf *)ring_take(&armed);
+            net_buf_add_le32(usb_buf, ring_take(&host_q));
+            net_buf_add(usb_buf, FRAME_HDR_SIZE + FLOOD_BYTES - sizeof(uint32_t));
+            usb_done = now + usb_buf->len * 8U / USB_MBPS;
+        }
+
+        if (proc_buf != NULL && now >= proc_done) {
+            ring_put(&tx_q, (uintptr_t)proc_buf);
+            proc_buf = NULL;
+        }
+        if (proc_buf == NULL && proc_q.len > 0) {
+            proc_buf = (struct net_buf *)ring_take(&proc_q);
+            proc_done = now + PROC_US;
+        }
+
+        if (now >= next_event) {
+            size_t sent = 0;
+
+            while (tx_q.len > 0 && sent < PKTS_PER_EVENT && credit_tx_take(&tx)) {
+                struct net_buf *buf = (struct net_buf *)ring_take(&tx_q);
+
+                latency_us[delivered++] = now - sys_get_le32(buf->data);
+                net_buf_unref(buf);
+                ring_put(&peer_q, now + PEER_US);
+                sent++;
+            }
+            if (sent > 0) {
+                usb_out_ep_arm(&ep);
+            }
+            next_event += INTERVAL_US;
+        }
+
+        while (peer_q.len > 0 && now >= ring_peek(&peer_q)) {
+            uint8_t grant;
+
+            ring_take(&peer_q);
+            grant = credit_rx_consumed(&rx);
+            if (grant > 0) {
+                /* Credit frames ride the next connection event back. */
+                ring_put(&grant_q, now + INTERVAL_US);
+                ring_put(&grant_n, grant);
+            }
+        }
+        while (grant_q.len > 0 && now >= ring_peek(&grant_q)) {
+            ring_take(&grant_q);
+            credit_tx_grant(&tx, ring_take(&grant_n));
+        }
+    }
+
+    loss = dropped * 10000U / offered;
+    TC_PRINT("offered=%u delivered=%u loss_pct=%u.%02u\n", offered, (uint32_t)delivered,
+             loss / 100U, loss % 100U);
+    TC_PRINT("latency_p50_us=%u latency_p99_us=%u run_us=%u starved=%ld\n", percentile(50),
+             percentile(99), now, atomic_get(&ep.starved));
+
+    zassert_equal(offered, delivered + dropped);
+    zassert_true(dropped > 0, "the flood outruns the link");
+    zassert_equal(pkt_pool_free_count() + armed.len, CONFIG_APP_PKT_COUNT);
+}
+
+ZTEST_SUITE(flood_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,113 @@
+#include <zephyr/ztest.h>
+#include "frame.h"
+
+#define MAX_FRAMES 8
+
+struct seen {
+    struct frame_hdr hdr;
+    uint8_t payload[8];
+};
+
+static struct seen frames[MAX_FRAMES];
+static size_t frame_count;
+
+static void on_frame(void *user, const struct frame_hdr *hdr,
+                     const uint8_t *payload)
+{
+    ARG_UNUSED(user);
+
+    zassert_true(frame_count < MAX_FRAMES);
+    frames[frame_count].hdr = *hdr;
+    memcpy(frames[frame_count].payload, payload, MIN(hdr->len, 8));
+    frame_count++;
+}
+
+static size_t put_frame(uint8_t *dst, uint8_t chan, uint8_t type,
+                        const char *payload)
+{
+    struct frame_hdr hdr = { .chan = chan, .type = type, .len = strlen(payload) };
+
+    frame_put_hdr(dst, &hdr);
+    memcpy(&dst[FRAME_HDR_SIZE], payload, hdr.len);
+
+    return FRAME_HDR_SIZE + hdr.len;
+}
+
+static void reset(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    frame_count = 0;
+}
+
+ZTEST_SUITE(frame_suite, NULL, NULL, reset, NULL, NULL);
+
+ZTEST(frame_suite, test_roundtrip)
+{
+    struct frame_decoder dec;
+    uint8_t buf[32];
+    size_t len;
+
+    frame_decoder_init(&dec, on_frame, NULL);
+
+    len = put_frame(buf, 3, FRAME_DATA, "hello");
+    len += put_frame(&buf[len], 4, FRAME_CTRL, "");
+    frame_decode(&dec, buf, len);
+
+    zassert_equal(frame_count, 2);
+    zassert_equal(frames[0].hdr.chan, 3);
+    zassert_equal(frames[0].hdr.len, 5);
+    zassert_mem_equal(frames[0].payload, "hello", 5);
+    zassert_equal(frames[1].hdr.type, FRAME_CTRL);
+    zassert_equal(frames[1].hdr.len, 0);
+    zassert_equal(dec.dropped, 0);
+}
+
+ZTEST(frame_suite, test_byte_by_byte)
+{
+    struct frame_decoder dec;
+    uint8_t buf[32];
+    size_t len;
+
+    frame_decoder_init(&dec, on_frame, NULL);
+    len = put_frame(buf, 1, FRAME_DATA, "abc");
+
+    for (size_t i = 0; i < len; i++) {
+        zassert_equal(frame_count, 0);
+        frame_decode(&dec, &buf[i], 1);
+    }
+
+    zassert_equal(frame_count, 1);
+    zassert_mem_equal(frames[0].payload, "abc", 3);
+}
+
+ZTEST(frame_suite, test_resync_after_garbage)
+{
+    struct frame_decoder dec;
+    uint8_t buf[32] = { 0x00, 0x11, FRAME_SYNC, 0x01, 0x7f };
+    size_t len = 5;
+
+    frame_decoder_init(&dec, on_frame, NULL);
+
+    /* Garbage, then a sync byte followed by an invalid type. */
+    len += put_frame(&buf[len], 2, FRAME_DATA, "ok");
+    frame_decode(&dec, buf, len);
+
+    zassert_equal(frame_count, 1);
+    zassert_equal(frames[0].hdr.chan, 2);
+    zassert_equal(dec.dropped, 5);
+}
+
+ZTEST(frame_suite, test_oversized_length_rejected)
+{
+    struct frame_hdr hdr = {
+        .chan = 0,
+        .type = FRAME_DATA,
+        .len = CONFIG_APP_FRAME_MAX_PAYLOAD + 1,
+    };
+    uint8_t buf[FRAME_HDR_SIZE];
+
+    frame_put_hdr(buf, &hdr);
+    zassert_equal(frame_get_hdr(buf, sizeof(buf), &hdr), -EBADMSG);
+    zassert_equal(frame_get_hdr(buf, 2, &hdr), -EAGAIN);
+}
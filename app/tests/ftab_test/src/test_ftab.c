@@ -0,0 +1,205 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include "cycles.h"
+#include "ftab.h"
+
+#define SLOT_SIZE 4096U
+
+struct tab {
+    uint16_t id;
+    const void *data;
+    size_t len;
+};
+
+static uint8_t slot_a[SLOT_SIZE] __aligned(4);
+static uint8_t slot_b[SLOT_SIZE] __aligned(4);
+
+static const uint8_t rules[] = { 0, 4, 0x10, 0x00, 1, 5, 0x40, 0x00 };
+static const uint8_t peers[] = {
+    0, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0,
+    1, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0,
+};
+
+/* Lay the tables out in an erased slot the way scripts/ftab-build.py does. */
+static size_t build(uint8_t *slot, uint32_t seq, const struct tab *tabs, size_t count)
+{
+    struct ftab_hdr hdr = { .magic = FTAB_MAGIC, .seq = seq };
+    size_t pos = ROUND_UP(FTAB_HDR_SIZE + FTAB_DIR_SIZE + count * FTAB_ENTRY_SIZE,
+                          FTAB_ALIGN);
+
+    memset(slot, 0xFF, SLOT_SIZE);
+    sys_put_le16((uint16_t)count, &slot[FTAB_HDR_SIZE]);
+    sys_put_le16(0, &slot[FTAB_HDR_SIZE + 2U]);
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *e = &slot[FTAB_HDR_SIZE + FTAB_DIR_SIZE + i * FTAB_ENTRY_SIZE];
+
+        sys_put_le16(tabs[i].id, e);
+        sys_put_le16(0, &e[2]);
+        sys_put_le32((uint32_t)pos, &e[4]);
+        sys_put_le32((uint32_t)tabs[i].len, &e[8]);
+        memcpy(&slot[pos], tabs[i].data, tabs[i].len);
+        pos = ROUND_UP(pos + tabs[i].len, FTAB_ALIGN);
+    }
+
+    hdr.len = (uint32_t)pos;
+    hdr.crc = ftab_crc(&hdr, &slot[FTAB_HDR_SIZE]);
+    ftab_put_hdr(slot, &hdr);
+
+    return pos;
+}
+
+/* Re-seal an image after the test changed it. */
+static void reseal(uint8_t *slot)
+{
+    struct ftab_hdr hdr;
+
+    ftab_get_hdr(slot, &hdr);
+    hdr.crc = ftab_crc(&hdr, &slot[FTAB_HDR_SIZE]);
+    ftab_put_hdr(slot, &hdr);
+}
+
+ZTEST(ftab_suite, test_find_in_place)
+{
+    const struct tab tabs[] = {
+        { FTAB_AGG_RULES, rules, sizeof(rules) },
+        { FTAB_PEERS, peers, sizeof(peers) },
+    };
+    struct ftab_hdr hdr;
+    const uint8_t *p;
+    size_t len;
+
+    build(slot_a, 7, tabs, ARRAY_SIZE(tabs));
+    zassert_ok(ftab_check(slot_a, SLOT_SIZE, &hdr));
+    zassert_equal(hdr.seq, 7);
+
+    p = ftab_find(slot_a, FTAB_PEERS, &len);
+    zassert_not_null(p);
+    zassert_true(p > slot_a && p < &slot_a[hdr.len], "table not in the image");
+    zassert_equal((uintptr_t)p % FTAB_ALIGN, 0);
+    zassert_equal(len, sizeof(peers));
+    zassert_mem_equal(p, peers, len);
+
+    p = ftab_find(slot_a, FTAB_AGG_RULES, &len);
+    zassert_not_null(p);
+    zassert_mem_equal(p, rules, sizeof(rules));
+
+    zassert_is_null(ftab_find(slot_a, FTAB_DICT, &len));
+}
+
+ZTEST(ftab_suite, test_torn_and_broken_images)
+{
+    const struct tab tabs[] = { { FTAB_PEERS, peers, sizeof(peers) } };
+    struct ftab_hdr hdr;
+    size_t len;
+    uint8_t *entry = &slot_a[FTAB_HDR_SIZE + FTAB_DIR_SIZE];
+
+    /* Erased, or interrupted before the header went in. */
+    memset(slot_a, 0xFF, SLOT_SIZE);
+    zassert_equal(ftab_check(slot_a, SLOT_SIZE, &hdr), -ENOENT);
+
+    len = build(slot_a, 1, tabs, 1);
+    slot_a[len - 1U] ^= 0x01;
+    zassert_equal(ftab_check(slot_a, SLOT_SIZE, &hdr), -EBADMSG);
+
+    build(slot_a, 1, tabs, 1);
+    zassert_equal(ftab_check(slot_a, len - 1U, &hdr), -EBADMSG);
+
+    /* A directory that points outside the image, even with a good crc. */
+    sys_put_le32((uint32_t)len, &entry[4]);
+    reseal(slot_a);
+    zassert_equal(ftab_check(slot_a, SLOT_SIZE, &hdr), -EBADMSG);
+
+    build(slot_a, 1, tabs, 1);
+    sys_put_le32(sys_get_le32(&entry[4]) + 2U, &entry[4]);
+    sys_put_le32(2U, &entry[8]);
+    reseal(slot_a);
+    zassert_equal(ftab_check(slot_a, SLOT_SIZE, &hdr), -EBADMSG);
+
+    build(slot_a, 1, tabs, 1);
+    sys_put_le16(40, &slot_a[FTAB_HDR_SIZE]);
+    reseal(slot_a);
+    zassert_equal(ftab_check(slot_a, SLOT_SIZE, &hdr), -EBADMSG);
+}
+
+ZTEST(ftab_suite, test_pick_newer_slot)
+{
+    const struct tab tabs[] = { { FTAB_AGG_RULES, rules, sizeof(rules) } };
+
+    memset(slot_a, 0xFF, SLOT_SIZE);
+    memset(slot_b, 0xFF, SLOT_SIZE);
+    zassert_equal(ftab_pick(slot_a, slot_b, SLOT_SIZE), -ENOENT);
+
+    build(slot_a, 5, tabs, 1);
+    zassert_equal(ftab_pick(slot_a, slot_b, SLOT_SIZE), 0);
+
+    build(slot_b, 6, tabs, 1);
+    zassert_equal(ftab_pick(slot_a, slot_b, SLOT_SIZE), 1);
+
+    /* An update of B that did not complete leaves A in use. */
+    slot_b[FTAB_HDR_SIZE + 8U] ^= 0x80;
+    zassert_equal(ftab_pick(slot_a, slot_b, SLOT_SIZE), 0);
+
+    build(slot_a, UINT32_MAX, tabs, 1);
+    build(slot_b, 0, tabs, 1);
+    zassert_equal(ftab_pick(slot_a, slot_b, SLOT_SIZE), 1, "seq wrap");
+}
+
+ZTEST(ftab_suite, test_peer_listed)
+{
+    static const uint8_t known[6] = { 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6 };
+    static const uint8_t other[6] = { 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC7 };
+
+    zassert_true(ftab_peer_listed(peers, sizeof(peers), 1, known));
+    zassert_false(ftab_peer_listed(peers, sizeof(peers), 0, known), "type differs");
+    zassert_false(ftab_peer_listed(peers, sizeof(peers), 1, other));
+    zassert_false(ftab_peer_listed(peers, FTAB_PEER_SIZE, 1, known));
+}
+
+/*
+ * What reading in place saves over copying the tables to RAM at boot:
+ * the bytes themselves, and the copy. The slots are checked either way.
+ */
+ZTEST(ftab_suite, test_boot_cost)
+{
+    static uint8_t big[3072];
+    static uint8_t ram[sizeof(big) + sizeof(peers)];
+    const struct tab tabs[] = {
+        { FTAB_PEERS, peers, sizeof(peers) },
+        { FTAB_DICT, big, sizeof(big) },
+    };
+    uint64_t check_cycles = UINT64_MAX;
+    uint64_t copy_cycles = UINT64_MAX;
+    const uint8_t *p;
+    size_t len;
+
+    for (size_t i = 0; i < sizeof(big); i++) {
+        big[i] = (uint8_t)(i * 31U);
+    }
+    build(slot_a, 1, tabs, ARRAY_SIZE(tabs));
+    build(slot_b, 2, tabs, ARRAY_SIZE(tabs));
+
+    for (int round = 0; round < 8; round++) {
+        uint64_t start = cycles_now();
+
+        zassert_equal(ftab_pick(slot_a, slot_b, SLOT_SIZE), 1);
+        check_cycles = MIN(check_cycles, cycles_now() - start);
+
+        start = cycles_now();
+        p = ftab_find(slot_b, FTAB_PEERS, &len);
+        memcpy(ram, p, len);
+        p = ftab_find(slot_b, FTAB_DICT, &len);
+        memcpy(&ram[sizeof(peers)], p, len);
+        copy_cycles = MIN(copy_cycles, cycles_now() - start);
+    }
+
+    zassert_mem_equal(&ram[sizeof(peers)], big, sizeof(big));
+
+    TC_PRINT("tables: %u bytes used in place instead of RAM, check %u cycles, "
+             "copy would add %u cycles\n", (uint32_t)sizeof(ram), (uint32_t)check_cycles,
+             (uint32_t)copy_cycles);
+}
+
+ZTEST_SUITE(ftab_suite, NULL, NULL, NULL, NULL, NULL);
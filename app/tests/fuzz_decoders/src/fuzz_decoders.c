@@ -0,0 +1,124 @@
+#include <zephyr/kernel.h>
+#include <zephyr/irq.h>
+#include "ctrl.h"
+#include "cycles.h"
+#include "dict.h"
+#include "frame.h"
+
+/*
+ * The first input byte selects the decoder, the rest is fed to it. Any
+ * decoder spending more than FUZZ_CYCLES_PER_BYTE per input byte (plus a
+ * fixed allowance) aborts the run, so super-linear paths show up as
+ * crashes just like memory errors do.
+ */
+#define FUZZ_CYCLES_PER_BYTE 2000U
+#define FUZZ_CYCLES_FIXED 200000U
+#define FUZZ_RUNS 3
+
+enum fuzz_target {
+    FUZZ_FRAME_STREAM,
+    FUZZ_FRAME_HDR,
+    FUZZ_CTRL,
+    FUZZ_DICT,
+    FUZZ_TARGET_COUNT,
+};
+
+/* Set by the native_sim libFuzzer glue before raising the fuzz IRQ. */
+extern const uint8_t *posix_fuzz_buf;
+extern size_t posix_fuzz_sz;
+
+static K_SEM_DEFINE(fuzz_sem, 0, 1);
+static struct frame_decoder decoder;
+static uint8_t expanded[CONFIG_APP_FRAME_MAX_PAYLOAD];
+static volatile size_t sink;
+
+static void on_frame(void *user, const struct frame_hdr *hdr,
+                     const uint8_t *payload)
+{
+    ARG_UNUSED(user);
+
+    sink += hdr->len + payload[0];
+}
+
+static int on_tlv(void *user, const struct ctrl_tlv *tlv)
+{
+    ARG_UNUSED(user);
+
+    sink += tlv->tag + tlv->len;
+
+    return 0;
+}
+
+static void run_target(enum fuzz_target target, const uint8_t *data, size_t len)
+{
+    struct frame_hdr hdr;
+    uint8_t op;
+
+    switch (target) {
+    case FUZZ_FRAME_STREAM:
+        /* Split the input in two to exercise reassembly across calls. */
+        frame_decoder_init(&decoder, on_frame, NULL);
+        frame_decode(&decoder, data, len / 2);
+        frame_decode(&decoder, &data[len / 2], len - len / 2);
+        break;
+    case FUZZ_FRAME_HDR:
+        (void)frame_get_hdr(data, len, &hdr);
+        break;
+    case FUZZ_CTRL:
+        (void)ctrl_parse(data, len, &op, on_tlv, NULL);
+        break;
+    default:
+        (void)dict_decompress(data, len, expanded, sizeof(expanded));
+        break;
+    }
+}
+
+static void fuzz_one(const uint8_t *data, size_t len)
+{
+    enum fuzz_target target;
+    uint64_t best = UINT64_MAX;
+    uint64_t bound;
+
+    if (len == 0) {
+        return;
+    }
+
+    target = data[0] % FUZZ_TARGET_COUNT;
+    data++;
+    len--;
+
+    /* Best of a few runs filters out host scheduling noise. */
+    for (int i = 0; i < FUZZ_RUNS; i++) {
+        uint64_t start = cycles_now();
+
+        run_target(target, data, len);
+        best = MIN(best, cycles_now() - start);
+    }
+
+    bound = FUZZ_CYCLES_FIXED + (uint64_t)FUZZ_CYCLES_PER_BYTE * len;
+    if (best > bound) {
+        printk("target %d: %llu cycles for %zu bytes (bound %llu)\n", target,
+               (unsigned long long)best, len, (unsigned long long)bound);
+        k_panic();
+    }
+}
+
+static void fuzz_isr(const void *arg)
+{
+    ARG_UNUSED(arg);
+
+    k_sem_give(&fuzz_sem);
+}
+
+int main(void)
+{
+    IRQ_CONNECT(CONFIG_ARCH_POSIX_FUZZ_IRQ, 0, fuzz_isr, NULL, 0);
+    irq_enable(CONFIG_ARCH_POSIX_FUZZ_IRQ);
+
+    while (true) {
+        k_sem_take(&fuzz_sem, K_FOREVER);
+        fuzz_one(posix_fuzz_buf, posix_fuzz_sz);
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <zephyr/ztest.h>
+#include "frame.h"
+#include "nus.h"
+
+#define MAX_PACKETS 64
+
+static uint16_t packet_len[MAX_PACKETS];
+static size_t packets;
+static int flush_err;
+static struct frame_decoder decoder;
+static size_t frames;
+
+static void on_frame(void *user, const struct frame_hdr *hdr, const uint8_t *payload)
+{
+    ARG_UNUSED(user);
+    ARG_UNUSED(payload);
+
+    zassert_equal(hdr->len, 30);
+    frames++;
+}
+
+static int capture(void *user, const uint8_t *data, uint16_t len)
+{
+    ARG_UNUSED(user);
+
+    if (flush_err != 0) {
+        return flush_err;
+    }
+
+    zassert_true(packets < MAX_PACKETS);
+    packet_len[packets++] = len;
+    frame_decode(&decoder, data, len);
+
+    return 0;
+}
+
+static void reset(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    packets = 0;
+    frames = 0;
+    flush_err = 0;
+    frame_decoder_init(&decoder, on_frame, NULL);
+}
+
+static size_t make_frame(uint8_t *dst)
+{
+    struct frame_hdr hdr = { .chan = 1, .type = FRAME_DATA, .len = 30 };
+
+    frame_put_hdr(dst, &hdr);
+    memset(&dst[FRAME_HDR_SIZE], 0x5a, hdr.len);
+
+    return FRAME_HDR_SIZE + hdr.len;
+}
+
+ZTEST(nus_suite, test_small_frames_share_packets)
+{
+    struct nus_packer p;
+    uint8_t frame[64];
+    size_t len = make_frame(frame);
+
+    nus_packer_init(&p, capture, NULL);
+    nus_packer_set_mtu(&p, 247);
+    zassert_equal(p.cap, NUS_PACKET_MAX);
+
+    /* 20 frames of 35 bytes: two full packets and a partial one. */
+    for (int i = 0; i < 20; i++) {
+        zassert_equal(nus_packer_write(&p, frame, len), len);
+    }
+    zassert_equal(packets, 2);
+    zassert_equal(packet_len[0], NUS_PACKET_MAX);
+    zassert_equal(packet_len[1], NUS_PACKET_MAX);
+
+    zassert_ok(nus_packer_flush(&p));
+    zassert_equal(packets, 3);
+    zassert_equal(packet_len[2], 20 * len - 2 * NUS_PACKET_MAX);
+    zassert_equal(frames, 20);
+}
+
+ZTEST(nus_suite, test_default_mtu_splits_frames)
+{
+    struct nus_packer p;
+    uint8_t frame[64];
+    size_t len = make_frame(frame);
+
+    nus_packer_init(&p, capture, NULL);
+    zassert_equal(p.cap, 20);
+
+    zassert_equal(nus_packer_write(&p, frame, len), len);
+    zassert_ok(nus_packer_flush(&p));
+
+    zassert_equal(packets, 2);
+    zassert_equal(packet_len[0], 20);
+    zassert_equal(packet_len[1], len - 20);
+    zassert_equal(frames, 1);
+}
+
+ZTEST(nus_suite, test_flush_failure_keeps_data)
+{
+    struct nus_packer p;
+    uint8_t frame[64];
+    size_t len = make_frame(frame);
+
+    nus_packer_init(&p, capture, NULL);
+
+    flush_err = -ENOMEM;
+    zassert_equal(nus_packer_write(&p, frame, len), 20);
+    zassert_equal(nus_packer_flush(&p), -ENOMEM);
+    zassert_equal(packets, 0);
+
+    flush_err = 0;
+    zassert_equal(nus_packer_write(&p, &frame[20], len - 20), len - 20);
+    zassert_ok(nus_packer_flush(&p));
+    zassert_equal(frames, 1);
+}
+
+ZTEST(nus_suite, test_tx_takes_whole_frames)
+{
+    struct nus_tx tx;
+    uint8_t frame[64];
+    size_t len = make_frame(frame);
+    size_t taken = 0;
+
+    nus_tx_init(&tx, capture, NULL);
+
+    /* The stack is full: frames wait until one no longer fits. */
+    flush_err = -ENOMEM;
+    while (nus_tx_frame(&tx, frame, len) == 0) {
+        taken++;
+    }
+    zassert_equal(taken, (NUS_TX_BACKLOG + 20) / len);
+    zassert_equal(packets, 0);
+    zassert_true(nus_tx_pump(&tx));
+
+    /* Once it has room, what was taken goes out whole and nothing else. */
+    flush_err = 0;
+    zassert_false(nus_tx_pump(&tx));
+    zassert_equal(frames, taken);
+    zassert_equal(decoder.fill, 0, "a frame was cut short");
+    zassert_equal(decoder.dropped, 0);
+
+    zassert_ok(nus_tx_frame(&tx, frame, len));
+    zassert_false(nus_tx_pump(&tx));
+    zassert_equal(frames, taken + 1);
+}
+
+ZTEST_SUITE(nus_suite, NULL, NULL, reset, NULL, NULL);
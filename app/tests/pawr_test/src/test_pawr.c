@@ -0,0 +1,95 @@
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include "pawr.h"
+
+#define SUBEVENTS 16U
+#define SLOTS     16U
+
+static struct pawr_batch batch;
+static uint8_t body[CONFIG_APP_FRAME_MAX_PAYLOAD];
+
+static void reset(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    pawr_batch_init(&batch);
+}
+
+ZTEST(pawr_suite, test_positions_cover_every_slot_once)
+{
+    static bool seen[SUBEVENTS * SLOTS];
+
+    for (uint8_t sub = 0; sub < SUBEVENTS; sub++) {
+        for (uint8_t slot = 0; slot < SLOTS; slot++) {
+            uint16_t pos = pawr_position(sub, slot, SUBEVENTS);
+
+            zassert_true(pos < ARRAY_SIZE(seen));
+            zassert_false(seen[pos]);
+            seen[pos] = true;
+
+            zassert_equal(pawr_subevent(pos, SUBEVENTS), sub);
+            zassert_equal(pawr_slot(pos, SUBEVENTS), slot);
+        }
+    }
+}
+
+ZTEST(pawr_suite, test_heard_bitmap)
+{
+    uint8_t bits[2] = { 0x01, 0x80 };
+
+    zassert_true(pawr_heard(bits, sizeof(bits), 0));
+    zassert_false(pawr_heard(bits, sizeof(bits), 1));
+    zassert_true(pawr_heard(bits, sizeof(bits), 15));
+    /* Slots past the bitmap were not heard. */
+    zassert_false(pawr_heard(bits, sizeof(bits), 16));
+}
+
+ZTEST(pawr_suite, test_batch_record_layout)
+{
+    uint8_t a[] = { 1, 2, 3 };
+    uint8_t b[] = { 9 };
+    size_t len;
+
+    zassert_ok(pawr_batch_add(&batch, 0x0102, -40, a, sizeof(a), 1000));
+    zassert_ok(pawr_batch_add(&batch, 7, -90, b, sizeof(b), 1500));
+    zassert_equal(batch.first_ms, 1000);
+
+    len = pawr_batch_take(&batch, body, sizeof(body));
+    zassert_equal(len, 1U + 2U * PAWR_RSP_HDR_SIZE + sizeof(a) + sizeof(b));
+    zassert_equal(body[0], 2);
+    zassert_equal(sys_get_le16(&body[1]), 0x0102);
+    zassert_equal((int8_t)body[3], -40);
+    zassert_equal(body[4], sizeof(a));
+    zassert_mem_equal(&body[5], a, sizeof(a));
+    zassert_equal(sys_get_le16(&body[8]), 7);
+    zassert_equal(body[11], sizeof(b));
+
+    /* Taking empties the batch. */
+    zassert_equal(pawr_batch_take(&batch, body, sizeof(body)), 0);
+}
+
+ZTEST(pawr_suite, test_batch_full)
+{
+    uint8_t rsp[PAWR_NODE_HDR_SIZE + 10] = { 0 };
+    size_t per = PAWR_RSP_HDR_SIZE + sizeof(rsp);
+    size_t fit = sizeof(batch.buf) / per;
+
+    for (size_t i = 0; i < fit; i++) {
+        zassert_ok(pawr_batch_add(&batch, i, 0, rsp, sizeof(rsp), 0));
+    }
+    zassert_equal(pawr_batch_add(&batch, 0, 0, rsp, sizeof(rsp), 0), -ENOSPC);
+
+    /* The record still fits one frame after the record type byte. */
+    zassert_true(pawr_batch_take(&batch, body, CONFIG_APP_FRAME_MAX_PAYLOAD - 1U) > 0);
+    zassert_ok(pawr_batch_add(&batch, 0, 0, rsp, sizeof(rsp), 0));
+}
+
+ZTEST(pawr_suite, test_oversized_response)
+{
+    static uint8_t big[UINT8_MAX];
+
+    zassert_equal(pawr_batch_add(&batch, 0, 0, big, sizeof(big), 0), -EMSGSIZE);
+    zassert_equal(batch.count, 0);
+}
+
+ZTEST_SUITE(pawr_suite, NULL, NULL, reset, NULL, NULL);
@@ -0,0 +1,91 @@
+#include <zephyr/ztest.h>
+#include "phy_sel.h"
+
+#define PDU_LEN 251U
+
+static const struct phy_sel_policy policy = {
+    .hyst_pct = 20U,
+    .confirm = 3U,
+    .dwell_ms = 2000U,
+};
+
+static struct phy_sel sel;
+
+static enum admit_phy window(int8_t rssi, uint32_t ok, uint32_t lost)
+{
+    struct phy_sel_sample sample = {
+        .ms = 1000U,
+        .ok = ok,
+        .lost = lost,
+        .rssi_valid = true,
+        .rssi = rssi,
+    };
+
+    return phy_sel_update(&sel, &sample, PDU_LEN, &policy);
+}
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    phy_sel_init(&sel, ADMIT_PHY_2M);
+}
+
+ZTEST(phy_sel_suite, test_model)
+{
+    zassert_equal(phy_sel_goodput(ADMIT_PHY_2M, PDU_LEN, 0), 1442);
+    zassert_equal(phy_sel_goodput(ADMIT_PHY_CODED_S2, PDU_LEN, 0), 383);
+    zassert_equal(phy_sel_goodput(ADMIT_PHY_2M, PDU_LEN, 1000), 0);
+
+    zassert_equal(phy_sel_model_per(ADMIT_PHY_2M, -60), 0);
+    zassert_equal(phy_sel_model_per(ADMIT_PHY_2M, -92), 666);
+    zassert_equal(phy_sel_model_per(ADMIT_PHY_2M, -110), 1000);
+    /* Coded S=2 still gets through where 2M is mostly lost. */
+    zassert_true(phy_sel_model_per(ADMIT_PHY_CODED_S2, -95) < 300);
+}
+
+ZTEST(phy_sel_suite, test_strong_link_stays)
+{
+    for (int i = 0; i < 20; i++) {
+        zassert_equal(window(-60, 1000U, 0), ADMIT_PHY_2M);
+    }
+}
+
+ZTEST(phy_sel_suite, test_weak_link_goes_coded)
+{
+    /* The second window ends the dwell time and is the first vote of three. */
+    for (int i = 0; i < 3; i++) {
+        zassert_equal(window(-95, 100U, 900U), ADMIT_PHY_2M, "switched in window %d", i);
+    }
+    zassert_equal(window(-95, 100U, 900U), ADMIT_PHY_CODED_S2);
+
+    /* S=2 delivers at this RSSI, so 2M does not look better from there. */
+    for (int i = 0; i < 10; i++) {
+        zassert_equal(window(-95, 750U, 250U), ADMIT_PHY_CODED_S2);
+    }
+
+    /* The signal recovers: back to 2M. */
+    for (int i = 0; i < 10 && sel.phy != ADMIT_PHY_2M; i++) {
+        (void)window(-80, 1000U, 0);
+    }
+    zassert_equal(sel.phy, ADMIT_PHY_2M);
+}
+
+ZTEST(phy_sel_suite, test_no_flapping)
+{
+    /* Around the RSSI where both PHYs promise about the same. */
+    for (int i = 0; i < 40; i++) {
+        zassert_equal(window(i % 2 ? -92 : -94, 0, 0), ADMIT_PHY_2M, "flapped in window %d",
+                      i);
+    }
+}
+
+ZTEST(phy_sel_suite, test_interference_stays)
+{
+    /* Loss at a strong RSSI is interference; coding does not beat it. */
+    for (int i = 0; i < 20; i++) {
+        zassert_equal(window(-60, 500U, 500U), ADMIT_PHY_2M);
+    }
+}
+
+ZTEST_SUITE(phy_sel_suite, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,86 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "cycles.h"
+#include "pkt_pool.h"
+
+/* An L2CAP SDU of the default CONFIG_APP_BT_RX_MTU. */
+#define FRAME_LEN 249U
+/* SDU length, L2CAP and ACL headers the BT host pushes on send. */
+#define BT_HDRS   10U
+
+ZTEST(pkt_pool_suite, test_room_for_both_stacks)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    zassert_not_null(buf);
+    zassert_equal(net_buf_headroom(buf), CONFIG_APP_PKT_HEADROOM);
+    zassert_equal(net_buf_tailroom(buf), CONFIG_APP_PKT_SIZE);
+    zassert_equal((uintptr_t)buf->data % 4U, 0, "data not word aligned");
+
+    net_buf_add(buf, FRAME_LEN);
+    zassert_not_null(net_buf_push(buf, BT_HDRS));
+
+    net_buf_unref(buf);
+}
+
+ZTEST(pkt_pool_suite, test_free_count)
+{
+    struct net_buf *bufs[CONFIG_APP_PKT_COUNT];
+
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT);
+
+    for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+        bufs[i] = pkt_alloc(K_NO_WAIT);
+        zassert_not_null(bufs[i]);
+    }
+
+    zassert_is_null(pkt_alloc(K_NO_WAIT));
+    zassert_equal(pkt_pool_free_count(), 0);
+
+    for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+        net_buf_unref(bufs[i]);
+    }
+
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT);
+}
+
+/*
+ * Cost of handing a received SDU from one stack to the other: with
+ * separate pools it is copied into a buffer of the other pool, with the
+ * shared pool the same buffer goes on.
+ */
+ZTEST(pkt_pool_suite, test_handoff_cost)
+{
+    uint64_t copy_cycles = UINT64_MAX;
+    uint64_t share_cycles = UINT64_MAX;
+
+    for (int round = 0; round < 16; round++) {
+        struct net_buf *rx = pkt_alloc(K_NO_WAIT);
+        struct net_buf *tx;
+        uint64_t start;
+
+        memset(net_buf_add(rx, FRAME_LEN), round, FRAME_LEN);
+
+        start = cycles_now();
+        tx = pkt_alloc(K_NO_WAIT);
+        net_buf_add_mem(tx, rx->data, rx->len);
+        (void)net_buf_push(tx, BT_HDRS);
+        net_buf_unref(tx);
+        copy_cycles = MIN(copy_cycles, cycles_now() - start);
+
+        start = cycles_now();
+        tx = net_buf_ref(rx);
+        (void)net_buf_push(tx, BT_HDRS);
+        net_buf_unref(tx);
+        share_cycles = MIN(share_cycles, cycles_now() - start);
+
+        net_buf_unref(rx);
+    }
+
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT);
+
+    TC_PRINT("%u byte frame: copy %u cycles, shared %u cycles\n", FRAME_LEN,
+             (uint32_t)copy_cycles, (uint32_t)share_cycles);
+}
+
+ZTEST_SUITE(pkt_pool_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,192 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "pkt_pool.h"
+#include "pkt_track.h"
+
+#define PRODUCERS    2
+#define FRAMES       2000
+#define HOARD        3
+#define HOLD_MS      50
+#define STACK_SIZE   1024
+/* Below the test thread, so its listing preempts the pipeline. */
+#define PIPELINE_PRIO K_PRIO_PREEMPT(5)
+
+K_FIFO_DEFINE(rx_fifo);
+K_FIFO_DEFINE(tx_fifo);
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, PRODUCERS + 2, STACK_SIZE);
+static struct k_thread threads[PRODUCERS + 2];
+static atomic_t done;
+
+static struct pkt_track_info list[CONFIG_APP_PKT_COUNT];
+
+static void assert_grouped(size_t n)
+{
+    for (size_t i = 1; i < n; i++) {
+        zassert_true(list[i - 1].owner <= list[i].owner, "owners out of order at %u",
+                     (unsigned int)i);
+        if (list[i - 1].owner == list[i].owner) {
+            zassert_true(list[i - 1].held_ms >= list[i].held_ms, "ages out of order at %u",
+                         (unsigned int)i);
+        }
+        zassert_not_equal(list[i].owner, PKT_OWNER_FREE);
+    }
+}
+
+/* USB OUT completion: a filled buffer queued for the pipeline. */
+static void producer(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    for (int i = 0; i < FRAMES; i++) {
+        struct net_buf *buf = pkt_alloc(K_FOREVER);
+
+        net_buf_add_u8(buf, (uint8_t)(uintptr_t)p1);
+        pkt_track_set(buf, PKT_OWNER_USB_RX);
+        k_fifo_put(&rx_fifo, buf);
+    }
+}
+
+static void worker(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    for (int i = 0; i < PRODUCERS * FRAMES; i++) {
+        struct net_buf *buf = k_fifo_get(&rx_fifo, K_FOREVER);
+
+        pkt_track_set(buf, PKT_OWNER_APP);
+        /* Some processing time, so the listing sees buffers in flight. */
+        k_busy_wait(20);
+        pkt_track_set(buf, PKT_OWNER_USB_IN);
+        k_fifo_put(&tx_fifo, buf);
+    }
+}
+
+/* USB IN completion. */
+static void sink(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    for (int i = 0; i < PRODUCERS * FRAMES; i++) {
+        net_buf_unref(k_fifo_get(&tx_fifo, K_FOREVER));
+        atomic_inc(&done);
+    }
+}
+
+ZTEST(pkt_track_suite, test_leak_shows_owner)
+{
+    struct net_buf *leak = pkt_alloc(K_NO_WAIT);
+    struct net_buf *ok = pkt_alloc(K_NO_WAIT);
+
+    zassert_not_null(leak);
+    zassert_not_null(ok);
+
+    pkt_track_set(leak, PKT_OWNER_APP);
+    pkt_track_set(ok, PKT_OWNER_USB_IN);
+    net_buf_unref(ok);
+
+    zassert_equal(pkt_track_list(list, ARRAY_SIZE(list)), 1);
+    zassert_equal(list[0].id, net_buf_id(leak));
+    zassert_equal(list[0].owner, PKT_OWNER_APP);
+    zassert_true(list[0].age_ms >= list[0].held_ms);
+    zassert_str_equal(pkt_owner_name(list[0].owner), "app");
+
+    net_buf_unref(leak);
+    zassert_equal(pkt_track_list(list, ARRAY_SIZE(list)), 0);
+}
+
+ZTEST(pkt_track_suite, test_order_and_cap)
+{
+    static const enum pkt_owner owners[] = {
+        PKT_OWNER_RELAY, PKT_OWNER_BT_TX, PKT_OWNER_USB_OUT, PKT_OWNER_BT_TX,
+    };
+    struct net_buf *bufs[ARRAY_SIZE(owners)];
+
+    for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+        bufs[i] = pkt_alloc(K_NO_WAIT);
+        zassert_not_null(bufs[i]);
+        pkt_track_set(bufs[i], owners[i]);
+        k_sleep(K_MSEC(2));
+    }
+
+    /* All four counted, the first three by owner, oldest BT_TX first. */
+    zassert_equal(pkt_track_list(list, 3), ARRAY_SIZE(bufs));
+    zassert_equal(list[0].id, net_buf_id(bufs[2]));
+    zassert_equal(list[1].id, net_buf_id(bufs[1]));
+    zassert_equal(list[2].id, net_buf_id(bufs[3]));
+    assert_grouped(3);
+
+    for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+        net_buf_unref(bufs[i]);
+    }
+}
+
+/*
+ * Producers, a worker and a sink cycle buffers through the pool while a
+ * relay hoards a few. Listing concurrently must stay consistent, find the
+ * hoarded buffers and end with none outstanding.
+ */
+ZTEST(pkt_track_suite, test_stress)
+{
+    struct net_buf *hoard[HOARD];
+    size_t samples = 0;
+    size_t n;
+
+    for (size_t i = 0; i < ARRAY_SIZE(hoard); i++) {
+        hoard[i] = pkt_alloc(K_NO_WAIT);
+        zassert_not_null(hoard[i]);
+        pkt_track_set(hoard[i], PKT_OWNER_RELAY);
+    }
+
+    atomic_set(&done, 0);
+    for (int i = 0; i < PRODUCERS; i++) {
+        k_thread_create(&threads[i], stacks[i], STACK_SIZE, producer, (void *)(uintptr_t)i,
+                        NULL, NULL, PIPELINE_PRIO, 0, K_NO_WAIT);
+    }
+    k_thread_create(&threads[PRODUCERS], stacks[PRODUCERS], STACK_SIZE, worker, NULL, NULL,
+                    NULL, PIPELINE_PRIO, 0, K_NO_WAIT);
+    k_thread_create(&threads[PRODUCERS + 1], stacks[PRODUCERS + 1], STACK_SIZE, sink, NULL,
+                    NULL, NULL, PIPELINE_PRIO, 0, K_NO_WAIT);
+
+    while (atomic_get(&done) < PRODUCERS * FRAMES) {
+        size_t relay = 0;
+
+        n = pkt_track_list(list, ARRAY_SIZE(list));
+        zassert_true(n >= HOARD && n <= CONFIG_APP_PKT_COUNT, "%u out", (unsigned int)n);
+        assert_grouped(n);
+        for (size_t i = 0; i < n; i++) {
+            relay += list[i].owner == PKT_OWNER_RELAY;
+        }
+        zassert_equal(relay, HOARD);
+        samples++;
+        k_sleep(K_MSEC(1));
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(threads); i++) {
+        zassert_ok(k_thread_join(&threads[i], K_SECONDS(10)));
+    }
+
+    /* Only the hoard is left, held for at least as long as we wait. */
+    k_sleep(K_MSEC(HOLD_MS));
+    n = pkt_track_list(list, ARRAY_SIZE(list));
+    zassert_equal(n, HOARD);
+    for (size_t i = 0; i < n; i++) {
+        zassert_equal(list[i].owner, PKT_OWNER_RELAY);
+        zassert_true(list[i].held_ms >= HOLD_MS, "held %u ms", list[i].held_ms);
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(hoard); i++) {
+        net_buf_unref(hoard[i]);
+    }
+    zassert_equal(pkt_track_list(list, ARRAY_SIZE(list)), 0);
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT);
+
+    TC_PRINT("%u frames, %u listings while in flight\n", PRODUCERS * FRAMES,
+             (unsigned int)samples);
+}
+
+ZTEST_SUITE(pkt_track_suite, NULL, NULL, NULL, NULL, NULL);
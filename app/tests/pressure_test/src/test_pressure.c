@@ -0,0 +1,128 @@
+#include <zephyr/ztest.h>
+#include "pkt_pool.h"
+#include "pressure.h"
+
+#define MAX_EVENTS 16
+
+struct transition {
+    enum pressure_level from;
+    enum pressure_level to;
+};
+
+static struct transition events[MAX_EVENTS];
+static size_t event_count;
+static struct net_buf *held[CONFIG_APP_PKT_COUNT];
+static size_t held_count;
+
+static void record(enum pressure_level from, enum pressure_level to,
+                   const struct pressure_policy *policy)
+{
+    ARG_UNUSED(policy);
+
+    if (event_count < MAX_EVENTS) {
+        events[event_count].from = from;
+        events[event_count].to = to;
+    }
+    event_count++;
+}
+
+static void reset(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    pressure_init(record);
+    event_count = 0;
+}
+
+static void release_all(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    while (held_count > 0) {
+        net_buf_unref(held[--held_count]);
+    }
+}
+
+static void hold(size_t count)
+{
+    while (count-- > 0) {
+        held[held_count] = pkt_alloc(K_NO_WAIT);
+        zassert_not_null(held[held_count]);
+        held_count++;
+    }
+}
+
+static void release(size_t count)
+{
+    while (count-- > 0) {
+        net_buf_unref(held[--held_count]);
+    }
+}
+
+ZTEST_SUITE(pressure_suite, NULL, NULL, reset, release_all, NULL);
+
+ZTEST(pressure_suite, test_flood_degrades_before_exhaustion)
+{
+    const struct pressure_policy *policy;
+
+    /* Flood: keep taking buffers without returning any. */
+    hold(10);
+    zassert_equal(pressure_level(), PRESSURE_NORMAL);
+
+    hold(1);
+    zassert_equal(pressure_level(), PRESSURE_ELEVATED);
+    policy = pressure_policy();
+    zassert_false(policy->capture, "capture taps go first");
+    zassert_true(policy->compression);
+
+    hold(5);
+    zassert_equal(pressure_level(), PRESSURE_HIGH);
+    policy = pressure_policy();
+    zassert_false(policy->compression);
+    zassert_true(policy->coalesce_us < CONFIG_APP_COALESCE_US);
+    zassert_true(policy->credits <= CONFIG_APP_CREDITS);
+
+    hold(3);
+    zassert_equal(pressure_level(), PRESSURE_CRITICAL);
+    zassert_equal(pressure_policy()->credits, 1);
+    zassert_equal(pressure_policy()->coalesce_us, 0);
+    zassert_true(pkt_pool_free_count() > 0, "critical before any drop");
+
+    zassert_equal(event_count, 3);
+    zassert_equal(events[0].to, PRESSURE_ELEVATED);
+    zassert_equal(events[1].to, PRESSURE_HIGH);
+    zassert_equal(events[2].to, PRESSURE_CRITICAL);
+}
+
+ZTEST(pressure_suite, test_recovery_uses_hysteresis)
+{
+    hold(19);
+    zassert_equal(pressure_level(), PRESSURE_CRITICAL);
+    event_count = 0;
+
+    /* Back to the critical threshold is not enough to relax. */
+    release(1);
+    zassert_equal(pressure_level(), PRESSURE_CRITICAL);
+
+    release(2);
+    zassert_equal(pressure_level(), PRESSURE_HIGH);
+
+    release(3);
+    zassert_equal(pressure_level(), PRESSURE_ELEVATED);
+
+    release(5);
+    zassert_equal(pressure_level(), PRESSURE_NORMAL);
+
+    zassert_equal(event_count, 3);
+}
+
+ZTEST(pressure_suite, test_jump_reports_every_step)
+{
+    zassert_equal(pressure_update(0, 20), PRESSURE_CRITICAL);
+    zassert_equal(event_count, 3);
+    zassert_equal(events[0].from, PRESSURE_NORMAL);
+    zassert_equal(events[2].from, PRESSURE_HIGH);
+
+    zassert_equal(pressure_update(20, 20), PRESSURE_NORMAL);
+    zassert_equal(event_count, 6);
+}
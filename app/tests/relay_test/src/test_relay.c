@@ -0,0 +1,252 @@
+#include <zephyr/ztest.h>
+#include "credit.h"
+#include "frame.h"
+#include "pkt_pool.h"
+#include "relay.h"
+
+#define MAX_HOPS 4
+#define WINDOW 6
+#define LINK_DEPTH 2
+#define FRAMES 200
+#define MAX_STEPS 10000
+
+/* One direction of a radio link: a small queue of frames in flight. */
+struct wire {
+    struct net_buf *q[LINK_DEPTH];
+    uint8_t len;
+};
+
+/*
+ * Node i sits between wires down[i - 1] / up[i - 1] towards the source
+ * and down[i] / up[i] towards the sink. Node 0 is the source, node
+ * hops + 1 the sink, everything in between is a relay.
+ */
+static struct wire down[MAX_HOPS + 1];
+static struct wire up[MAX_HOPS + 1];
+static struct relay relays[MAX_HOPS];
+static size_t hops;
+
+static struct credit_tx src_credits;
+static uint16_t src_seq;
+static struct credit_rx sink_credits;
+static uint8_t sink_grant;
+static uint16_t sink_seq;
+static size_t max_outstanding;
+
+static int wire_send(void *ctx, struct net_buf *buf)
+{
+    struct wire *w = ctx;
+
+    if (w->len == LINK_DEPTH) {
+        return -EAGAIN;
+    }
+
+    w->q[w->len++] = buf;
+
+    return 0;
+}
+
+static struct net_buf *wire_recv(struct wire *w)
+{
+    struct net_buf *buf;
+
+    if (w->len == 0) {
+        return NULL;
+    }
+
+    buf = w->q[0];
+    memmove(&w->q[0], &w->q[1], --w->len * sizeof(w->q[0]));
+
+    return buf;
+}
+
+static struct net_buf *make_frame(uint8_t type, const void *payload,
+                                  uint16_t len)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+    struct frame_hdr hdr = { .chan = 1, .type = type, .len = len };
+
+    zassert_not_null(buf);
+    frame_put_hdr(net_buf_add(buf, FRAME_HDR_SIZE), &hdr);
+    net_buf_add_mem(buf, payload, len);
+
+    return buf;
+}
+
+static void source_step(void)
+{
+    struct net_buf *buf;
+
+    while ((buf = wire_recv(&up[0])) != NULL) {
+        zassert_equal(buf->data[2], FRAME_CREDIT);
+        credit_tx_grant(&src_credits, buf->data[FRAME_HDR_SIZE]);
+        net_buf_unref(buf);
+    }
+
+    if (src_seq < FRAMES && down[0].len < LINK_DEPTH &&
+        credit_tx_take(&src_credits)) {
+        zassert_ok(wire_send(&down[0], make_frame(FRAME_DATA, &src_seq,
+                                                  sizeof(src_seq))));
+        src_seq++;
+    }
+
+    max_outstanding = MAX(max_outstanding, (size_t)(src_seq - sink_seq));
+}
+
+static void sink_step(void)
+{
+    struct net_buf *buf = wire_recv(&down[hops]);
+
+    if (buf != NULL) {
+        uint16_t seq;
+
+        zassert_equal(buf->data[2], FRAME_DATA);
+        memcpy(&seq, &buf->data[FRAME_HDR_SIZE], sizeof(seq));
+        zassert_equal(seq, sink_seq, "frames must arrive in order");
+        sink_seq++;
+        net_buf_unref(buf);
+
+        sink_grant += credit_rx_consumed(&sink_credits);
+    }
+
+    if (sink_grant > 0 && up[hops].len < LINK_DEPTH) {
+        zassert_ok(wire_send(&up[hops], make_frame(FRAME_CREDIT, &sink_grant, 1)));
+        sink_grant = 0;
+    }
+}
+
+static void relay_step(size_t i)
+{
+    struct net_buf *buf;
+
+    /* Relay i + 1 sits between wire i (upstream) and wire i + 1. */
+    if ((buf = wire_recv(&down[i])) != NULL) {
+        relay_from_upstream(&relays[i], buf);
+    }
+
+    if ((buf = wire_recv(&up[i + 1])) != NULL) {
+        relay_from_downstream(&relays[i], buf);
+    }
+
+    relay_kick(&relays[i]);
+}
+
+static size_t run_chain(size_t n)
+{
+    size_t steps = 0;
+
+    memset(down, 0, sizeof(down));
+    memset(up, 0, sizeof(up));
+    hops = n;
+
+    for (size_t i = 0; i < n; i++) {
+        relay_init(&relays[i], wire_send, &up[i], wire_send, &down[i + 1]);
+    }
+
+    credit_tx_init(&src_credits);
+    credit_rx_init(&sink_credits, WINDOW);
+    src_seq = 0;
+    sink_seq = 0;
+    max_outstanding = 0;
+
+    /* The sink opens its window at session start. */
+    sink_grant = WINDOW;
+
+    while (sink_seq < FRAMES && steps++ < MAX_STEPS) {
+        source_step();
+        for (size_t i = n; i > 0; i--) {
+            relay_step(i - 1);
+        }
+        sink_step();
+    }
+
+    return steps;
+}
+
+static void drain(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    for (size_t i = 0; i <= MAX_HOPS; i++) {
+        struct net_buf *buf;
+
+        while ((buf = wire_recv(&down[i])) != NULL) {
+            net_buf_unref(buf);
+        }
+        while ((buf = wire_recv(&up[i])) != NULL) {
+            net_buf_unref(buf);
+        }
+    }
+}
+
+ZTEST_SUITE(relay_suite, NULL, NULL, NULL, drain, NULL);
+
+ZTEST(relay_suite, test_chains)
+{
+    for (size_t n = 1; n <= MAX_HOPS; n++) {
+        size_t steps = run_chain(n);
+
+        zassert_equal(sink_seq, FRAMES, "%zu hops: stalled", n);
+        zassert_true(max_outstanding <= WINDOW,
+                     "credits must bound the whole chain");
+
+        for (size_t i = 0; i < n; i++) {
+            zassert_equal(relays[i].down.drops, 0);
+            zassert_equal(relays[i].down.frames, FRAMES);
+        }
+
+        TC_PRINT("%zu hop(s): %u frames in %zu steps\n", n, FRAMES, steps);
+    }
+}
+
+ZTEST(relay_suite, test_backlog_when_link_busy)
+{
+    struct relay r;
+    struct wire w = { 0 };
+    struct wire sink = { 0 };
+    uint8_t v = 0;
+
+    relay_init(&r, wire_send, &sink, wire_send, &w);
+
+    for (size_t i = 0; i < LINK_DEPTH; i++) {
+        zassert_ok(relay_from_upstream(&r, make_frame(FRAME_DATA, &v, 1)));
+    }
+    for (size_t i = 0; i < 2; i++) {
+        zassert_equal(relay_from_upstream(&r, make_frame(FRAME_DATA, &v, 1)), -EINPROGRESS);
+    }
+
+    zassert_equal(w.len, LINK_DEPTH);
+    zassert_equal(r.down.backlog_len, 2);
+
+    net_buf_unref(wire_recv(&w));
+    relay_kick(&r);
+    zassert_equal(w.len, LINK_DEPTH);
+    zassert_equal(r.down.backlog_len, 1);
+
+    /* A new frame goes behind the waiting one, not past it. */
+    net_buf_unref(wire_recv(&w));
+    zassert_equal(relay_from_upstream(&r, make_frame(FRAME_DATA, &v, 1)), -EINPROGRESS);
+    zassert_equal(r.down.backlog_len, 1);
+
+    while (w.len > 0) {
+        net_buf_unref(wire_recv(&w));
+        relay_kick(&r);
+    }
+    zassert_equal(r.down.backlog_len, 0);
+    zassert_equal(r.down.frames, LINK_DEPTH + 3);
+}
+
+ZTEST(relay_suite, test_malformed_frame_dropped)
+{
+    struct relay r;
+    struct wire w = { 0 };
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    relay_init(&r, wire_send, &w, wire_send, &w);
+
+    net_buf_add_u8(buf, 0x00);
+    zassert_equal(relay_from_upstream(&r, buf), -EBADMSG);
+
+    zassert_equal(w.len, 0);
+    zassert_equal(r.down.drops, 1);
+}
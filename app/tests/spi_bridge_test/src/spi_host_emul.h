@@ -0,0 +1,15 @@
+#ifndef SPI_HOST_EMUL_H
+#define SPI_HOST_EMUL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/*
+ * Clock one transaction of len bytes as the host: mosi goes to the
+ * armed receive buffer and miso gets the armed transmit buffer, padded
+ * with zeros. Returns -EAGAIN if no transaction is armed.
+ */
+int spi_host_emul_xfer(const struct device *dev, const uint8_t *mosi, uint8_t *miso, size_t len);
+
+#endif /* SPI_HOST_EMUL_H */
@@ -0,0 +1,278 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/ztest.h>
+#include "cycles.h"
+#include "pkt_pool.h"
+#include "spi_host_emul.h"
+#include "spi_xfer.h"
+#include "transport.h"
+
+#define XFER_SIZE CONFIG_APP_SPI_XFER_SIZE
+
+/* Bus clock the throughput figures are worked out for. */
+#define SCK_HZ       8000000U
+#define BENCH_FRAMES 500U
+#define BENCH_FRAME  48U
+
+static const struct device *const spi = DEVICE_DT_GET(DT_CHOSEN(app_bridge_spi));
+static const struct gpio_dt_spec ready =
+    GPIO_DT_SPEC_GET(DT_PATH(zephyr_user), bridge_ready_gpios);
+
+static uint8_t line[1024];
+static uint8_t mosi[XFER_SIZE];
+static uint8_t miso[XFER_SIZE];
+
+static uint8_t pattern(size_t i)
+{
+    return (uint8_t)(i * 7U + 3U);
+}
+
+/* Wait as the host would for the ready line, giving the bridge time to arm. */
+static bool host_wait_ready(void)
+{
+    for (int i = 0; i < 100; i++) {
+        if (gpio_emul_output_get(ready.port, ready.pin) == 1) {
+            return true;
+        }
+        k_sleep(K_USEC(100));
+    }
+
+    return false;
+}
+
+/* Clock one transaction carrying len bytes of data; returns the payload length of miso. */
+static int host_xfer(const uint8_t *data, size_t len, bool *pending)
+{
+    zassert_true(host_wait_ready(), "no transaction armed");
+
+    spi_xfer_init(mosi);
+    if (len > 0) {
+        zassert_true(spi_xfer_add(mosi, sizeof(mosi), data, len));
+    }
+    zassert_ok(spi_host_emul_xfer(spi, mosi, miso, sizeof(miso)));
+
+    return spi_xfer_parse(miso, sizeof(miso), pending);
+}
+
+static struct net_buf *frame(const uint8_t *data, size_t len)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    zassert_not_null(buf);
+    net_buf_add_mem(buf, data, len);
+
+    return buf;
+}
+
+static void *setup(void)
+{
+    for (size_t i = 0; i < sizeof(line); i++) {
+        line[i] = pattern(i);
+    }
+
+    zassert_ok(spi_transport.init());
+
+    return NULL;
+}
+
+static void after(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    /* Armed again, with one buffer to receive into. */
+    zassert_true(host_wait_ready());
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT - 1);
+}
+
+ZTEST(spi_bridge_suite, test_xfer_layout)
+{
+    uint8_t xfer[16];
+    bool pending;
+
+    spi_xfer_init(xfer);
+    zassert_equal(spi_xfer_parse(xfer, sizeof(xfer), &pending), 0);
+    zassert_false(pending);
+
+    zassert_true(spi_xfer_add(xfer, sizeof(xfer), line, 5));
+    zassert_true(spi_xfer_add(xfer, sizeof(xfer), &line[5], 7));
+    /* 4 + 12 bytes: full. */
+    zassert_false(spi_xfer_add(xfer, sizeof(xfer), line, 1));
+    spi_xfer_set_pending(xfer, true);
+
+    zassert_equal(spi_xfer_parse(xfer, sizeof(xfer), &pending), 12);
+    zassert_true(pending);
+    zassert_mem_equal(&xfer[SPI_XFER_HDR_SIZE], line, 12);
+
+    /* Cut short, or an idle line. */
+    zassert_equal(spi_xfer_parse(xfer, 10, &pending), -EBADMSG);
+    memset(xfer, 0xff, sizeof(xfer));
+    zassert_equal(spi_xfer_parse(xfer, sizeof(xfer), &pending), -EBADMSG);
+}
+
+ZTEST(spi_bridge_suite, test_rx)
+{
+    struct net_buf *buf;
+
+    zassert_equal(host_xfer(line, 30, NULL), 0);
+
+    buf = spi_transport.recv(K_MSEC(10));
+    zassert_not_null(buf);
+    zassert_equal(buf->len, 30);
+    zassert_mem_equal(buf->data, line, 30);
+    spi_transport.release(buf);
+
+    /* A transaction the host only clocked to read carries nothing. */
+    zassert_equal(host_xfer(NULL, 0, NULL), 0);
+    zassert_is_null(spi_transport.recv(K_MSEC(5)));
+}
+
+ZTEST(spi_bridge_suite, test_tx_batched)
+{
+    bool pending;
+    int len = 0;
+
+    for (size_t i = 0; i < 3; i++) {
+        zassert_ok(spi_transport.send(frame(&line[i * 40], 40)));
+    }
+
+    /* The transaction armed before the frames came is sent empty. */
+    for (int n = 0; n < 2 && len == 0; n++) {
+        len = host_xfer(NULL, 0, &pending);
+    }
+
+    zassert_equal(len, 3 * 40, "frames not batched");
+    zassert_mem_equal(&miso[SPI_XFER_HDR_SIZE], line, 3 * 40);
+    zassert_false(pending);
+}
+
+ZTEST(spi_bridge_suite, test_tx_backlog)
+{
+    bool pending = true;
+    size_t at = 0;
+    int n;
+
+    /* Two fit in a transaction; the other four wait as packet buffers. */
+    for (size_t i = 0; i < 6; i++) {
+        zassert_ok(spi_transport.send(frame(&line[i * 100], 100)));
+    }
+
+    for (n = 0; n < 6 && (at == 0 || pending); n++) {
+        int len = host_xfer(NULL, 0, &pending);
+
+        zassert_true(len >= 0 && len <= 200);
+        zassert_mem_equal(&miso[SPI_XFER_HDR_SIZE], &line[at], len);
+        at += len;
+        /* The header tells the host whether to come back. */
+        zassert_equal(pending, at > 0 && at < 600);
+    }
+
+    zassert_equal(at, 600);
+    zassert_equal(n, 4);
+}
+
+ZTEST(spi_bridge_suite, test_rx_flow_control)
+{
+    struct net_buf *held[CONFIG_APP_PKT_COUNT];
+    struct net_buf *buf;
+    size_t n = 0;
+
+    /* Each transaction lands in a pool buffer; holding them all stalls the bridge. */
+    while (n < CONFIG_APP_PKT_COUNT) {
+        zassert_equal(host_xfer(&line[n * 20], 20, NULL), 0);
+        n++;
+    }
+
+    k_sleep(K_MSEC(1));
+    zassert_equal(gpio_emul_output_get(ready.port, ready.pin), 0);
+    zassert_equal(spi_host_emul_xfer(spi, mosi, miso, sizeof(miso)), -EAGAIN);
+
+    for (size_t i = 0; i < n; i++) {
+        held[i] = spi_transport.recv(K_MSEC(10));
+        zassert_not_null(held[i]);
+        zassert_mem_equal(held[i]->data, &line[i * 20], 20);
+    }
+    zassert_is_null(spi_transport.recv(K_NO_WAIT));
+
+    /* One buffer back is enough to go on. */
+    spi_transport.release(held[0]);
+    zassert_true(host_wait_ready());
+    zassert_equal(host_xfer(line, 20, NULL), 0);
+
+    for (size_t i = 1; i < n; i++) {
+        spi_transport.release(held[i]);
+    }
+    buf = spi_transport.recv(K_MSEC(10));
+    zassert_not_null(buf);
+    spi_transport.release(buf);
+}
+
+/*
+ * Both directions flat out: BENCH_FRAME byte frames to the host, and
+ * full transactions from it. Batching is what keeps the bus busy with
+ * payload rather than padding.
+ */
+ZTEST(spi_bridge_suite, test_throughput)
+{
+    uint8_t out[BENCH_FRAME];
+    uint64_t send_cycles = UINT64_MAX;
+    uint32_t xfers = 0;
+    uint32_t empty = 0;
+    uint32_t host_bytes = 0;
+    size_t host_len = XFER_SIZE - SPI_XFER_HDR_SIZE;
+    size_t sent = 0;
+    size_t got = 0;
+    uint32_t tx_pct;
+    uint32_t rx_pct;
+
+    memcpy(out, line, sizeof(out));
+
+    while (got < BENCH_FRAMES) {
+        struct net_buf *buf;
+        int len;
+
+        /* Keep a backlog, leaving room for the host's transaction. */
+        while (sent < BENCH_FRAMES && pkt_pool_free_count() > 2) {
+            uint64_t start;
+
+            out[0] = (uint8_t)sent++;
+            buf = frame(out, sizeof(out));
+            start = cycles_now();
+            zassert_ok(spi_transport.send(buf));
+            send_cycles = MIN(send_cycles, cycles_now() - start);
+        }
+
+        len = host_xfer(line, host_len, NULL);
+        zassert_true(len >= 0 && len % BENCH_FRAME == 0);
+        xfers++;
+        empty += len == 0 ? 1U : 0U;
+
+        for (size_t at = SPI_XFER_HDR_SIZE; at < SPI_XFER_HDR_SIZE + (size_t)len;
+             at += BENCH_FRAME) {
+            zassert_equal(miso[at], (uint8_t)got, "frame %u out of order", (unsigned int)got);
+            got++;
+        }
+
+        buf = spi_transport.recv(K_MSEC(10));
+        zassert_not_null(buf);
+        zassert_equal(buf->len, host_len);
+        host_bytes += buf->len;
+        spi_transport.release(buf);
+    }
+
+    tx_pct = BENCH_FRAMES * BENCH_FRAME * 100U / (xfers * XFER_SIZE);
+    rx_pct = host_bytes * 100U / (xfers * XFER_SIZE);
+
+    TC_PRINT("%u frames of %u bytes in %u transactions of %u bytes (%u empty)\n",
+             BENCH_FRAMES, BENCH_FRAME, xfers, XFER_SIZE, empty);
+    TC_PRINT("payload to host %u%%, from host %u%%: %u and %u kB/s at %u MHz SCK\n", tx_pct,
+             rx_pct, SCK_HZ / 8U / 1000U * tx_pct / 100U, SCK_HZ / 8U / 1000U * rx_pct / 100U,
+             SCK_HZ / 1000000U);
+    TC_PRINT("one frame per transaction would be %u%%; send %u cycles per frame\n",
+             BENCH_FRAME * 100U / XFER_SIZE, (uint32_t)send_cycles);
+
+    zassert_true(tx_pct >= 90U, "only %u%% payload to host", tx_pct);
+    zassert_true(rx_pct >= 90U);
+}
+
+ZTEST_SUITE(spi_bridge_suite, NULL, setup, NULL, after, NULL);
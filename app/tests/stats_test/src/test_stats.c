@@ -0,0 +1,122 @@
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include "frame.h"
+#include "pkt_pool.h"
+#include "stats.h"
+
+#define SNAP_COUNTERS 5U
+#define SNAP_HISTS    (SNAP_COUNTERS + 1U + 4U * STATS_COUNTER_COUNT)
+
+static struct net_buf *sent;
+static uint8_t snap[CONFIG_APP_FRAME_MAX_PAYLOAD];
+
+static int capture(struct net_buf *buf)
+{
+    zassert_is_null(sent);
+    sent = buf;
+
+    return 0;
+}
+
+static void reset(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    stats_set_sink(capture);
+    if (sent != NULL) {
+        net_buf_unref(sent);
+        sent = NULL;
+    }
+}
+
+static uint32_t snap_counter(enum stats_counter counter)
+{
+    zassert_true(stats_snapshot(snap, sizeof(snap)) > 0);
+
+    return sys_get_le32(&snap[SNAP_COUNTERS + 4U * counter]);
+}
+
+static uint32_t snap_bucket(enum stats_hist hist, size_t bucket)
+{
+    size_t off = SNAP_HISTS + hist * (1U + 4U * STATS_HIST_BUCKETS + 8U);
+
+    zassert_true(stats_snapshot(snap, sizeof(snap)) > 0);
+
+    return sys_get_le32(&snap[off + 1U + 4U * bucket]);
+}
+
+ZTEST(stats_suite, test_counters_accumulate)
+{
+    uint32_t before = snap_counter(STATS_USB_RX_BYTES);
+
+    stats_add(STATS_USB_RX_BYTES, 64);
+    stats_add(STATS_USB_RX_BYTES, 10);
+
+    zassert_equal(snap_counter(STATS_USB_RX_BYTES), before + 74);
+}
+
+ZTEST(stats_suite, test_pool_gauge_sampled)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    zassert_not_null(buf);
+    zassert_equal(snap_counter(STATS_POOL_FREE), CONFIG_APP_PKT_COUNT - 1);
+
+    net_buf_unref(buf);
+    zassert_equal(snap_counter(STATS_POOL_FREE), CONFIG_APP_PKT_COUNT);
+}
+
+ZTEST(stats_suite, test_hist_buckets)
+{
+    uint32_t zero = snap_bucket(STATS_HIST_HOLD_US, 0);
+    uint32_t b4 = snap_bucket(STATS_HIST_HOLD_US, 4);
+    uint32_t last = snap_bucket(STATS_HIST_HOLD_US, STATS_HIST_BUCKETS - 1U);
+
+    stats_observe(STATS_HIST_HOLD_US, 0);
+    stats_observe(STATS_HIST_HOLD_US, 8);
+    stats_observe(STATS_HIST_HOLD_US, 15);
+    stats_observe(STATS_HIST_HOLD_US, UINT32_MAX);
+
+    zassert_equal(snap_bucket(STATS_HIST_HOLD_US, 0), zero + 1);
+    zassert_equal(snap_bucket(STATS_HIST_HOLD_US, 4), b4 + 2);
+    zassert_equal(snap_bucket(STATS_HIST_HOLD_US, STATS_HIST_BUCKETS - 1U),
+                  last + 1);
+}
+
+ZTEST(stats_suite, test_snapshot_layout)
+{
+    size_t len = stats_snapshot(snap, sizeof(snap));
+    size_t hists = SNAP_HISTS;
+
+    zassert_equal(snap[4], STATS_COUNTER_COUNT);
+    zassert_equal(snap[hists - 1U], STATS_HIST_COUNT);
+    zassert_equal(snap[hists], STATS_HIST_BUCKETS);
+    zassert_equal(len, hists + STATS_HIST_COUNT * (1U + 4U * STATS_HIST_BUCKETS + 8U));
+    zassert_equal(stats_snapshot(snap, len - 1U), 0);
+}
+
+ZTEST(stats_suite, test_ctrl_snapshot_request)
+{
+    uint8_t req[] = { STATS_OP_SNAPSHOT };
+    struct frame_hdr hdr;
+
+    zassert_ok(stats_handle_ctrl(req, sizeof(req)));
+    zassert_not_null(sent);
+
+    zassert_ok(frame_get_hdr(sent->data, sent->len, &hdr));
+    zassert_equal(hdr.chan, CONFIG_APP_STATS_CHAN);
+    zassert_equal(hdr.type, FRAME_DATA);
+    zassert_equal(sent->data[FRAME_HDR_SIZE], STATS_REC_SNAPSHOT);
+    zassert_equal(sent->data[FRAME_HDR_SIZE + 1U + 4U], STATS_COUNTER_COUNT);
+}
+
+ZTEST(stats_suite, test_ctrl_unknown_op)
+{
+    uint8_t req[] = { 0x7f };
+
+    zassert_equal(stats_handle_ctrl(req, sizeof(req)), -ENOTSUP);
+    zassert_equal(stats_handle_ctrl(NULL, 0), -EBADMSG);
+    zassert_is_null(sent);
+}
+
+ZTEST_SUITE(stats_suite, NULL, NULL, reset, NULL, NULL);
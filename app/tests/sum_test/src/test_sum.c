@@ -1,6 +1,43 @@
 #include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
 #include "sum.h"
 
+/* One spare byte so every length also runs from an odd address. */
+static uint8_t samples[SUM_I16_MAX * 2U + 1U];
+
+static void fill(uint8_t *dst, size_t n, uint32_t seed)
+{
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245U + 12345U;
+        sys_put_le16((uint16_t)(seed >> 16), &dst[i * 2U]);
+    }
+}
+
+static void fill_const(size_t n, int16_t value)
+{
+    for (size_t i = 0; i < n; i++) {
+        sys_put_le16((uint16_t)value, &samples[i * 2U]);
+    }
+}
+
+static void assert_matches_scalar(const uint8_t *src, size_t n)
+{
+    const struct sum_impl *scalar = sum_impl_get(0);
+    struct sum_i16 ref;
+
+    scalar->i16_le(src, n, &ref);
+
+    for (size_t i = 1; i < sum_impl_count(); i++) {
+        const struct sum_impl *impl = sum_impl_get(i);
+        struct sum_i16 r;
+
+        impl->i16_le(src, n, &r);
+        zassert_equal(r.sum, ref.sum, "%s sum, n=%zu", impl->name, n);
+        zassert_equal(r.min, ref.min, "%s min, n=%zu", impl->name, n);
+        zassert_equal(r.max, ref.max, "%s max, n=%zu", impl->name, n);
+    }
+}
+
 ZTEST_SUITE(sum_suite, NULL, NULL, NULL, NULL, NULL);
 
 ZTEST(sum_suite, test_add_positive)
@@ -13,3 +50,77 @@ ZTEST(sum_suite, test_add_negative)
     zassert_equal(add(-1, -1), -2, "-1 + -1 should be -2");
 }
 
+ZTEST(sum_suite, test_scalar_reduces)
+{
+    const struct sum_impl *scalar = sum_impl_get(0);
+    struct sum_i16 r;
+
+    sys_put_le16(5, &samples[0]);
+    sys_put_le16((uint16_t)-7, &samples[2]);
+    sys_put_le16(3, &samples[4]);
+
+    zassert_not_null(scalar);
+    scalar->i16_le(samples, 3, &r);
+    zassert_equal(r.sum, 1);
+    zassert_equal(r.min, -7);
+    zassert_equal(r.max, 5);
+}
+
+ZTEST(sum_suite, test_variants_match_scalar)
+{
+    /* Lengths around every vector width, from both alignments. */
+    for (size_t n = 1; n <= 70; n++) {
+        fill(samples, n, (uint32_t)n);
+        assert_matches_scalar(samples, n);
+
+        fill(&samples[1], n, (uint32_t)n + 100U);
+        assert_matches_scalar(&samples[1], n);
+    }
+}
+
+ZTEST(sum_suite, test_variants_at_limits)
+{
+    struct sum_i16 r;
+
+    fill_const(SUM_I16_MAX, INT16_MIN);
+    for (size_t i = 0; i < sum_impl_count(); i++) {
+        sum_impl_get(i)->i16_le(samples, SUM_I16_MAX, &r);
+        zassert_equal(r.sum, INT32_MIN, "%s", sum_impl_get(i)->name);
+        zassert_equal(r.min, INT16_MIN);
+        zassert_equal(r.max, INT16_MIN);
+    }
+
+    fill_const(SUM_I16_MAX, INT16_MAX);
+    for (size_t i = 0; i < sum_impl_count(); i++) {
+        sum_impl_get(i)->i16_le(samples, SUM_I16_MAX, &r);
+        zassert_equal(r.sum, (int32_t)SUM_I16_MAX * INT16_MAX, "%s", sum_impl_get(i)->name);
+        zassert_equal(r.min, INT16_MAX);
+        zassert_equal(r.max, INT16_MAX);
+    }
+
+    fill(samples, SUM_I16_MAX, 7);
+    assert_matches_scalar(samples, SUM_I16_MAX);
+}
+
+ZTEST(sum_suite, test_select_dispatches)
+{
+    const struct sum_impl *chosen = sum_select();
+    bool listed = false;
+    struct sum_i16 want;
+    struct sum_i16 got;
+
+    zassert_not_null(chosen);
+    zassert_is_null(sum_impl_get(sum_impl_count()));
+
+    for (size_t i = 0; i < sum_impl_count(); i++) {
+        listed |= (sum_impl_get(i) == chosen);
+    }
+    zassert_true(listed, "selected %s is not supported", chosen->name);
+
+    fill(samples, 33, 3);
+    chosen->i16_le(samples, 33, &want);
+    sum_i16_le(samples, 33, &got);
+    zassert_equal(got.sum, want.sum);
+    zassert_equal(got.min, want.min);
+    zassert_equal(got.max, want.max);
+}
@@ -0,0 +1,116 @@
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include "frame.h"
+#include "pkt_pool.h"
+#include "stats.h"
+#include "trace.h"
+
+static struct net_buf *sent;
+
+static int capture(struct net_buf *buf)
+{
+    zassert_is_null(sent);
+    sent = buf;
+
+    return 0;
+}
+
+static void reset(void *fixture)
+{
+    uint8_t scratch[TRACE_REC_SIZE];
+
+    ARG_UNUSED(fixture);
+
+    trace_set_rate(0);
+    while (trace_export(scratch, sizeof(scratch)) > 0) {
+    }
+
+    stats_set_sink(capture);
+    if (sent != NULL) {
+        net_buf_unref(sent);
+        sent = NULL;
+    }
+}
+
+/* Run count packets through the bridge stages. */
+static void run_packets(size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+        zassert_not_null(buf);
+        trace_begin(buf);
+        trace_mark(buf, TRACE_USB_RX, 1);
+        trace_mark(buf, TRACE_APP_RX, 2);
+        net_buf_unref(buf);
+    }
+}
+
+ZTEST_SUITE(trace_suite, NULL, NULL, reset, NULL, NULL);
+
+ZTEST(trace_suite, test_off_records_nothing)
+{
+    uint8_t out[TRACE_REC_SIZE];
+
+    run_packets(50);
+    zassert_equal(trace_export(out, sizeof(out)), 0);
+}
+
+ZTEST(trace_suite, test_one_in_n)
+{
+    uint8_t out[4 * TRACE_REC_SIZE];
+
+    trace_set_rate(5);
+    run_packets(20);
+
+    zassert_equal(trace_export(out, sizeof(out)), 4 * TRACE_REC_SIZE);
+    zassert_equal(trace_export(out, sizeof(out)), 0, "export drains");
+}
+
+ZTEST(trace_suite, test_record_layout)
+{
+    uint8_t out[TRACE_REC_SIZE];
+    const uint8_t *stage;
+
+    trace_set_rate(1);
+    run_packets(1);
+
+    zassert_equal(trace_export(out, sizeof(out)), TRACE_REC_SIZE);
+    zassert_equal(out[6], BIT(TRACE_USB_RX) | BIT(TRACE_APP_RX) | BIT(TRACE_FREE));
+    zassert_equal(out[7], TRACE_STAGE_COUNT);
+
+    stage = &out[8 + 5 * TRACE_APP_RX];
+    zassert_equal(stage[4], 2, "queue depth at stage");
+    zassert_true(sys_get_le32(&out[8 + 5 * TRACE_FREE]) -
+                 sys_get_le32(&out[8 + 5 * TRACE_USB_RX]) < UINT32_MAX / 2,
+                 "stage timestamps are ordered");
+}
+
+ZTEST(trace_suite, test_keeps_newest_when_full)
+{
+    uint8_t out[CONFIG_APP_TRACE_RECORDS * TRACE_REC_SIZE];
+    uint32_t first;
+
+    trace_set_rate(1);
+    run_packets(CONFIG_APP_TRACE_RECORDS + 3);
+
+    zassert_equal(trace_export(out, sizeof(out)), sizeof(out));
+    first = sys_get_le32(out);
+    zassert_equal(sys_get_le32(&out[(CONFIG_APP_TRACE_RECORDS - 1) * TRACE_REC_SIZE]),
+                  first + CONFIG_APP_TRACE_RECORDS - 1);
+}
+
+ZTEST(trace_suite, test_export_on_stats_channel)
+{
+    struct frame_hdr hdr;
+
+    trace_set_rate(1);
+    run_packets(2);
+
+    zassert_ok(stats_send(STATS_REC_TRACE, trace_export));
+    zassert_not_null(sent);
+    zassert_ok(frame_get_hdr(sent->data, sent->len, &hdr));
+    zassert_equal(hdr.chan, CONFIG_APP_STATS_CHAN);
+    zassert_equal(hdr.len, 1 + 2 * TRACE_REC_SIZE);
+    zassert_equal(sent->data[FRAME_HDR_SIZE], STATS_REC_TRACE);
+}
@@ -0,0 +1,129 @@
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/ztest.h>
+#include "frame.h"
+#include "pkt_pool.h"
+#include "transport.h"
+
+static const struct device *const uart = DEVICE_DT_GET(DT_CHOSEN(app_bridge_uart));
+
+static uint8_t line[1024];
+
+static uint8_t pattern(size_t i)
+{
+    return (uint8_t)(i * 7U + 3U);
+}
+
+/* Check buf against the pattern from offset at, and return the offset after it. */
+static size_t check(struct net_buf *buf, size_t at)
+{
+    for (size_t i = 0; i < buf->len; i++) {
+        zassert_equal(buf->data[i], pattern(at + i), "byte %u", (unsigned int)(at + i));
+    }
+
+    return at + buf->len;
+}
+
+static void *setup(void)
+{
+    for (size_t i = 0; i < sizeof(line); i++) {
+        line[i] = pattern(i);
+    }
+
+    zassert_ok(uart_transport.init());
+
+    return NULL;
+}
+
+static void after(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT);
+}
+
+ZTEST(uart_bridge_suite, test_rx_timeout_ends_frame)
+{
+    struct frame_hdr hdr = { .chan = 1, .type = FRAME_DATA, .len = 12 };
+    uint8_t frame[FRAME_HDR_SIZE + 12];
+    struct net_buf *buf;
+
+    frame_put_hdr(frame, &hdr);
+    memcpy(&frame[FRAME_HDR_SIZE], line, 12);
+
+    /* Far short of a full buffer: only the line going idle hands it on. */
+    zassert_equal(uart_emul_put_rx_data(uart, frame, sizeof(frame)), sizeof(frame));
+
+    buf = uart_transport.recv(K_MSEC(10));
+    zassert_not_null(buf);
+    zassert_equal(buf->len, sizeof(frame));
+    zassert_mem_equal(buf->data, frame, sizeof(frame));
+    uart_transport.release(buf);
+
+    zassert_is_null(uart_transport.recv(K_MSEC(5)));
+}
+
+ZTEST(uart_bridge_suite, test_rx_double_buffered)
+{
+    struct net_buf *buf;
+    size_t at = 0;
+
+    /* Several times the two receive buffers in one burst. */
+    zassert_equal(uart_emul_put_rx_data(uart, line, 300), 300);
+
+    while (at < 300 && (buf = uart_transport.recv(K_MSEC(10))) != NULL) {
+        at = check(buf, at);
+        uart_transport.release(buf);
+    }
+    zassert_equal(at, 300);
+}
+
+ZTEST(uart_bridge_suite, test_rx_flow_control)
+{
+    struct net_buf *held[CONFIG_APP_PKT_COUNT];
+    struct net_buf *buf;
+    size_t n = 0;
+    size_t at = 0;
+
+    zassert_equal(uart_emul_put_rx_data(uart, line, sizeof(line)), sizeof(line));
+
+    /* Holding on to every buffer stops reception; the rest waits on the line. */
+    while ((buf = uart_transport.recv(K_MSEC(10))) != NULL) {
+        zassert_true(n < ARRAY_SIZE(held));
+        at = check(buf, at);
+        held[n++] = buf;
+    }
+    zassert_true(at < sizeof(line));
+
+    for (size_t i = 0; i < n; i++) {
+        uart_transport.release(held[i]);
+    }
+
+    /* Nothing was lost while stopped. */
+    while (at < sizeof(line) && (buf = uart_transport.recv(K_MSEC(10))) != NULL) {
+        at = check(buf, at);
+        uart_transport.release(buf);
+    }
+    zassert_equal(at, sizeof(line));
+}
+
+ZTEST(uart_bridge_suite, test_tx_in_order)
+{
+    uint8_t out[3 * 40];
+
+    uart_emul_flush_tx_data(uart);
+
+    for (size_t i = 0; i < 3; i++) {
+        struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+        zassert_not_null(buf);
+        net_buf_add_mem(buf, &line[i * 40], 40);
+        zassert_ok(uart_transport.send(buf));
+    }
+    k_sleep(K_MSEC(10));
+
+    zassert_equal(uart_emul_get_tx_data(uart, out, sizeof(out)), sizeof(out));
+    zassert_mem_equal(out, line, sizeof(out));
+}
+
+ZTEST_SUITE(uart_bridge_suite, NULL, setup, NULL, after, NULL);
@@ -0,0 +1,216 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "pkt_pool.h"
+#include "usb_out.h"
+
+#define DEPTH 2
+
+static struct net_buf *queued[CONFIG_APP_PKT_COUNT];
+static size_t queued_count;
+
+static int fake_submit(void *ctx, struct net_buf *buf)
+{
+    ARG_UNUSED(ctx);
+    queued[queued_count++] = buf;
+    return 0;
+}
+
+/* Complete the oldest queued transfer with len bytes of data. */
+static struct net_buf *fake_complete(struct usb_out_ep *ep, size_t len)
+{
+    struct net_buf *buf = queued[0];
+
+    memmove(&queued[0], &queued[1], (queued_count - 1) * sizeof(queued[0]));
+    queued_count--;
+    net_buf_add(buf, len);
+
+    return usb_out_ep_done(ep, buf, 0);
+}
+
+static void drain(void *fixture)
+{
+    ARG_UNUSED(fixture);
+
+    while (queued_count > 0) {
+        net_buf_unref(queued[--queued_count]);
+    }
+}
+
+ZTEST_SUITE(usb_out_suite, NULL, NULL, NULL, drain, NULL);
+
+ZTEST(usb_out_suite, test_arm_fills_depth)
+{
+    struct usb_out_ep ep;
+
+    usb_out_ep_init(&ep, DEPTH, fake_submit, NULL);
+
+    zassert_equal(usb_out_ep_arm(&ep), DEPTH);
+    zassert_equal(queued_count, DEPTH);
+    zassert_equal(usb_out_ep_arm(&ep), DEPTH, "arm must not overfill");
+    zassert_equal(queued_count, DEPTH);
+}
+
+ZTEST(usb_out_suite, test_rearmed_before_consume)
+{
+    struct usb_out_ep ep;
+    struct net_buf *buf;
+
+    usb_out_ep_init(&ep, DEPTH, fake_submit, NULL);
+    usb_out_ep_arm(&ep);
+
+    buf = fake_complete(&ep, 64);
+    zassert_not_null(buf);
+    zassert_equal(queued_count, DEPTH, "endpoint must stay armed");
+    zassert_equal(atomic_get(&ep.starved), 0);
+    zassert_equal(atomic_get(&ep.rx_bytes), 64);
+
+    net_buf_unref(buf);
+}
+
+ZTEST(usb_out_suite, test_empty_transfer_is_recycled)
+{
+    struct usb_out_ep ep;
+
+    usb_out_ep_init(&ep, DEPTH, fake_submit, NULL);
+    usb_out_ep_arm(&ep);
+
+    zassert_is_null(fake_complete(&ep, 0));
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT - DEPTH);
+}
+
+ZTEST(usb_out_suite, test_starved_when_pool_exhausted)
+{
+    struct net_buf *held[CONFIG_APP_PKT_COUNT];
+    struct usb_out_ep ep;
+    size_t n = 0;
+
+    usb_out_ep_init(&ep, DEPTH, fake_submit, NULL);
+    usb_out_ep_arm(&ep);
+
+    /* Slow consumer: hold on to every received buffer. */
+    while (queued_count > 0) {
+        held[n++] = fake_complete(&ep, 8);
+    }
+
+    zassert_equal(n, CONFIG_APP_PKT_COUNT);
+    zassert_equal(atomic_get(&ep.starved), 1);
+
+    /* Releasing a buffer lets the endpoint recover. */
+    net_buf_unref(held[--n]);
+    zassert_equal(usb_out_ep_arm(&ep), 1);
+
+    while (n > 0) {
+        net_buf_unref(held[--n]);
+    }
+}
+
+/*
+ * The host offers a full packet every slot and is NAKed while no buffer
+ * is armed. The controller reports a transfer done COMPLETE_SLOTS after
+ * it, and only then is the endpoint re-armed; the application holds each
+ * buffer for hold slots.
+ */
+#define SIM_SLOTS      1000U
+#define COMPLETE_SLOTS 2U
+
+struct sim_stage {
+    struct net_buf *buf[CONFIG_APP_PKT_COUNT];
+    uint32_t due[CONFIG_APP_PKT_COUNT];
+    size_t count;
+};
+
+static void sim_put(struct sim_stage *st, struct net_buf *buf, uint32_t due)
+{
+    st->buf[st->count] = buf;
+    st->due[st->count] = due;
+    st->count++;
+}
+
+/* The oldest entry if it is due by now, else NULL. */
+static struct net_buf *sim_take(struct sim_stage *st, uint32_t now)
+{
+    struct net_buf *buf;
+
+    if (st->count == 0 || st->due[0] > now) {
+        return NULL;
+    }
+
+    buf = st->buf[0];
+    st->count--;
+    memmove(&st->buf[0], &st->buf[1], st->count * sizeof(st->buf[0]));
+    memmove(&st->due[0], &st->due[1], st->count * sizeof(st->due[0]));
+
+    return buf;
+}
+
+static uint32_t sim_naks(uint8_t depth, uint32_t hold, uint32_t *starved)
+{
+    struct sim_stage completing = { 0 };
+    struct sim_stage held = { 0 };
+    struct usb_out_ep ep;
+    struct net_buf *buf;
+    uint32_t naks = 0;
+
+    usb_out_ep_init(&ep, depth, fake_submit, NULL);
+    usb_out_ep_arm(&ep);
+
+    for (uint32_t now = 0; now < SIM_SLOTS; now++) {
+        while ((buf = sim_take(&held, now)) != NULL) {
+            net_buf_unref(buf);
+            usb_out_ep_arm(&ep);
+        }
+        while ((buf = sim_take(&completing, now)) != NULL) {
+            buf = usb_out_ep_done(&ep, buf, 0);
+            zassert_not_null(buf);
+            sim_put(&held, buf, now + hold);
+        }
+
+        if (queued_count == 0) {
+            naks++;
+            continue;
+        }
+
+        buf = queued[0];
+        queued_count--;
+        memmove(&queued[0], &queued[1], queued_count * sizeof(queued[0]));
+        net_buf_add(buf, 64);
+        sim_put(&completing, buf, now + COMPLETE_SLOTS);
+    }
+
+    while ((buf = sim_take(&completing, UINT32_MAX)) != NULL) {
+        net_buf_unref(buf);
+    }
+    while ((buf = sim_take(&held, UINT32_MAX)) != NULL) {
+        net_buf_unref(buf);
+    }
+
+    *starved = (uint32_t)atomic_get(&ep.starved);
+
+    return naks;
+}
+
+static uint32_t sim_report(uint8_t depth, uint32_t hold, uint32_t *starved)
+{
+    uint32_t naks = sim_naks(depth, hold, starved);
+
+    TC_PRINT("depth %u, held %u slots: %u%% NAKed, %u%% of full speed, starved %u times\n",
+             depth, hold, naks * 100U / SIM_SLOTS, 100U - naks * 100U / SIM_SLOTS, *starved);
+
+    return naks;
+}
+
+ZTEST(usb_out_suite, test_nak_rate_by_depth)
+{
+    uint32_t starved;
+
+    /* One buffer cannot take back-to-back packets. */
+    zassert_true(sim_report(1, 1, &starved) >= SIM_SLOTS / 2U);
+    zassert_equal(starved, 0);
+
+    zassert_equal(sim_report(DEPTH, 1, &starved), 0);
+    zassert_equal(starved, 0);
+
+    /* An application slower than the host runs the pool dry. */
+    zassert_true(sim_report(DEPTH, 4, &starved) > 0);
+    zassert_true(starved > 0);
+}
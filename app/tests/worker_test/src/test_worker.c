@@ -0,0 +1,190 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+#include "pkt_pool.h"
+#include "worker.h"
+
+#define STACK_SIZE 1024
+/* Below the test thread, which only sleeps while the workers run. */
+#define PRIO       K_PRIO_PREEMPT(5)
+/* Work is done in slices; a worker preempted mid-slice loses the rest of it. */
+#define SLICE_US   10U
+#define RUN_MS     700
+
+enum {
+    ORDER_W,
+    FIXED_CTRL_W,
+    FIXED_BULK_W,
+    EDF_CTRL_W,
+    EDF_BULK_W,
+    WORKER_COUNT,
+};
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, WORKER_COUNT, STACK_SIZE);
+static struct worker workers[WORKER_COUNT];
+
+/*
+ * Mixed workload: a control stream due within its 5 ms period and a bulk
+ * stream due within its 7 ms period, together 97% of the CPU. Any fixed
+ * priorities miss bulk deadlines; earliest deadline first misses none.
+ */
+struct stream {
+    struct worker *w;
+    struct k_timer timer;
+    uint32_t period_us;
+    uint32_t cost_us;
+    uint32_t no_buf;
+};
+
+static struct stream ctrl = { .period_us = 5000U, .cost_us = 2000U };
+static struct stream bulk = { .period_us = 7000U, .cost_us = 3600U };
+
+static uint8_t order[8];
+static size_t order_len;
+
+/* Frames carry how long they take to handle. */
+static struct net_buf *frame(uint32_t cost_us)
+{
+    struct net_buf *buf = pkt_alloc(K_NO_WAIT);
+
+    if (buf != NULL) {
+        net_buf_add_le32(buf, cost_us);
+    }
+
+    return buf;
+}
+
+static void work(void *ctx, struct net_buf *buf)
+{
+    uint32_t cost_us = sys_get_le32(buf->data);
+
+    ARG_UNUSED(ctx);
+
+    for (uint32_t done = 0; done < cost_us; done += SLICE_US) {
+        k_busy_wait(SLICE_US);
+    }
+    net_buf_unref(buf);
+}
+
+static void work_logged(void *ctx, struct net_buf *buf)
+{
+    ARG_UNUSED(ctx);
+
+    order[order_len++] = buf->data[sizeof(uint32_t)];
+    work(NULL, buf);
+}
+
+static void stream_tick(struct k_timer *timer)
+{
+    struct stream *s = CONTAINER_OF(timer, struct stream, timer);
+    struct net_buf *buf = frame(s->cost_us);
+
+    if (buf == NULL) {
+        s->no_buf++;
+        return;
+    }
+
+    worker_submit(s->w, buf, s->period_us);
+}
+
+static void run_mixed(bool edf, struct worker_stats *ctrl_stats, struct worker_stats *bulk_stats)
+{
+    size_t c = edf ? EDF_CTRL_W : FIXED_CTRL_W;
+    size_t b = edf ? EDF_BULK_W : FIXED_BULK_W;
+
+    /* Deadline monotonic: the shorter budget gets the higher priority. */
+    worker_start(&workers[c], stacks[c], STACK_SIZE, PRIO, edf, work, NULL, "ctrl");
+    worker_start(&workers[b], stacks[b], STACK_SIZE, edf ? PRIO : PRIO + 1, edf, work, NULL,
+                 "bulk");
+
+    ctrl.w = &workers[c];
+    bulk.w = &workers[b];
+    ctrl.no_buf = 0;
+    bulk.no_buf = 0;
+    k_timer_init(&ctrl.timer, stream_tick, NULL);
+    k_timer_init(&bulk.timer, stream_tick, NULL);
+    k_timer_start(&ctrl.timer, K_NO_WAIT, K_USEC(ctrl.period_us));
+    k_timer_start(&bulk.timer, K_NO_WAIT, K_USEC(bulk.period_us));
+
+    k_sleep(K_MSEC(RUN_MS));
+    k_timer_stop(&ctrl.timer);
+    k_timer_stop(&bulk.timer);
+    /* Let the last frames through. */
+    k_sleep(K_MSEC(20));
+
+    zassert_equal(ctrl.no_buf + bulk.no_buf, 0, "pool ran dry");
+    zassert_equal(pkt_pool_free_count(), CONFIG_APP_PKT_COUNT);
+
+    worker_stats(&workers[c], ctrl_stats);
+    worker_stats(&workers[b], bulk_stats);
+    k_thread_abort(&workers[c].thread);
+    k_thread_abort(&workers[b].thread);
+}
+
+ZTEST(worker_suite, test_order_and_misses)
+{
+    struct worker *w = &workers[ORDER_W];
+    struct worker_stats stats;
+    struct net_buf *buf;
+
+    worker_start(w, stacks[ORDER_W], STACK_SIZE, PRIO, true, work_logged, NULL, "order");
+
+    /* Queued before the worker gets to run: handled in the order queued. */
+    for (uint8_t i = 0; i < 3; i++) {
+        buf = frame(100U);
+        net_buf_add_u8(buf, i);
+        worker_submit(w, buf, 10000U);
+    }
+    k_sleep(K_MSEC(10));
+
+    zassert_equal(order_len, 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        zassert_equal(order[i], i);
+    }
+
+    worker_stats(w, &stats);
+    zassert_equal(stats.frames, 3);
+    zassert_equal(stats.misses, 0);
+
+    /* Takes 2 ms against a budget of 1 ms. */
+    buf = frame(2000U);
+    net_buf_add_u8(buf, 3);
+    worker_submit(w, buf, 1000U);
+    k_sleep(K_MSEC(10));
+
+    worker_stats(w, &stats);
+    zassert_equal(stats.frames, 1);
+    zassert_equal(stats.misses, 1);
+    zassert_within(stats.max_late_us, 1000U, 100U);
+
+    worker_stats(w, &stats);
+    zassert_equal(stats.frames, 0);
+    k_thread_abort(&w->thread);
+}
+
+ZTEST(worker_suite, test_mixed_workload)
+{
+    struct worker_stats fixed_ctrl;
+    struct worker_stats fixed_bulk;
+    struct worker_stats edf_ctrl;
+    struct worker_stats edf_bulk;
+
+    run_mixed(false, &fixed_ctrl, &fixed_bulk);
+    run_mixed(true, &edf_ctrl, &edf_bulk);
+
+    TC_PRINT("fixed: ctrl %u/%u bulk %u/%u missed, bulk up to %u us late\n",
+             fixed_ctrl.misses, fixed_ctrl.frames, fixed_bulk.misses, fixed_bulk.frames,
+             fixed_bulk.max_late_us);
+    TC_PRINT("edf: ctrl %u/%u bulk %u/%u missed\n", edf_ctrl.misses, edf_ctrl.frames,
+             edf_bulk.misses, edf_bulk.frames);
+
+    zassert_true(fixed_ctrl.frames >= RUN_MS * 1000U / ctrl.period_us);
+    zassert_true(edf_bulk.frames >= RUN_MS * 1000U / bulk.period_us);
+
+    /* The control stream has the CPU to itself under fixed priorities. */
+    zassert_equal(fixed_ctrl.misses, 0);
+    zassert_true(fixed_bulk.misses > 0);
+    zassert_equal(edf_ctrl.misses + edf_bulk.misses, 0);
+}
+
+ZTEST_SUITE(worker_suite, NULL, NULL, NULL, NULL, NULL);
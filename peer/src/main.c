@@ -0,0 +1,596 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/l2cap.h>
+#if defined(CONFIG_PEER_PROFILE_NUS)
+#include <zephyr/bluetooth/services/nus.h>
+#endif
+#include "caps.h"
+#include "dict.h"
+#include "frame.h"
+#include "nus.h"
+#include "pawr_node.h"
+
+LOG_MODULE_REGISTER(peer, LOG_LEVEL_INF);
+
+NET_BUF_POOL_FIXED_DEFINE(rx_pool, CONFIG_PEER_BUF_COUNT,
+                          BT_L2CAP_SDU_BUF_SIZE(CONFIG_PEER_RX_MTU),
+                          8, NULL);
+NET_BUF_POOL_FIXED_DEFINE(tx_pool, CONFIG_PEER_BUF_COUNT,
+                          BT_L2CAP_SDU_BUF_SIZE(FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD),
+                          CONFIG_BT_CONN_TX_USER_DATA_SIZE, NULL);
+
+static struct bt_l2cap_le_chan le_chan;
+static struct bt_conn *default_conn;
+static K_SEM_DEFINE(tx_slots, 0, CONFIG_PEER_TX_INFLIGHT);
+static K_SEM_DEFINE(chan_up, 0, 1);
+static atomic_t rx_bytes;
+static atomic_t tx_bytes;
+static atomic_t drops;
+static struct caps session;
+static bool negotiated;
+
+#if defined(CONFIG_PEER_ROLE_PERIPHERAL)
+static const struct bt_data ad[] = {
+    BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+    BT_DATA(BT_DATA_NAME_COMPLETE, CONFIG_BT_DEVICE_NAME,
+            sizeof(CONFIG_BT_DEVICE_NAME) - 1),
+};
+
+static const struct bt_data sd[] = {
+    BT_DATA_BYTES(BT_DATA_UUID128_ALL, NUS_SVC_UUID_VAL),
+};
+#endif
+
+static void start_link(struct k_work *work);
+static K_WORK_DEFINE(start_link_work, start_link);
+
+static void report(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(report_work, report);
+
+/* Largest SDU that still goes out as a single L2CAP PDU. */
+static uint16_t tx_sdu_len(void)
+{
+    uint16_t len = MIN(le_chan.tx.mtu, le_chan.tx.mps - 2U);
+
+    len = MIN(len, FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD);
+
+    return negotiated ? MIN(len, session.mtu) : len;
+}
+
+static struct net_buf *tx_alloc(k_timeout_t timeout)
+{
+    struct net_buf *buf = net_buf_alloc(&tx_pool, timeout);
+
+    if (buf != NULL) {
+        net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+    }
+
+    return buf;
+}
+
+static int tx_send(struct net_buf *buf)
+{
+    uint16_t len;
+    int err;
+
+    if (IS_ENABLED(CONFIG_APP_DICT) && negotiated &&
+        (session.features & CAPS_F_COMPRESSION)) {
+        buf->len = (uint16_t)dict_pack_frame(buf->data, buf->len);
+    }
+
+    len = buf->len;
+    err = bt_l2cap_chan_send(&le_chan.chan, buf);
+
+    if (err != 0) {
+        net_buf_unref(buf);
+        return err;
+    }
+
+    atomic_add(&tx_bytes, len);
+
+    return 0;
+}
+
+static void local_caps(struct caps *caps)
+{
+    caps_init(caps);
+    caps->mtu = CONFIG_PEER_RX_MTU;
+    /* Data goes over the CoC only, so EATT is not offered. */
+    caps->features = CAPS_F_L2CAP_COC;
+    if (IS_ENABLED(CONFIG_APP_DICT)) {
+        caps->features |= CAPS_F_COMPRESSION;
+        caps->dict = dict_active()->id;
+    }
+    caps->batch = CONFIG_PEER_BUF_COUNT;
+    caps->credits = CONFIG_APP_CREDITS;
+}
+
+static void send_hello(void)
+{
+    struct net_buf *buf = tx_alloc(K_NO_WAIT);
+    struct caps local;
+
+    if (buf == NULL) {
+        return;
+    }
+
+    local_caps(&local);
+    if (caps_add_hello(buf, 0, &local) != 0 ||
+        bt_l2cap_chan_send(&le_chan.chan, buf) != 0) {
+        net_buf_unref(buf);
+    }
+}
+
+/* Returns true if buf was the bridge's hello. */
+static bool recv_hello(const struct net_buf *buf)
+{
+    struct frame_hdr hdr;
+    struct caps local;
+    struct caps bridge;
+
+    if (frame_get_hdr(buf->data, buf->len, &hdr) != 0 || hdr.type != FRAME_CTRL ||
+        buf->len < FRAME_HDR_SIZE + hdr.len ||
+        caps_parse_hello(&buf->data[FRAME_HDR_SIZE], hdr.len, &bridge) != 0) {
+        return false;
+    }
+
+    local_caps(&local);
+    if (caps_select(&local, &bridge, &session) != 0) {
+        LOG_WRN("bridge protocol %08x not supported", bridge.version);
+        return true;
+    }
+
+    negotiated = true;
+    LOG_INF("session: mtu %u batch %u credits %u features 0x%x", session.mtu,
+            session.batch, session.credits, session.features);
+
+    return true;
+}
+
+static struct net_buf *chan_alloc_buf(struct bt_l2cap_chan *chan)
+{
+    ARG_UNUSED(chan);
+
+    return net_buf_alloc(&rx_pool, K_FOREVER);
+}
+
+static int chan_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+    ARG_UNUSED(chan);
+
+    if (!negotiated && recv_hello(buf)) {
+        return 0;
+    }
+
+    atomic_add(&rx_bytes, buf->len);
+
+    if (IS_ENABLED(CONFIG_PEER_MODE_ECHO)) {
+        struct net_buf *echo = tx_alloc(K_NO_WAIT);
+
+        if (echo == NULL || buf->len > net_buf_tailroom(echo)) {
+            atomic_inc(&drops);
+            if (echo != NULL) {
+                net_buf_unref(echo);
+            }
+            return 0;
+        }
+
+        net_buf_add_mem(echo, buf->data, buf->len);
+        if (tx_send(echo) != 0) {
+            atomic_inc(&drops);
+        }
+    }
+
+    return 0;
+}
+
+static void chan_sent(struct bt_l2cap_chan *chan)
+{
+    ARG_UNUSED(chan);
+
+    if (IS_ENABLED(CONFIG_PEER_MODE_SOURCE)) {
+        k_sem_give(&tx_slots);
+    }
+}
+
+static void chan_connected(struct bt_l2cap_chan *chan)
+{
+    ARG_UNUSED(chan);
+
+    LOG_INF("channel up: tx mtu %u mps %u, rx mtu %u mps %u", le_chan.tx.mtu,
+            le_chan.tx.mps, le_chan.rx.mtu, le_chan.rx.mps);
+
+    negotiated = false;
+    send_hello();
+
+    for (int i = 0; i < CONFIG_PEER_TX_INFLIGHT; i++) {
+        k_sem_give(&tx_slots);
+    }
+    k_sem_give(&chan_up);
+}
+
+static void chan_disconnected(struct bt_l2cap_chan *chan)
+{
+    ARG_UNUSED(chan);
+
+    LOG_INF("channel down");
+    k_sem_reset(&tx_slots);
+    k_sem_reset(&chan_up);
+}
+
+#if defined(CONFIG_PEER_PROFILE_NUS)
+static struct nus_packer nus_tx;
+/* Echo mode writes from the RX callback and retries from the work queue. */
+static K_MUTEX_DEFINE(nus_tx_lock);
+
+static void nus_retry(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(nus_retry_work, nus_retry);
+
+static int nus_flush(void *user, const uint8_t *data, uint16_t len)
+{
+    int err;
+
+    ARG_UNUSED(user);
+
+    err = bt_nus_send(default_conn, data, len);
+    if (err == 0) {
+        atomic_add(&tx_bytes, len);
+    }
+
+    return err;
+}
+
+/* Queue len bytes for notification, waiting for TX buffers as needed. */
+static void nus_write(const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        size_t taken = nus_packer_write(&nus_tx, data, len);
+
+        data += taken;
+        len -= taken;
+        if (len > 0) {
+            k_sleep(K_MSEC(1));
+        }
+    }
+}
+
+static void nus_notif_enabled(bool enabled, void *ctx)
+{
+    ARG_UNUSED(ctx);
+
+    if (enabled && default_conn != NULL) {
+        nus_packer_init(&nus_tx, nus_flush, NULL);
+        nus_packer_set_mtu(&nus_tx, bt_gatt_get_mtu(default_conn));
+        LOG_INF("NUS up: %u byte notifications", nus_tx.cap);
+        k_sem_give(&chan_up);
+    } else {
+        k_sem_reset(&chan_up);
+    }
+}
+
+/* Send what was left in the packer when the TX buffers ran out. */
+static void nus_retry(struct k_work *work)
+{
+    int err;
+
+    ARG_UNUSED(work);
+
+    k_mutex_lock(&nus_tx_lock, K_FOREVER);
+    err = nus_packer_flush(&nus_tx);
+    k_mutex_unlock(&nus_tx_lock);
+
+    if (err != 0 && default_conn != NULL) {
+        k_work_reschedule(&nus_retry_work, K_MSEC(1));
+    }
+}
+
+static void nus_received(struct bt_conn *conn, const void *data, uint16_t len,
+                         void *ctx)
+{
+    int err;
+
+    ARG_UNUSED(conn);
+    ARG_UNUSED(ctx);
+
+    atomic_add(&rx_bytes, len);
+
+    if (!IS_ENABLED(CONFIG_PEER_MODE_ECHO)) {
+        return;
+    }
+
+    k_mutex_lock(&nus_tx_lock, K_FOREVER);
+    if (nus_packer_write(&nus_tx, data, len) < len) {
+        atomic_inc(&drops);
+    }
+    /* The packer only sends full packets; echo the rest now too. */
+    err = nus_packer_flush(&nus_tx);
+    k_mutex_unlock(&nus_tx_lock);
+
+    if (err != 0) {
+        k_work_reschedule(&nus_retry_work, K_MSEC(1));
+    }
+}
+
+static struct bt_nus_cb nus_cb = {
+    .notif_enabled = nus_notif_enabled,
+    .received = nus_received,
+};
+#endif
+
+static const struct bt_l2cap_chan_ops chan_ops = {
+    .alloc_buf = chan_alloc_buf,
+    .recv = chan_recv,
+    .sent = chan_sent,
+    .connected = chan_connected,
+    .disconnected = chan_disconnected,
+};
+
+static void chan_setup(void)
+{
+    memset(&le_chan, 0, sizeof(le_chan));
+    le_chan.chan.ops = &chan_ops;
+    le_chan.rx.mtu = CONFIG_PEER_RX_MTU;
+}
+
+static int server_accept(struct bt_conn *conn, struct bt_l2cap_server *server,
+                         struct bt_l2cap_chan **chan)
+{
+    ARG_UNUSED(conn);
+    ARG_UNUSED(server);
+
+    if (le_chan.chan.conn != NULL) {
+        return -ENOMEM;
+    }
+
+    chan_setup();
+    *chan = &le_chan.chan;
+
+    return 0;
+}
+
+static struct bt_l2cap_server server = {
+    .psm = CONFIG_PEER_L2CAP_PSM,
+    .accept = server_accept,
+    .sec_level = BT_SECURITY_L1,
+};
+
+#if defined(CONFIG_PEER_ROLE_CENTRAL)
+static bool ad_has_target_name(struct bt_data *data, void *user_data)
+{
+    bool *found = user_data;
+
+    if (data->type == BT_DATA_NAME_COMPLETE &&
+        data->data_len == sizeof(CONFIG_PEER_TARGET_NAME) - 1 &&
+        memcmp(data->data, CONFIG_PEER_TARGET_NAME, data->data_len) == 0) {
+        *found = true;
+        return false;
+    }
+
+    return true;
+}
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+                         struct net_buf_simple *ad_buf)
+{
+    const struct bt_le_conn_param *param =
+        BT_LE_CONN_PARAM(CONFIG_PEER_CONN_INTERVAL, CONFIG_PEER_CONN_INTERVAL, 0, 400);
+    bool found = false;
+    int err;
+
+    ARG_UNUSED(rssi);
+
+    if (type != BT_GAP_ADV_TYPE_ADV_IND || default_conn != NULL) {
+        return;
+    }
+
+    bt_data_parse(ad_buf, ad_has_target_name, &found);
+    if (!found || bt_le_scan_stop() != 0) {
+        return;
+    }
+
+    err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN, param, &default_conn);
+    if (err != 0) {
+        LOG_ERR("connect failed (%d)", err);
+        k_work_submit(&start_link_work);
+    }
+}
+#endif
+
+static void start_link(struct k_work *work)
+{
+    int err;
+
+    ARG_UNUSED(work);
+
+#if defined(CONFIG_PEER_ROLE_CENTRAL)
+    err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+#elif defined(CONFIG_PEER_ROLE_PERIPHERAL)
+    err = bt_le_adv_start(BT_LE_ADV_CONN_FAST_1, ad, ARRAY_SIZE(ad), sd,
+                          IS_ENABLED(CONFIG_PEER_PROFILE_NUS) ? ARRAY_SIZE(sd) : 0);
+#else
+    err = -ENOTSUP;
+#endif
+
+    if (err != 0 && err != -EALREADY) {
+        LOG_ERR("cannot start %s (%d)",
+                IS_ENABLED(CONFIG_PEER_ROLE_CENTRAL) ? "scanning" : "advertising", err);
+    }
+}
+
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+    if (err != 0) {
+        LOG_WRN("connection failed (0x%02x)", err);
+        if (default_conn != NULL) {
+            bt_conn_unref(default_conn);
+            default_conn = NULL;
+        }
+        k_work_submit(&start_link_work);
+        return;
+    }
+
+    if (default_conn == NULL) {
+        default_conn = bt_conn_ref(conn);
+    }
+
+    /* Everything the link can do to carry more data per event. */
+    (void)bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    (void)bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+
+    if (IS_ENABLED(CONFIG_PEER_ROLE_CENTRAL)) {
+        chan_setup();
+        err = bt_l2cap_chan_connect(conn, &le_chan.chan, CONFIG_PEER_L2CAP_PSM);
+        if (err != 0) {
+            LOG_ERR("L2CAP connect failed (%d)", err);
+        }
+    } else {
+        const struct bt_le_conn_param *param =
+            BT_LE_CONN_PARAM(CONFIG_PEER_CONN_INTERVAL, CONFIG_PEER_CONN_INTERVAL, 0, 400);
+
+        (void)bt_conn_le_param_update(conn, param);
+    }
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+    ARG_UNUSED(conn);
+
+    LOG_INF("disconnected (0x%02x)", reason);
+
+    if (default_conn != NULL) {
+        bt_conn_unref(default_conn);
+        default_conn = NULL;
+    }
+}
+
+static void recycled(void)
+{
+    k_work_submit(&start_link_work);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+    .connected = connected,
+    .disconnected = disconnected,
+    .recycled = recycled,
+};
+
+static void report(struct k_work *work)
+{
+    uint32_t rx = (uint32_t)atomic_set(&rx_bytes, 0);
+    uint32_t tx = (uint32_t)atomic_set(&tx_bytes, 0);
+    uint32_t rx_kbps = rx * 8U / CONFIG_PEER_REPORT_MS;
+    uint32_t tx_kbps = tx * 8U / CONFIG_PEER_REPORT_MS;
+
+    printk("rx_kbps=%u tx_kbps=%u throughput_kbps=%u drops=%ld\n", rx_kbps,
+           tx_kbps, rx_kbps + tx_kbps, atomic_get(&drops));
+
+    k_work_reschedule(k_work_delayable_from_work(work), K_MSEC(CONFIG_PEER_REPORT_MS));
+}
+
+#if defined(CONFIG_PEER_PROFILE_NUS)
+static void nus_source_loop(void)
+{
+    static uint8_t frame[FRAME_HDR_SIZE + CONFIG_APP_FRAME_MAX_PAYLOAD];
+    struct frame_hdr hdr = {
+        .chan = 0,
+        .type = FRAME_DATA,
+        .len = CONFIG_APP_FRAME_MAX_PAYLOAD,
+    };
+    uint32_t seq = 0;
+
+    frame_put_hdr(frame, &hdr);
+
+    while (true) {
+        k_sem_take(&chan_up, K_FOREVER);
+        k_sem_give(&chan_up);
+
+        for (uint16_t i = 0; i < hdr.len; i++) {
+            frame[FRAME_HDR_SIZE + i] = (uint8_t)(seq + i);
+        }
+        seq++;
+
+        nus_write(frame, sizeof(frame));
+    }
+}
+#endif
+
+static void source_loop(void)
+{
+    uint32_t seq = 0;
+
+    while (true) {
+        struct frame_hdr hdr = { .chan = 0, .type = FRAME_DATA };
+        struct net_buf *buf;
+
+        k_sem_take(&chan_up, K_FOREVER);
+        k_sem_give(&chan_up);
+        k_sem_take(&tx_slots, K_FOREVER);
+
+        buf = tx_alloc(K_FOREVER);
+        hdr.len = tx_sdu_len() - FRAME_HDR_SIZE;
+        if (CONFIG_PEER_SOURCE_LEN > 0) {
+            hdr.len = MIN(hdr.len, CONFIG_PEER_SOURCE_LEN);
+        }
+        frame_put_hdr(net_buf_add(buf, FRAME_HDR_SIZE), &hdr);
+
+        for (uint16_t i = 0; i < hdr.len; i++) {
+            net_buf_add_u8(buf, (uint8_t)(seq + i));
+        }
+        seq++;
+
+        if (tx_send(buf) != 0) {
+            k_sem_give(&tx_slots);
+        }
+    }
+}
+
+int main(void)
+{
+    int err;
+
+    err = bt_enable(NULL);
+    if (err != 0) {
+        LOG_ERR("Bluetooth init failed (%d)", err);
+        return 0;
+    }
+
+    if (IS_ENABLED(CONFIG_PEER_ROLE_PAWR_NODE)) {
+        (void)pawr_node_start();
+        return 0;
+    }
+
+#if defined(CONFIG_PEER_PROFILE_NUS)
+    err = bt_nus_cb_register(&nus_cb, NULL);
+    if (err != 0) {
+        LOG_ERR("NUS callback register failed (%d)", err);
+        return 0;
+    }
+#endif
+
+    if (IS_ENABLED(CONFIG_PEER_ROLE_PERIPHERAL) && IS_ENABLED(CONFIG_PEER_PROFILE_L2CAP)) {
+        err = bt_l2cap_server_register(&server);
+        if (err != 0) {
+            LOG_ERR("L2CAP server register failed (%d)", err);
+            return 0;
+        }
+    }
+
+    k_work_submit(&start_link_work);
+    k_work_schedule(&report_work, K_MSEC(CONFIG_PEER_REPORT_MS));
+
+#if defined(CONFIG_PEER_PROFILE_NUS)
+    if (IS_ENABLED(CONFIG_PEER_MODE_SOURCE)) {
+        nus_source_loop();
+    }
+#else
+    if (IS_ENABLED(CONFIG_PEER_MODE_SOURCE)) {
+        source_loop();
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/byteorder.h>
+#include "pawr.h"
+#include "pawr_node.h"
+
+LOG_MODULE_REGISTER(pawr_node, LOG_LEVEL_INF);
+
+static struct bt_le_per_adv_sync *sync;
+static uint16_t node_id;
+static uint8_t subevents;
+static uint8_t subevent;
+/* UINT8_MAX until the first subevent data tells us the slot count. */
+static uint8_t slot = UINT8_MAX;
+static uint8_t misses;
+static bool responded;
+
+NET_BUF_SIMPLE_DEFINE_STATIC(rsp_buf, PAWR_NODE_HDR_SIZE + CONFIG_PEER_PAWR_SAMPLE_LEN);
+
+static void listen_subevent(void)
+{
+    struct bt_le_per_adv_sync_subevent_params params = {
+        .num_subevents = 1,
+        .subevents = &subevent,
+    };
+    int err = bt_le_per_adv_sync_subevent(sync, &params);
+
+    if (err != 0) {
+        LOG_WRN("subevent select failed (%d)", err);
+    }
+}
+
+/* Take a new random position; the old one collided or does not exist. */
+static void move(uint8_t slots)
+{
+    subevent = (uint8_t)(sys_rand32_get() % subevents);
+    slot = slots == 0 ? UINT8_MAX : (uint8_t)(sys_rand32_get() % slots);
+    misses = 0;
+    responded = false;
+    listen_subevent();
+}
+
+static void sync_recv(struct bt_le_per_adv_sync *s, const struct bt_le_per_adv_sync_recv_info *info,
+                      struct net_buf_simple *buf)
+{
+    struct bt_le_per_adv_response_params params;
+    uint8_t slots;
+    int err;
+
+    if (buf == NULL || buf->len < PAWR_SUB_HDR_SIZE || info->subevent != subevent) {
+        return;
+    }
+
+    slots = buf->data[1];
+    if (slots == 0) {
+        return;
+    }
+
+    if (slot >= slots) {
+        slot = (uint8_t)(sys_rand32_get() % slots);
+        responded = false;
+    }
+
+    if (responded) {
+        if (pawr_heard(&buf->data[PAWR_SUB_HDR_SIZE], buf->len - PAWR_SUB_HDR_SIZE, slot)) {
+            misses = 0;
+        } else if (++misses >= PAWR_MISS_LIMIT) {
+            move(slots);
+            return;
+        }
+    }
+
+    net_buf_simple_reset(&rsp_buf);
+    net_buf_simple_add_le16(&rsp_buf, node_id);
+    net_buf_simple_add_le32(&rsp_buf, k_uptime_get_32());
+    for (uint8_t i = 0; i < CONFIG_PEER_PAWR_SAMPLE_LEN; i++) {
+        net_buf_simple_add_u8(&rsp_buf, (uint8_t)(buf->data[0] + i));
+    }
+
+    params.request_event = info->periodic_event_counter;
+    params.request_subevent = info->subevent;
+    params.response_subevent = info->subevent;
+    params.response_slot = slot;
+
+    err = bt_le_per_adv_set_response_data(s, &params, &rsp_buf);
+    responded = (err == 0);
+}
+
+static void sync_synced(struct bt_le_per_adv_sync *s,
+                        struct bt_le_per_adv_sync_synced_info *info)
+{
+    ARG_UNUSED(s);
+
+    subevents = MAX(info->num_subevents, 1U);
+    LOG_INF("synced: %u subevents", subevents);
+    move(0);
+}
+
+static void sync_term(struct bt_le_per_adv_sync *s,
+                      const struct bt_le_per_adv_sync_term_info *info)
+{
+    ARG_UNUSED(s);
+
+    LOG_INF("sync lost (0x%02x)", info->reason);
+    sync = NULL;
+    (void)bt_le_scan_start(BT_LE_SCAN_PASSIVE, NULL);
+}
+
+static struct bt_le_per_adv_sync_cb sync_cb = {
+    .synced = sync_synced,
+    .term = sync_term,
+    .recv = sync_recv,
+};
+
+static bool ad_has_target_name(struct bt_data *data, void *user_data)
+{
+    bool *found = user_data;
+
+    if (data->type == BT_DATA_NAME_COMPLETE &&
+        data->data_len == sizeof(CONFIG_PEER_TARGET_NAME) - 1 &&
+        memcmp(data->data, CONFIG_PEER_TARGET_NAME, data->data_len) == 0) {
+        *found = true;
+        return false;
+    }
+
+    return true;
+}
+
+static void scan_recv(const struct bt_le_scan_recv_info *info, struct net_buf_simple *buf)
+{
+    struct bt_le_per_adv_sync_param param = { 0 };
+    bool found = false;
+    int err;
+
+    if (sync != NULL || info->interval == 0) {
+        return;
+    }
+
+    bt_data_parse(buf, ad_has_target_name, &found);
+    if (!found) {
+        return;
+    }
+
+    bt_addr_le_copy(&param.addr, info->addr);
+    param.sid = info->sid;
+    /* Five missed intervals, in units of 10 ms. */
+    param.timeout = MIN(info->interval * 5U * 5U / 4U / 10U + 10U, 0x4000);
+
+    if (bt_le_scan_stop() != 0) {
+        return;
+    }
+
+    err = bt_le_per_adv_sync_create(&param, &sync);
+    if (err != 0) {
+        LOG_ERR("sync create failed (%d)", err);
+        sync = NULL;
+        (void)bt_le_scan_start(BT_LE_SCAN_PASSIVE, NULL);
+    }
+}
+
+static struct bt_le_scan_cb scan_cb = {
+    .recv = scan_recv,
+};
+
+int pawr_node_start(void)
+{
+    bt_addr_le_t addr;
+    size_t count = 1;
+
+    /* Only used to tell nodes apart in the host's records. */
+    bt_id_get(&addr, &count);
+    node_id = sys_get_le16(addr.a.val);
+
+    bt_le_scan_cb_register(&scan_cb);
+    bt_le_per_adv_sync_cb_register(&sync_cb);
+
+    return bt_le_scan_start(BT_LE_SCAN_PASSIVE, NULL);
+}
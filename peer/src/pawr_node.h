@@ -0,0 +1,7 @@
+#ifndef PAWR_NODE_H
+#define PAWR_NODE_H
+
+/* Find the bridge's PAwR train, sync to it and answer every interval. */
+int pawr_node_start(void);
+
+#endif /* PAWR_NODE_H */
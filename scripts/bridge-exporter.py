@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Serve the bridge counters to Prometheus in the OpenMetrics text format.
+
+A background thread asks the dongle for a stats snapshot once per
+--interval: one FRAME_CTRL request on the stats channel answered by one
+STATS_REC_SNAPSHOT data frame that carries every counter and histogram, so
+polling costs two small USB transfers regardless of how many metrics there
+are. /metrics renders the most recent snapshot and never touches USB, so
+scrapes do not add work on the device.
+
+Needs pyusb (pip install pyusb) and access to the vendor interface.
+"""
+
+import argparse
+import http.server
+import struct
+import sys
+import threading
+import time
+
+FRAME_SYNC = 0xA5
+FRAME_HDR_SIZE = 5
+FRAME_DATA = 0
+FRAME_CTRL = 2
+STATS_REC_SNAPSHOT = 2
+STATS_OP_SNAPSHOT = 1
+
+# Same order as enum stats_counter in app/include/stats.h.
+COUNTERS = [
+    ("usb_rx_bytes", "counter", "Bytes received on the USB OUT endpoint"),
+    ("usb_rx_transfers", "counter", "Completed USB OUT transfers"),
+    ("usb_rx_starved", "counter", "USB OUT re-arms that found no free buffer"),
+    ("usb_tx_bytes", "counter", "Bytes queued on the USB IN endpoint"),
+    ("frames_rx", "counter", "Frames decoded from the host"),
+    ("rx_dropped_bytes", "counter", "Host bytes skipped while resynchronising"),
+    ("pool_free", "gauge", "Free buffers in the packet pool"),
+    ("pressure_level", "gauge", "Buffer pressure level, 0 is normal"),
+    ("deadline_misses", "counter", "Frames a bridge worker handled past their deadline"),
+    ("pawr_responses", "counter", "PAwR responses relayed to the host"),
+]
+
+# Same order as enum stats_hist.
+HISTOGRAMS = [
+    ("rx_hold_seconds", "Time from USB OUT completion to buffer release"),
+    ("pawr_batch_age_seconds", "Time from a PAwR response until its batch is sent"),
+]
+
+PREFIX = "bridge_"
+
+
+def frame(chan, ftype, payload):
+    return struct.pack("<BBBH", FRAME_SYNC, chan, ftype, len(payload)) + payload
+
+
+def parse_frames(data):
+    """Yield (chan, type, payload) for every complete frame in data."""
+    pos = 0
+    while pos + FRAME_HDR_SIZE <= len(data):
+        if data[pos] != FRAME_SYNC:
+            pos += 1
+            continue
+        _, chan, ftype, length = struct.unpack_from("<BBBH", data, pos)
+        end = pos + FRAME_HDR_SIZE + length
+        if end > len(data):
+            break
+        yield chan, ftype, data[pos + FRAME_HDR_SIZE:end]
+        pos = end
+
+
+def parse_snapshot(body):
+    """Decode a STATS_REC_SNAPSHOT body (without the record type byte)."""
+    uptime_ms, ncounters = struct.unpack_from("<IB", body, 0)
+    pos = 5
+    counters = list(struct.unpack_from("<%dI" % ncounters, body, pos))
+    pos += 4 * ncounters
+    nhists = body[pos]
+    pos += 1
+    hists = []
+    for _ in range(nhists):
+        nbuckets = body[pos]
+        pos += 1
+        buckets = list(struct.unpack_from("<%dI" % nbuckets, body, pos))
+        pos += 4 * nbuckets
+        (sum_us,) = struct.unpack_from("<Q", body, pos)
+        pos += 8
+        hists.append((buckets, sum_us))
+    return {"uptime_ms": uptime_ms, "counters": counters, "hists": hists}
+
+
+def render(snap):
+    """Render a snapshot as OpenMetrics text."""
+    out = []
+    if snap is None:
+        out.append("# TYPE %sup gauge" % PREFIX)
+        out.append("%sup 0" % PREFIX)
+        out.append("# EOF")
+        return "\n".join(out) + "\n"
+
+    out.append("# TYPE %sup gauge" % PREFIX)
+    out.append("%sup 1" % PREFIX)
+    out.append("# TYPE %suptime_seconds gauge" % PREFIX)
+    out.append("%suptime_seconds %.3f" % (PREFIX, snap["uptime_ms"] / 1000))
+
+    for (name, kind, help_text), value in zip(COUNTERS, snap["counters"]):
+        out.append("# TYPE %s%s %s" % (PREFIX, name, kind))
+        out.append("# HELP %s%s %s." % (PREFIX, name, help_text))
+        suffix = "_total" if kind == "counter" else ""
+        out.append("%s%s%s %d" % (PREFIX, name, suffix, value))
+
+    for (name, help_text), (buckets, sum_us) in zip(HISTOGRAMS, snap["hists"]):
+        metric = PREFIX + name
+        out.append("# TYPE %s histogram" % metric)
+        out.append("# HELP %s %s." % (metric, help_text))
+        total = 0
+        for i, count in enumerate(buckets):
+            total += count
+            # Bucket i holds values below 2^i us; the last one is open.
+            le = "+Inf" if i == len(buckets) - 1 else "%g" % ((1 << i) / 1e6)
+            out.append('%s_bucket{le="%s"} %d' % (metric, le, total))
+        out.append("%s_count %d" % (metric, total))
+        out.append("%s_sum %.6f" % (metric, sum_us / 1e6))
+
+    out.append("# EOF")
+    return "\n".join(out) + "\n"
+
+
+class UsbLink:
+    def __init__(self, vid, pid):
+        try:
+            import usb.core
+        except ImportError:
+            sys.exit("bridge-exporter: pyusb is required (pip install pyusb)")
+        self.dev = usb.core.find(idVendor=vid, idProduct=pid)
+        if self.dev is None:
+            sys.exit("bridge-exporter: no device %04x:%04x" % (vid, pid))
+        self.dev.set_configuration()
+        self.usb_core = usb.core
+
+    def request(self, chan, timeout_ms):
+        self.dev.write(0x01, frame(chan, FRAME_CTRL, bytes([STATS_OP_SNAPSHOT])),
+                       timeout_ms)
+        deadline = time.monotonic() + timeout_ms / 1000
+        data = b""
+        while time.monotonic() < deadline:
+            try:
+                data += bytes(self.dev.read(0x81, 512, timeout_ms))
+            except self.usb_core.USBTimeoutError:
+                break
+            for fchan, ftype, payload in parse_frames(data):
+                # Trace records share the channel; only the snapshot counts.
+                if (fchan == chan and ftype == FRAME_DATA and payload
+                        and payload[0] == STATS_REC_SNAPSHOT):
+                    return parse_snapshot(payload[1:])
+        return None
+
+
+class Poller(threading.Thread):
+    def __init__(self, link, args):
+        super().__init__(daemon=True)
+        self.link = link
+        self.args = args
+        self.lock = threading.Lock()
+        self.snap = None
+
+    def run(self):
+        while True:
+            snap = self.link.request(self.args.chan, self.args.timeout_ms)
+            with self.lock:
+                self.snap = snap
+            time.sleep(self.args.interval)
+
+    def latest(self):
+        with self.lock:
+            return self.snap
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--listen", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=9464)
+    parser.add_argument("--interval", type=float, default=1.0,
+                        help="seconds between snapshot requests")
+    parser.add_argument("--timeout-ms", type=int, default=200)
+    parser.add_argument("--vid", type=lambda v: int(v, 0), default=0x2FE3)
+    parser.add_argument("--pid", type=lambda v: int(v, 0), default=0x0100)
+    parser.add_argument("--chan", type=int, default=255,
+                        help="CONFIG_APP_STATS_CHAN of the firmware")
+    args = parser.parse_args()
+
+    poller = Poller(UsbLink(args.vid, args.pid), args)
+    poller.start()
+
+    class Handler(http.server.BaseHTTPRequestHandler):
+        def do_GET(self):
+            if self.path != "/metrics":
+                self.send_error(404)
+                return
+            body = render(poller.latest()).encode()
+            self.send_response(200)
+            self.send_header("Content-Type",
+                             "application/openmetrics-text; version=1.0.0; charset=utf-8")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def log_message(self, fmt, *fargs):
+            pass
+
+    http.server.ThreadingHTTPServer((args.listen, args.port), Handler).serve_forever()
+
+
+if __name__ == "__main__":
+    main()
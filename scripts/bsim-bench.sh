@@ -0,0 +1,30 @@
+#!/bin/bash
+# Benchmark command for scripts/bt-tune.py. Runs the BabbleSim scale
+# scenario once with the bridge built with the given overlay and prints the
+# bridge's total goodput as "throughput_kbps=<value>". The dongle build of
+# the same scenario goes to <build_dir>, which bt-tune.py reads RAM from.
+# Needs the BabbleSim setup of app/tests/bsim/scale/run.sh. Run from the
+# workspace root.
+#
+#   scripts/bsim-bench.sh <build_dir> <overlay> <peers>
+
+set -euo pipefail
+
+if [ $# -ne 3 ]; then
+  echo "usage: $0 <build_dir> <overlay> <peers>" >&2
+  exit 2
+fi
+
+# Shorter than the scale sweep; bt-tune.py runs this once per combination.
+SIM_SECONDS=${SIM_SECONDS:-10}
+
+result=$(DONGLE_BUILD="$1" OVERLAY="$2" PEERS="$3" SIM_SECONDS="${SIM_SECONDS}" \
+         app/tests/bsim/scale/run.sh | grep '^profile=' | tail -n 1)
+echo "${result}" >&2
+
+kbps=$(echo "${result}" | sed -n 's/.* total_kbps=\([0-9]*\).*/\1/p')
+if [ -z "${kbps}" ]; then
+  echo "no summary from the bridge" >&2
+  exit 1
+fi
+echo "throughput_kbps=${kbps}"
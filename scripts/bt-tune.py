@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Sweep Bluetooth buffer settings and emit the most RAM-efficient overlay.
+
+Every combination of the swept options is written to an overlay .conf and
+handed to a benchmark command. The command must build with that overlay,
+run the workload and print a line "throughput_kbps=<value>". RAM use is read
+from {build_dir}/zephyr/zephyr.elf, so the command must leave an ARM build
+there. The configuration with the best throughput per KB of RAM that still
+meets --target-kbps is written to --output.
+
+scripts/bsim-bench.sh runs the BabbleSim scale scenario and builds the
+dongle image into {build_dir}. From the workspace root:
+
+  scripts/bt-tune.py --peers 4 --target-kbps 600 \\
+    --bench 'scripts/bsim-bench.sh {build_dir} {overlay} {peers}'
+"""
+
+import argparse
+import itertools
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+SWEEP = {
+    "CONFIG_BT_BUF_ACL_TX_COUNT": "3,6,10,16",
+    "CONFIG_BT_L2CAP_TX_BUF_COUNT": "3,6,10,16",
+    "CONFIG_BT_CTLR_DATA_LENGTH_MAX": "27,127,251",
+    "CONFIG_BT_L2CAP_TX_MTU": "65,247,498",
+}
+
+THROUGHPUT_RE = re.compile(r"throughput_kbps=([0-9.]+)")
+
+
+def ram_bytes(elf, size_tool):
+    out = subprocess.run([size_tool, elf], check=True, capture_output=True,
+                         text=True).stdout.splitlines()
+    _, data, bss = (int(v) for v in out[1].split()[:3])
+    return data + bss
+
+
+def run_bench(cmd, build_dir, overlay, peers):
+    cmd = cmd.format(build_dir=build_dir, overlay=overlay, peers=peers)
+    res = subprocess.run(cmd, shell=True, capture_output=True, text=True)
+    if res.returncode != 0:
+        return None
+    match = THROUGHPUT_RE.findall(res.stdout)
+    return float(match[-1]) if match else None
+
+
+def write_overlay(path, config, header=()):
+    with open(path, "w") as f:
+        for line in header:
+            f.write(f"# {line}\n")
+        for key, value in config.items():
+            f.write(f"{key}={value}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bench", required=True,
+                        help="benchmark command, may use {build_dir}, {overlay} and {peers}")
+    parser.add_argument("--peers", type=int, default=1)
+    parser.add_argument("--target-kbps", type=float, default=0.0,
+                        help="ignore configurations below this throughput")
+    parser.add_argument("--output", default="app/overlays/bt-tuned.conf")
+    parser.add_argument("--size", default=os.environ.get("SIZE", "arm-zephyr-eabi-size"))
+    for key, default in SWEEP.items():
+        parser.add_argument("--" + key[len("CONFIG_"):].lower().replace("_", "-"),
+                            dest=key, default=default,
+                            help=f"values to sweep (default {default})")
+    args = parser.parse_args()
+
+    keys = list(SWEEP)
+    grid = [[int(v) for v in getattr(args, key).split(",")] for key in keys]
+    best = None
+
+    with tempfile.TemporaryDirectory() as tmp:
+        for values in itertools.product(*grid):
+            config = dict(zip(keys, values))
+            config["CONFIG_BT_MAX_CONN"] = args.peers
+            # One ACL buffer per controller PDU avoids extra fragmentation
+            config["CONFIG_BT_BUF_ACL_TX_SIZE"] = config["CONFIG_BT_CTLR_DATA_LENGTH_MAX"]
+
+            overlay = os.path.join(tmp, "tune.conf")
+            build_dir = os.path.join(tmp, "build")
+            write_overlay(overlay, config)
+
+            kbps = run_bench(args.bench, build_dir, overlay, args.peers)
+            if kbps is None:
+                print(f"{values}: benchmark failed", file=sys.stderr)
+                continue
+
+            ram_kb = ram_bytes(os.path.join(build_dir, "zephyr", "zephyr.elf"),
+                               args.size) / 1024
+            score = kbps / ram_kb
+            print(f"{values}: {kbps:.1f} kbps, {ram_kb:.1f} KB RAM, {score:.2f} kbps/KB")
+
+            if kbps >= args.target_kbps and (best is None or score > best[0]):
+                best = (score, kbps, ram_kb, config)
+
+    if best is None:
+        print("no configuration met the target", file=sys.stderr)
+        return 1
+
+    score, kbps, ram_kb, config = best
+    write_overlay(args.output, config, header=(
+        f"Generated by scripts/bt-tune.py for {args.peers} peer(s), "
+        f"target {args.target_kbps:g} kbps",
+        f"Measured {kbps:.1f} kbps with {ram_kb:.1f} KB RAM ({score:.2f} kbps/KB)",
+    ))
+    print(f"wrote {args.output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
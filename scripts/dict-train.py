@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""Train the shared compression dictionary from captured frame streams.
+
+A trace is the raw byte stream of one link as the bridge frames it
+(sync | chan | type | len | payload, see app/include/frame.h), for example
+the USB IN payloads from a usbmon capture concatenated in order. Every
+FRAME_DATA and FRAME_CTRL payload up to --max-len bytes is a training
+message; larger ones are not compressed on the link anyway.
+
+The dictionary is filled greedily with the substrings that would save the
+most bytes across the messages: one that appears in k messages and is L
+bytes long saves about k * (L - 3), 3 being the size of a match token.
+The result is written as a C file holding the dictionary and the hash
+chains app/src/dict.c searches, all const so they stay in flash:
+
+  scripts/dict-train.py train captures/*.bin -o app/src/dict_data.c
+
+--table also writes the same dictionary as a flash table, so a device
+can pick up a retrained one with scripts/ftab-build.py instead of a new
+firmware image.
+
+Until real captures exist, "synth" writes a stream shaped like our control
+and telemetry traffic (hellos, stats requests, PAwR records, sensor
+records and peer log lines):
+
+  scripts/dict-train.py synth --seed 1 --count 4000 -o train.bin
+"""
+
+import argparse
+import collections
+import json
+import random
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+FRAME_HDR_SIZE = 5
+FRAME_DATA = 0
+FRAME_CTRL = 2
+
+DICT_HASH_SIZE = 256
+MATCH_MIN = 4
+CAND_MAX = 32
+OVERLAP = 8
+
+
+def dict_hash(data, pos):
+    """Same hash as dict_hash() in app/include/dict.h."""
+    return ((data[pos] << 5) ^ (data[pos + 1] << 3) ^ data[pos + 2]) & 0xFF
+
+
+def frame(chan, ftype, payload):
+    return struct.pack("<BBBH", FRAME_SYNC, chan, ftype, len(payload)) + payload
+
+
+def parse_frames(data):
+    """Yield (chan, type, payload) for every complete frame in data."""
+    pos = 0
+    while pos + FRAME_HDR_SIZE <= len(data):
+        if data[pos] != FRAME_SYNC:
+            pos += 1
+            continue
+        _, chan, ftype, length = struct.unpack_from("<BBBH", data, pos)
+        end = pos + FRAME_HDR_SIZE + length
+        if end > len(data):
+            break
+        yield chan, ftype, data[pos + FRAME_HDR_SIZE:end]
+        pos = end
+
+
+def messages(paths, max_len):
+    out = []
+    for path in paths:
+        with open(path, "rb") as f:
+            for _, ftype, payload in parse_frames(f.read()):
+                if ftype in (FRAME_DATA, FRAME_CTRL) and 0 < len(payload) <= max_len:
+                    out.append(payload)
+    return out
+
+
+def train(msgs, size):
+    # Count each substring once per message it appears in.
+    counts = collections.Counter()
+    for msg in msgs:
+        seen = set()
+        for start in range(len(msg) - MATCH_MIN + 1):
+            for length in range(MATCH_MIN, min(CAND_MAX, len(msg) - start) + 1):
+                seen.add(msg[start:start + length])
+        counts.update(seen)
+
+    cands = sorted(((k * (len(s) - 3), s) for s, k in counts.items() if k > 1),
+                   key=lambda c: (-c[0], c[1]))
+
+    picked = []
+    total = 0
+    text = b""
+    for _, s in cands:
+        if total + len(s) > size:
+            continue
+        # Anything sharing OVERLAP bytes with the dictionary is mostly there.
+        if s in text or any(s[i:i + OVERLAP] in text for i in range(len(s) - OVERLAP + 1)):
+            continue
+        picked.append(s)
+        total += len(s)
+        text = b"\x00".join(picked)
+        if total >= size - MATCH_MIN:
+            break
+
+    # Most valuable last, nearest to the message.
+    return b"".join(reversed(picked))
+
+
+def chains(data):
+    head = [0] * DICT_HASH_SIZE
+    chain = [0] * len(data)
+    for pos in range(len(data) - 2):
+        h = dict_hash(data, pos)
+        chain[pos] = head[h]
+        head[h] = pos + 1
+    return head, chain
+
+
+def dict_id(data):
+    """FNV-1a folded to 16 bits; never 0, which means no dictionary."""
+    h = 0x811C9DC5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    h = (h >> 16) ^ (h & 0xFFFF)
+    return h or 1
+
+
+def c_array(values, fmt, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt % v for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def write_c(path, data, cmdline, nmsgs):
+    head, chain = chains(data)
+    with open(path, "w") as f:
+        f.write("/*\n * Generated by scripts/dict-train.py from %d messages; do not edit.\n"
+                " *\n *   %s\n */\n" % (nmsgs, cmdline))
+        f.write('#include "dict.h"\n\n')
+        f.write("static const uint8_t data[%d] = {\n%s\n};\n\n"
+                % (len(data), c_array(list(data), "0x%02x", 12)))
+        f.write("static const uint16_t head[DICT_HASH_SIZE] = {\n%s\n};\n\n"
+                % c_array(head, "%d", 12))
+        f.write("static const uint16_t chain[%d] = {\n%s\n};\n\n"
+                % (len(data), c_array(chain, "%d", 12)))
+        f.write("const struct dict dict_builtin = {\n"
+                "    .id = 0x%04x,\n    .size = %dU,\n"
+                "    .data = data,\n    .head = head,\n    .chain = chain,\n};\n"
+                % (dict_id(data), len(data)))
+
+
+def table(data):
+    """The FTAB_DICT flash table dict_from_table() reads in place."""
+    head, chain = chains(data)
+    pad = b"\x00" * (len(data) & 1)
+    return (struct.pack("<HH", dict_id(data), len(data)) + data + pad +
+            struct.pack("<%dH" % (DICT_HASH_SIZE + len(data)), *(head + chain)))
+
+
+def synth_messages(rng, count):
+    """Messages shaped like the bridge's control and telemetry traffic."""
+    nodes = [(rng.randrange(0x10000), "node-%02d" % i) for i in range(24)]
+    temps = {node: rng.uniform(15, 30) for node, _ in nodes}
+    seq = collections.Counter()
+    uptime = rng.randrange(10**6)
+    out = []
+
+    for _ in range(count):
+        uptime += rng.randrange(20, 400)
+        node, name = rng.choice(nodes)
+        temps[node] += rng.uniform(-0.2, 0.2)
+        seq[node] += 1
+        kind = rng.random()
+
+        if kind < 0.30:
+            # Binary sensor record: id | seq | uptime | temp | humidity | mV | flags
+            payload = struct.pack("<HHIhHHB", node, seq[node] & 0xFFFF, uptime,
+                                  int(temps[node] * 100), rng.randrange(3000, 6000),
+                                  rng.randrange(2900, 3300), rng.choice((0, 0, 0, 1, 4)))
+            out.append(frame(1, FRAME_DATA, payload))
+        elif kind < 0.55:
+            doc = {"id": name, "seq": seq[node], "t": round(temps[node], 2),
+                   "h": round(rng.uniform(30, 60), 1), "bat": rng.randrange(2900, 3300),
+                   "rssi": -rng.randrange(40, 95)}
+            out.append(frame(2, FRAME_DATA, json.dumps(doc, separators=(",", ":")).encode()))
+        elif kind < 0.70:
+            line = rng.choice((
+                "<inf> peer: session: mtu %d batch %d credits %d features 0x%x" % (
+                    rng.choice((247, 498, 2000)), rng.choice((4, 8)), rng.choice((4, 8, 16)),
+                    rng.choice((1, 3, 5, 7))),
+                "<inf> peer: channel up: tx mtu %d mps %d, rx mtu %d mps %d" % (
+                    rng.choice((247, 2000)), rng.choice((247, 251)), 2000, 247),
+                "<wrn> pawr_node: subevent select failed (%d)" % -rng.choice((5, 12, 16)),
+                "<inf> pawr_node: synced: %d subevents" % rng.choice((4, 8, 16)),
+                "rx_kbps=%d tx_kbps=%d throughput_kbps=%d drops=%d" % (
+                    rng.randrange(0, 900), rng.randrange(0, 900), rng.randrange(0, 1800),
+                    rng.randrange(0, 3)),
+            ))
+            out.append(frame(3, FRAME_DATA, line.encode()))
+        elif kind < 0.80:
+            # CAPS_OP_HELLO with the TLVs of app/include/caps.h.
+            hello = bytes([0x40]) + b"".join((
+                bytes([1, 4]) + struct.pack("<I", rng.choice((0x01000000, 0x01010000))),
+                bytes([2, 2]) + struct.pack("<H", rng.choice((23, 247, 249, 2000))),
+                bytes([3, 4]) + struct.pack("<I", rng.choice((1, 3, 5, 7))),
+                bytes([4, 2]) + struct.pack("<H", rng.choice((4, 8, 16))),
+                bytes([5, 1, rng.choice((4, 8, 16))]),
+                bytes([6, 2]) + struct.pack("<H", 0),
+            ))
+            out.append(frame(0, FRAME_CTRL, hello))
+        elif kind < 0.88:
+            out.append(frame(255, FRAME_CTRL, bytes([1])))
+        else:
+            # STATS_REC_PAWR: count | (pos u16 | rssi | len | id u16 | uptime u32 | sample)
+            recs = []
+            for _ in range(rng.randrange(1, 4)):
+                rsp = struct.pack("<HI", node, uptime) + bytes(
+                    (seq[node] + i) & 0xFF for i in range(8))
+                recs.append(struct.pack("<HbB", rng.randrange(256), -rng.randrange(40, 95),
+                                        len(rsp)) + rsp)
+            out.append(frame(255, FRAME_DATA, bytes([3, len(recs)]) + b"".join(recs)))
+
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p = sub.add_parser("train", help="build the dictionary from traces")
+    p.add_argument("traces", nargs="+")
+    p.add_argument("-o", "--output", default="app/src/dict_data.c")
+    p.add_argument("--table", help="also write the dictionary as a flash table")
+    p.add_argument("--size", type=int, default=1024, help="dictionary bytes")
+    p.add_argument("--max-len", type=int, default=128,
+                   help="CONFIG_APP_DICT_MAX_LEN of the firmware")
+
+    p = sub.add_parser("synth", help="write a synthetic trace")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--seed", type=int, default=1)
+    p.add_argument("--count", type=int, default=4000)
+
+    args = parser.parse_args()
+
+    if args.cmd == "synth":
+        with open(args.output, "wb") as f:
+            f.write(b"".join(synth_messages(random.Random(args.seed), args.count)))
+        return
+
+    if not 0 < args.size < 0x8000:
+        sys.exit("dict-train: --size must be below 32768")
+
+    msgs = messages(args.traces, args.max_len)
+    if not msgs:
+        sys.exit("dict-train: no messages of at most %d bytes in the traces" % args.max_len)
+
+    data = train(msgs, args.size)
+    write_c(args.output, data, " ".join(["scripts/dict-train.py"] + sys.argv[1:]), len(msgs))
+    if args.table:
+        with open(args.table, "wb") as f:
+            f.write(table(data))
+    print("%d messages, %d byte dictionary, id 0x%04x" % (len(msgs), len(data), dict_id(data)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,30 @@
+#!/bin/bash
+# Compare the default and minimal (overlays/minimal.conf) builds and show
+# how many extra packet buffers the freed RAM would pay for.
+
+set -euo pipefail
+
+BOARD=${BOARD:-nrf52840dongle}
+SIZE=${SIZE:-arm-zephyr-eabi-size}
+
+west build -p -b "$BOARD" -d build/footprint-default app
+west build -p -b "$BOARD" -d build/footprint-minimal app -- \
+  -DEXTRA_CONF_FILE=overlays/minimal.conf
+
+# Prints "<rom> <ram>" in bytes for a build directory
+usage() {
+  "$SIZE" "$1/zephyr/zephyr.elf" | awk 'NR == 2 { print $1 + $2, $2 + $3 }'
+}
+
+read -r rom_def ram_def < <(usage build/footprint-default)
+read -r rom_min ram_min < <(usage build/footprint-minimal)
+
+pkt_size=$(sed -n 's/^CONFIG_APP_PKT_SIZE=//p' build/footprint-minimal/zephyr/.config)
+# Data plus a rough net_buf header per buffer
+pkt_cost=$((pkt_size + 32))
+
+printf '%-8s %10s %10s\n' "" "ROM" "RAM"
+printf '%-8s %10d %10d\n' "default" "$rom_def" "$ram_def"
+printf '%-8s %10d %10d\n' "minimal" "$rom_min" "$ram_min"
+printf '%-8s %10d %10d\n' "freed" "$((rom_def - rom_min))" "$((ram_def - ram_min))"
+echo "Freed RAM fits $(((ram_def - ram_min) / pkt_cost)) more ${pkt_size} byte packet buffers"
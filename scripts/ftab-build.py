@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""Build a flash table image and write it to the bridge.
+
+The image holds the tables the firmware reads in place from flash with
+CONFIG_APP_FTAB (layout in app/include/ftab.h): aggregation rules, the
+peers the central connects to and a compression dictionary as written by
+dict-train.py --table.
+
+  scripts/ftab-build.py build --rule 0:mean:16 --peer C1:C2:C3:C4:C5:C6/random \\
+      --dict dict.tab --seq 1 -o tables.bin
+
+"upload" takes the same tables and writes them to the slot the dongle is
+not using, over the stats channel, with the next sequence number. The
+dongle switches to them at its next boot; a transfer that does not
+complete leaves the tables in use as they are.
+
+Needs pyusb (pip install pyusb) and access to the vendor interface for
+"upload".
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+import time
+
+FRAME_SYNC = 0xA5
+FRAME_HDR_SIZE = 5
+FRAME_DATA = 0
+FRAME_CTRL = 2
+
+STATS_REC_FTAB = 4
+
+FTAB_MAGIC = 0x42415446
+FTAB_HDR_SIZE = 16
+FTAB_DIR_SIZE = 4
+FTAB_ENTRY_SIZE = 12
+FTAB_ALIGN = 4
+
+FTAB_AGG_RULES = 1
+FTAB_PEERS = 2
+FTAB_DICT = 3
+
+FTAB_OP_BEGIN = 0x50
+FTAB_OP_WRITE = 0x51
+FTAB_OP_COMMIT = 0x52
+FTAB_TAG_LEN = 1
+FTAB_TAG_OFFSET = 2
+FTAB_TAG_DATA = 3
+
+# Same order as enum agg_mode.
+AGG_MODES = ["none", "decimate", "min", "max", "mean", "min-max-mean"]
+
+
+def align(n):
+    return (n + FTAB_ALIGN - 1) & ~(FTAB_ALIGN - 1)
+
+
+def parse_rule(text):
+    """chan:mode:window, e.g. 0:mean:16."""
+    chan, mode, window = text.split(":")
+    if mode not in AGG_MODES:
+        raise argparse.ArgumentTypeError("mode must be one of %s" % ", ".join(AGG_MODES))
+    return struct.pack("<BBH", int(chan, 0), AGG_MODES.index(mode), int(window, 0))
+
+
+def parse_peer(text):
+    """AA:BB:CC:DD:EE:FF[/public|/random], most significant byte first."""
+    addr, _, kind = text.partition("/")
+    octets = bytes(int(o, 16) for o in addr.split(":"))
+    if len(octets) != 6 or kind not in ("", "public", "random"):
+        raise argparse.ArgumentTypeError("bad peer address %r" % text)
+    return struct.pack("<B6sB", 1 if kind == "random" else 0, octets[::-1], 0)
+
+
+def body(tables):
+    """Everything after the header, for (id, data) tables."""
+    out = bytearray(struct.pack("<HH", len(tables), 0))
+    pos = align(FTAB_HDR_SIZE + FTAB_DIR_SIZE + FTAB_ENTRY_SIZE * len(tables))
+    blobs = bytearray()
+    for tid, data in tables:
+        out += struct.pack("<HHII", tid, 0, pos, len(data))
+        blobs += data + b"\x00" * (align(len(data)) - len(data))
+        pos += align(len(data))
+    out += b"\x00" * (align(FTAB_HDR_SIZE + len(out)) - FTAB_HDR_SIZE - len(out))
+    return bytes(out + blobs)
+
+
+def image(seq, rest):
+    """Header and body; the crc covers magic | seq | len and the body."""
+    length = FTAB_HDR_SIZE + len(rest)
+    head = struct.pack("<III", FTAB_MAGIC, seq & 0xFFFFFFFF, length)
+    crc = binascii.crc32(rest, binascii.crc32(head))
+    return head + struct.pack("<I", crc) + rest
+
+
+def tables_from(args):
+    tables = []
+    if args.rule:
+        tables.append((FTAB_AGG_RULES, b"".join(args.rule)))
+    if args.peer:
+        tables.append((FTAB_PEERS, b"".join(args.peer)))
+    if args.dict:
+        with open(args.dict, "rb") as f:
+            tables.append((FTAB_DICT, f.read()))
+    if not tables:
+        sys.exit("ftab-build: no tables given")
+    return tables
+
+
+def frame(chan, ftype, payload):
+    return struct.pack("<BBBH", FRAME_SYNC, chan, ftype, len(payload)) + payload
+
+
+def parse_frames(data):
+    """Yield (chan, type, payload) for every complete frame in data."""
+    pos = 0
+    while pos + FRAME_HDR_SIZE <= len(data):
+        if data[pos] != FRAME_SYNC:
+            pos += 1
+            continue
+        _, chan, ftype, length = struct.unpack_from("<BBBH", data, pos)
+        end = pos + FRAME_HDR_SIZE + length
+        if end > len(data):
+            break
+        yield chan, ftype, data[pos + FRAME_HDR_SIZE:end]
+        pos = end
+
+
+def tlv(tag, value):
+    return bytes([tag, len(value)]) + value
+
+
+class UsbLink:
+    def __init__(self, vid, pid, chan, timeout_ms):
+        try:
+            import usb.core
+        except ImportError:
+            sys.exit("ftab-build: pyusb is required (pip install pyusb)")
+        self.dev = usb.core.find(idVendor=vid, idProduct=pid)
+        if self.dev is None:
+            sys.exit("ftab-build: no device %04x:%04x" % (vid, pid))
+        self.dev.set_configuration()
+        self.usb_core = usb.core
+        self.chan = chan
+        self.timeout_ms = timeout_ms
+
+    def request(self, op, payload=b""):
+        """Send one op and return (status, seq in use) from its reply."""
+        self.dev.write(0x01, frame(self.chan, FRAME_CTRL, bytes([op]) + payload),
+                       self.timeout_ms)
+        deadline = time.monotonic() + self.timeout_ms / 1000
+        data = b""
+        while time.monotonic() < deadline:
+            try:
+                data += bytes(self.dev.read(0x81, 512, self.timeout_ms))
+            except self.usb_core.USBTimeoutError:
+                break
+            for fchan, ftype, payload in parse_frames(data):
+                if (fchan == self.chan and ftype == FRAME_DATA and len(payload) >= 7
+                        and payload[0] == STATS_REC_FTAB and payload[1] == op):
+                    status, seq = struct.unpack_from("<bI", payload, 2)
+                    return status, seq
+        sys.exit("ftab-build: no reply to op 0x%02x" % op)
+
+
+def upload(link, rest, chunk):
+    length = FTAB_HDR_SIZE + len(rest)
+
+    # Erasing takes a while on the nrf52840: 85 ms a page.
+    status, seq = link.request(FTAB_OP_BEGIN, tlv(FTAB_TAG_LEN, struct.pack("<I", length)))
+    if status != 0:
+        sys.exit("ftab-build: begin failed (%d)" % status)
+
+    img = image(seq + 1, rest)
+    for off in range(0, len(img), chunk):
+        status, _ = link.request(FTAB_OP_WRITE,
+                                 tlv(FTAB_TAG_OFFSET, struct.pack("<I", off)) +
+                                 tlv(FTAB_TAG_DATA, img[off:off + chunk]))
+        if status != 0:
+            sys.exit("ftab-build: write at %d failed (%d)" % (off, status))
+
+    status, _ = link.request(FTAB_OP_COMMIT)
+    if status != 0:
+        sys.exit("ftab-build: commit failed (%d)" % status)
+    print("%d bytes written as seq %d, in use after the next boot" % (len(img), seq + 1))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    tabs = argparse.ArgumentParser(add_help=False)
+    tabs.add_argument("--rule", type=parse_rule, action="append",
+                      help="aggregation rule chan:mode:window")
+    tabs.add_argument("--peer", type=parse_peer, action="append",
+                      help="peer address to connect to")
+    tabs.add_argument("--dict", help="dictionary table from dict-train.py --table")
+
+    p = sub.add_parser("build", parents=[tabs], help="write an image file")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--seq", type=int, default=1)
+
+    p = sub.add_parser("upload", parents=[tabs], help="write the tables to the dongle")
+    p.add_argument("--timeout-ms", type=int, default=2000)
+    p.add_argument("--chunk", type=int, default=224,
+                   help="image bytes per write, a multiple of 4")
+    p.add_argument("--vid", type=lambda v: int(v, 0), default=0x2FE3)
+    p.add_argument("--pid", type=lambda v: int(v, 0), default=0x0100)
+    p.add_argument("--chan", type=int, default=255,
+                   help="CONFIG_APP_STATS_CHAN of the firmware")
+
+    args = parser.parse_args()
+    rest = body(tables_from(args))
+
+    if args.cmd == "build":
+        with open(args.output, "wb") as f:
+            f.write(image(args.seq, rest))
+        return
+
+    if args.chunk % FTAB_ALIGN != 0 or not 0 < args.chunk <= 232:
+        sys.exit("ftab-build: --chunk must be a multiple of 4 up to 232")
+    upload(UsbLink(args.vid, args.pid, args.chan, args.timeout_ms), rest, args.chunk)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+export PATH=/usr/lib/llvm-20/bin:$PATH
+
+west build -p -b native_sim -d build/ci-native-fuzz app/tests/fuzz_decoders -- \
+  -DZEPHYR_TOOLCHAIN_VARIANT=llvm \
+  -DEXTRA_CONF_FILE=../../overlays/sanitizers.conf
+
+mkdir -p build/fuzz-corpus
+./build/ci-native-fuzz/zephyr/zephyr.exe build/fuzz-corpus -max_total_time=${FUZZ_SECONDS:-60}
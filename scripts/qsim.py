@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""Discrete-event model of the bridge pipeline for buffer and credit sizing.
+
+The model mirrors the queues and schedulers on the dongle:
+
+  host queue -> USB OUT (armed buffers) -> frame processing -> BLE TX
+                                                               (credits,
+                                                                conn events)
+
+Every frame holds one buffer from the shared packet pool from the moment
+the USB OUT endpoint is armed with it until it is sent over BLE. The USB
+endpoint keeps up to --usb-depth buffers armed; when the pool is empty the
+host is NAKed and frames wait in the host queue, which drops once it holds
+--host-queue frames. BLE TX sends up to --pkts-per-event frames every
+connection interval while credits last; the peer returns credits in
+batches of half the window after --peer-us.
+
+The trace is a CSV of "time_us,bytes" rows (a header row is allowed).
+--compare takes the output of a native_sim benchmark run (lines like
+"loss_pct=0.5" or "latency_p99_us=1800", as app/tests/flood_test prints)
+and reports the model error for every metric found in both.
+"""
+
+import argparse
+import collections
+import csv
+import heapq
+import math
+import re
+import sys
+
+FRAME_HDR_SIZE = 5
+
+
+class Sim:
+    def __init__(self, args):
+        self.args = args
+        self.events = []
+        self.seq = 0
+        self.pool_free = args.pool
+        self.host_q = collections.deque()
+        self.armed = 0
+        self.usb_busy_until = 0.0
+        self.proc_q = collections.deque()
+        self.proc_busy = False
+        self.tx_q = collections.deque()
+        self.credits = args.credits
+        self.pending_credits = 0
+        self.latencies = []
+        self.offered = 0
+        self.dropped = 0
+        self.max_host_q = 0
+        self.max_tx_q = 0
+        self.min_pool_free = args.pool
+
+    def at(self, t, fn, *data):
+        heapq.heappush(self.events, (t, self.seq, fn, data))
+        self.seq += 1
+
+    def run(self, trace):
+        payload = self.args.pkt_size - FRAME_HDR_SIZE
+        for t, size in trace:
+            for _ in range(max(1, math.ceil(size / payload))):
+                self.at(t, self.arrive, t, min(size, payload))
+                size -= payload
+        self.at(0.0, self.conn_event)
+        end = trace[-1][0] if trace else 0.0
+
+        while self.events:
+            t, _, fn, data = heapq.heappop(self.events)
+            # Keep running until everything offered has left the pipeline
+            if fn == self.conn_event and t > end and not self.busy():
+                break
+            fn(t, *data)
+
+    def busy(self):
+        return self.host_q or self.armed < self.usb_depth() or self.proc_q \
+            or self.proc_busy or self.tx_q
+
+    def usb_depth(self):
+        return min(self.args.usb_depth, self.args.pool)
+
+    def arrive(self, t, born, size):
+        self.offered += 1
+        if len(self.host_q) >= self.args.host_queue:
+            self.dropped += 1
+            return
+        self.host_q.append((born, size))
+        self.max_host_q = max(self.max_host_q, len(self.host_q))
+        self.arm(t)
+        self.usb_start(t)
+
+    def arm(self, t):
+        while self.armed < self.args.usb_depth and self.pool_free > 0:
+            self.pool_free -= 1
+            self.armed += 1
+        self.min_pool_free = min(self.min_pool_free, self.pool_free)
+
+    def usb_start(self, t):
+        # Transfers are serialised on the bus
+        while self.host_q and self.armed > 0:
+            born, size = self.host_q.popleft()
+            self.armed -= 1
+            start = max(t, self.usb_busy_until)
+            self.usb_busy_until = start + size * 8 / self.args.usb_mbps
+            self.at(self.usb_busy_until, self.usb_done, born)
+
+    def usb_done(self, t, born):
+        self.arm(t)
+        self.proc_q.append(born)
+        self.proc_next(t)
+        self.usb_start(t)
+
+    def proc_next(self, t):
+        if not self.proc_busy and self.proc_q:
+            self.proc_busy = True
+            self.at(t + self.args.proc_us, self.proc_done, self.proc_q.popleft())
+
+    def proc_done(self, t, born):
+        self.proc_busy = False
+        self.tx_q.append(born)
+        self.max_tx_q = max(self.max_tx_q, len(self.tx_q))
+        self.proc_next(t)
+
+    def conn_event(self, t):
+        sent = 0
+        while self.tx_q and self.credits > 0 and sent < self.args.pkts_per_event:
+            born = self.tx_q.popleft()
+            self.credits -= 1
+            sent += 1
+            self.pool_free += 1
+            self.latencies.append(t - born)
+            self.at(t + self.args.peer_us, self.peer_consumed)
+        if sent:
+            self.arm(t)
+            self.usb_start(t)
+        self.at(t + self.args.interval_us, self.conn_event)
+
+    def peer_consumed(self, t):
+        self.pending_credits += 1
+        if self.pending_credits >= max(self.args.credits // 2, 1):
+            # Credit frames ride the next connection event back
+            self.at(t + self.args.interval_us, self.credit_return, self.pending_credits)
+            self.pending_credits = 0
+
+    def credit_return(self, t, count):
+        self.credits += count
+
+    def report(self):
+        lat = sorted(self.latencies)
+
+        def pct(p):
+            return lat[min(len(lat) - 1, int(p / 100 * len(lat)))] if lat else 0.0
+
+        return {
+            "offered": self.offered,
+            "delivered": len(lat),
+            "loss_pct": 100.0 * self.dropped / self.offered if self.offered else 0.0,
+            "latency_p50_us": pct(50),
+            "latency_p99_us": pct(99),
+            "latency_max_us": lat[-1] if lat else 0.0,
+            "max_host_queue": self.max_host_q,
+            "max_tx_queue": self.max_tx_q,
+            "min_pool_free": self.min_pool_free,
+        }
+
+
+def at_least_one(value):
+    n = int(value)
+    if n < 1:
+        # With nothing to send per event or no credits the model never drains
+        raise argparse.ArgumentTypeError(f"must be at least 1, got {n}")
+    return n
+
+
+def load_trace(path):
+    trace = []
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            try:
+                trace.append((float(row[0]), int(row[1])))
+            except (ValueError, IndexError):
+                continue
+    trace.sort()
+    return trace
+
+
+def compare(report, path):
+    measured = {}
+    with open(path) as f:
+        for key, value in re.findall(r"(\w+)=([0-9.]+)", f.read()):
+            measured[key] = float(value)
+
+    for key, value in measured.items():
+        if key in report:
+            model = report[key]
+            err = (model - value) / value * 100 if value else 0.0
+            print(f"{key}: model {model:.1f} measured {value:.1f} ({err:+.1f}%)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", help="CSV of time_us,bytes")
+    parser.add_argument("--pool", type=int, default=16, help="CONFIG_APP_PKT_COUNT")
+    parser.add_argument("--pkt-size", type=int, default=256, help="CONFIG_APP_PKT_SIZE")
+    parser.add_argument("--usb-depth", type=int, default=2, help="CONFIG_APP_USB_OUT_DEPTH")
+    parser.add_argument("--usb-mbps", type=float, default=8.0,
+                        help="effective USB bulk rate in Mbit/s")
+    parser.add_argument("--host-queue", type=int, default=64,
+                        help="frames the host buffers before dropping")
+    parser.add_argument("--proc-us", type=float, default=20.0,
+                        help="per-frame processing time on the dongle")
+    parser.add_argument("--credits", type=at_least_one, default=8, help="CONFIG_APP_CREDITS")
+    parser.add_argument("--interval-us", type=float, default=7500.0,
+                        help="BLE connection interval")
+    parser.add_argument("--pkts-per-event", type=at_least_one, default=6,
+                        help="frames the link carries per connection event")
+    parser.add_argument("--peer-us", type=float, default=1000.0,
+                        help="time for the peer to consume a frame")
+    parser.add_argument("--compare", help="native_sim benchmark output to validate against")
+    args = parser.parse_args()
+
+    sim = Sim(args)
+    sim.run(load_trace(args.trace))
+    report = sim.report()
+
+    for key, value in report.items():
+        print(f"{key}={value:.1f}" if isinstance(value, float) else f"{key}={value}")
+
+    if args.compare:
+        compare(report, args.compare)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -8,6 +8,10 @@ west build -p -b native_sim -d build/ci-native-asan app -- \
 
 timeout 10 ./build/ci-native-asan/zephyr/zephyr.exe
 
+# Buffer ownership stress test with the same overlay, ASan and UBSan.
+ZEPHYR_TOOLCHAIN_VARIANT=llvm west twister -v -p native_sim -T app/tests/pkt_track_test \
+  -s app.pkt_track.sanitizers
+
 #valgrind --leak-check=full ./build/ci-native-asan/zephyr/zephyr.exe
 
 #west twister -v -p native_sim -T app/tests -- \